@@ -0,0 +1,59 @@
+############################################################
+#
+# Converts a drift field map exported from a field solver into the
+# binary format read by nexus (FieldMapDriftField).
+#
+# The input is a csv file with one row per node of a regular grid and
+# the columns
+#   x, y, z, velocity, transv_diff, longit_diff, dx, dy   (3D map)
+#   r, z,    velocity, transv_diff, longit_diff, dr, dphi (r-z map)
+# for an electron starting at the node: mean drift velocity to the
+# anode (mm/us), transverse and longitudinal diffusion (mm/sqrt(cm)) and
+# displacement of its arrival point on the anode plane (mm).
+#
+############################################################
+
+input_file  = "drift_field_map.csv"
+output_file = "drift_field_map.bin"
+
+############################################################
+
+import struct
+import pandas as pd
+import numpy  as np
+
+table = pd.read_csv(input_file)
+
+rz     = 'r' in table.columns
+coords = ['r', 'z'] if rz else ['x', 'y', 'z']
+fields = (['velocity', 'transv_diff', 'longit_diff', 'dr', 'dphi'] if rz else
+          ['velocity', 'transv_diff', 'longit_diff', 'dx', 'dy'])
+
+# Nodes ordered with the first coordinate running fastest
+table = table.sort_values(coords[::-1])
+
+n, vmin, step = [], [], []
+for c in coords:
+    values = np.unique(table[c].values)
+    n   .append(len(values))
+    vmin.append(values[0])
+    step.append(values[1] - values[0] if len(values) > 1 else 0.)
+    # The map only stores the first node and the spacing of each axis
+    if not np.allclose(np.diff(values), step[-1], rtol=1e-6, atol=0.):
+        raise ValueError("the nodes along " + c + " are not evenly spaced")
+
+if len(table) != np.prod(n):
+    raise ValueError("the nodes do not form a regular grid")
+
+while len(n) < 3:
+    n   .append(1)
+    vmin.append(0.)
+    step.append(0.)
+
+with open(output_file, "wb") as out:
+    out.write(b"NXDRIFT\0")
+    out.write(struct.pack("<II", 1, len(coords)))
+    out.write(struct.pack("<3Q", *n))
+    out.write(struct.pack("<3d", *vmin))
+    out.write(struct.pack("<3d", *step))
+    out.write(table[fields].values.astype("<f4").tobytes())
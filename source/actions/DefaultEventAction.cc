@@ -2,7 +2,8 @@
 // nexus | DefaultEventAction.cc
 //
 // This is the default event action of the NEXT simulations. Only events with
-// deposited energy larger than 0 are saved in the nexus output file.
+// deposited energy larger than 0 are saved in the nexus output file, as long
+// as they fulfill the conditions set in EventSelection.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -11,6 +12,8 @@
 #include "Trajectory.h"
 #include "PersistencyManager.h"
 #include "IonizationHit.h"
+#include "EventSelection.h"
+#include "TrackHistory.h"
 #include "FactoryBase.h"
 
 #include <G4Event.hh>
@@ -28,7 +31,8 @@ namespace nexus {
 REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
 
   DefaultEventAction::DefaultEventAction():
-    G4UserEventAction(), nevt_(0), nupdate_(10), energy_min_(0.), energy_max_(DBL_MAX)
+    G4UserEventAction(), nevt_(0), nupdate_(10), energy_min_(0.), energy_max_(DBL_MAX),
+    selection_(nullptr)
   {
     msg_ = new G4GenericMessenger(this, "/Actions/DefaultEventAction/");
 
@@ -46,6 +50,8 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
     max_energy_cmd.SetUnitCategory("Energy");
     max_energy_cmd.SetRange("max_energy>0.");
 
+    selection_ = new EventSelection();
+
     PersistencyManager* pm = dynamic_cast<PersistencyManager*>
       (G4VPersistencyManager::GetPersistencyManager());
 
@@ -56,12 +62,16 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
 
   DefaultEventAction::~DefaultEventAction()
   {
+    delete selection_;
   }
 
 
 
   void DefaultEventAction::BeginOfEventAction(const G4Event* /*event*/)
   {
+    // Tracks of the previous event, for the event selection
+    TrackHistory::Clear();
+
     // Print out event number info
     if ((nevt_ % nupdate_) == 0) {
       G4cout << " >> Event no. " << nevt_  << G4endl;
@@ -114,7 +124,8 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
       } else {
 	pm->InteractingEvent(false);
       }
-      if (!event->IsAborted() && edep > energy_min_ && edep < energy_max_) {
+      if (!event->IsAborted() && edep > energy_min_ && edep < energy_max_ &&
+          selection_->Select(event)) {
 	pm->StoreCurrentEvent(true);
       } else {
 	pm->StoreCurrentEvent(false);
@@ -2,7 +2,8 @@
 // nexus | DefaultEventAction.h
 //
 // This is the default event action of the NEXT simulations. Only events with
-// deposited energy larger than 0 are saved in the nexus output file.
+// deposited energy larger than 0 are saved in the nexus output file, as long
+// as they fulfill the conditions set in EventSelection.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -18,6 +19,8 @@ class G4GenericMessenger;
 
 namespace nexus {
 
+  class EventSelection;
+
   /// This class is a general-purpose event run action.
 
   class DefaultEventAction: public G4UserEventAction
@@ -38,6 +41,7 @@ namespace nexus {
     G4int nevt_, nupdate_;
     G4double energy_min_;
     G4double energy_max_;
+    EventSelection* selection_; ///< Further conditions to save the event
   };
 
 } // namespace nexus
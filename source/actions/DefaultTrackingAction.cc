@@ -4,7 +4,9 @@
 // This class is the default tracking action of the NEXT simulation.
 // It stores in memory the trajectories of all particles, except optical photons
 // and ionization electrons, with the relevant tracking information that will be
-// saved to the output file.
+// saved to the output file. The trajectories of secondary particles can be
+// further restricted by particle, kinetic energy, creator process, generation
+// and initial volume.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,6 +15,7 @@
 
 #include "Trajectory.h"
 #include "TrajectoryMap.h"
+#include "TrackHistory.h"
 #include "IonizationElectron.h"
 #include "FactoryBase.h"
 
@@ -21,17 +24,91 @@
 #include <G4Trajectory.hh>
 #include <G4ParticleDefinition.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4GenericMessenger.hh>
+#include <G4EventManager.hh>
+#include <G4Event.hh>
+#include <G4VProcess.hh>
+
+#include <algorithm>
 
 using namespace nexus;
 
 REGISTER_CLASS(DefaultTrackingAction, G4UserTrackingAction)
 
-DefaultTrackingAction::DefaultTrackingAction() : G4UserTrackingAction()
+DefaultTrackingAction::DefaultTrackingAction() :
+  G4UserTrackingAction(), msg_(nullptr),
+  min_kin_energy_(0.), max_generation_(-1), event_id_(-1)
 {
+  msg_ = new G4GenericMessenger(this, "/Actions/DefaultTrackingAction/",
+                                "Trajectories stored for the secondary particles.");
+
+  msg_->DeclareMethod("drop_particle", &DefaultTrackingAction::DropParticle,
+                      "Do not store the trajectories of this particle.");
+
+  msg_->DeclareMethod("drop_creator_process", &DefaultTrackingAction::DropCreatorProcess,
+                      "Do not store the trajectories of the particles "
+                      "created by this process.");
+
+  msg_->DeclareMethod("volume", &DefaultTrackingAction::AddVolume,
+                      "Store only the trajectories starting in the volumes "
+                      "added with this command.");
+
+  G4GenericMessenger::Command& energy_cmd =
+    msg_->DeclareProperty("min_kinetic_energy", min_kin_energy_,
+                          "Minimum initial kinetic energy to store a trajectory.");
+  energy_cmd.SetParameterName("min_kinetic_energy", false);
+  energy_cmd.SetUnitCategory("Energy");
+  energy_cmd.SetRange("min_kinetic_energy>=0.");
+
+  msg_->DeclareProperty("max_generation", max_generation_,
+                        "Maximum generation of a stored trajectory "
+                        "(primaries: 0, their secondaries: 1...). "
+                        "Negative for no limit.");
 }
 
 DefaultTrackingAction::~DefaultTrackingAction()
 {
+  delete msg_;
+}
+
+void DefaultTrackingAction::DropParticle(const G4String& name)
+{
+  drop_particles_.push_back(name);
+}
+
+void DefaultTrackingAction::DropCreatorProcess(const G4String& name)
+{
+  drop_processes_.push_back(name);
+}
+
+void DefaultTrackingAction::AddVolume(const G4String& name)
+{
+  volumes_.push_back(name);
+}
+
+G4bool DefaultTrackingAction::KeepTrajectory(const G4Track* track, G4int generation) const
+{
+  if (track->GetParentID() == 0) return true;
+
+  if (max_generation_ >= 0 && generation > max_generation_) return false;
+
+  if (track->GetKineticEnergy() < min_kin_energy_) return false;
+
+  if (std::find(drop_particles_.begin(), drop_particles_.end(),
+                track->GetDefinition()->GetParticleName()) != drop_particles_.end())
+    return false;
+
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if (creator && std::find(drop_processes_.begin(), drop_processes_.end(),
+                           creator->GetProcessName()) != drop_processes_.end())
+    return false;
+
+  if (!volumes_.empty() &&
+      std::find(volumes_.begin(), volumes_.end(),
+                track->GetVolume()->GetName()) == volumes_.end())
+    return false;
+
+  return true;
 }
 
 void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
@@ -44,6 +121,39 @@ void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
     return;
   }
 
+  // Generation of the track, counted from the primary particles.
+  // The trajectories of a previous event, if not cleared by
+  // the persistency manager, must not be taken as ancestors
+  G4int event_id = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  if (event_id != event_id_) {
+    event_id_ = event_id;
+    generation_.clear();
+    TrajectoryMap::Clear();
+  }
+  G4int track_id = track->GetTrackID();
+  if (!generation_.count(track_id)) {
+    auto parent = generation_.find(track->GetParentID());
+    generation_[track_id] = (parent == generation_.end()) ? 0 : parent->second + 1;
+  }
+
+  // The decision taken the first time the track is processed
+  // holds when its processing is resumed
+  G4VTrajectory* existing = TrajectoryMap::Get(track_id);
+  G4bool keep = existing ? existing->GetTrackID() == track_id
+                         : KeepTrajectory(track, generation_[track_id]);
+
+  if (!keep) {
+    // No trajectory (nor trajectory points) is created for the track,
+    // and its energy deposit is added to the trajectory of its closest
+    // stored ancestor, which exists because primaries are always stored
+    if (!existing) {
+      G4VTrajectory* ancestor = TrajectoryMap::Get(track->GetParentID());
+      if (ancestor) TrajectoryMap::Link(track_id, ancestor);
+    }
+    fpTrackingManager->SetStoreTrajectory(false);
+    return;
+  }
+
   // Create a new trajectory associated to the track.
   // N.B. If the processesing of a track is interrupted to be resumed
   // later on (to process, for instance, its secondaries) more than
@@ -58,6 +168,10 @@ void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
 
 void DefaultTrackingAction::PostUserTrackingAction(const G4Track *track)
 {
+  // All the tracks are recorded for the event selection,
+  // with or without a trajectory
+  TrackHistory::Record(track);
+
   // Do nothing if the track is an optical photon or an ionization electron
   if (track->GetDefinition() == G4OpticalPhoton::Definition() ||
       track->GetDefinition() == IonizationElectron::Definition())
@@ -65,8 +179,8 @@ void DefaultTrackingAction::PostUserTrackingAction(const G4Track *track)
 
   Trajectory *trj = (Trajectory *)TrajectoryMap::Get(track->GetTrackID());
 
-  // Do nothing if the track has no associated trajectory in the map
-  if (!trj) return;
+  // Do nothing if the track has no trajectory of its own in the map
+  if (!trj || trj->GetTrackID() != track->GetTrackID()) return;
 
   // Record final time and position of the track
   trj->SetFinalPosition(track->GetPosition());
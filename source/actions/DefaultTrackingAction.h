@@ -4,7 +4,9 @@
 // This class is the default tracking action of the NEXT simulation.
 // It stores in memory the trajectories of all particles, except optical photons
 // and ionization electrons, with the relevant tracking information that will be
-// saved to the output file.
+// saved to the output file. The trajectories of secondary particles can be
+// further restricted by particle, kinetic energy, creator process, generation
+// and initial volume.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,8 +15,13 @@
 #define DEFAULT_TRACKING_ACTION_H
 
 #include <G4UserTrackingAction.hh>
+#include <G4String.hh>
+
+#include <map>
+#include <vector>
 
 class G4Track;
+class G4GenericMessenger;
 
 
 namespace nexus {
@@ -31,6 +38,27 @@ namespace nexus {
 
     virtual void PreUserTrackingAction(const G4Track*);
     virtual void PostUserTrackingAction(const G4Track*);
+
+  private:
+    /// Returns true if the trajectory of the track must be stored.
+    /// Primary particles are always stored.
+    G4bool KeepTrajectory(const G4Track*, G4int generation) const;
+
+    void DropParticle(const G4String&);
+    void DropCreatorProcess(const G4String&);
+    void AddVolume(const G4String&);
+
+  private:
+    G4GenericMessenger* msg_;
+
+    std::vector<G4String> drop_particles_;  ///< Particles without trajectory
+    std::vector<G4String> drop_processes_;  ///< Creator processes without trajectory
+    std::vector<G4String> volumes_;         ///< Initial volumes with trajectory (all if empty)
+    G4double min_kin_energy_;  ///< Minimum initial kinetic energy
+    G4int max_generation_;     ///< Maximum generation (primaries: 0) if not negative
+
+    G4int event_id_; ///< Event of the generations in the map
+    std::map<G4int, G4int> generation_; ///< track ID --> generation
   };
 
 }
@@ -0,0 +1,311 @@
+// ----------------------------------------------------------------------------
+// nexus | EventSelection.cc
+//
+// Conditions that an event must fulfill to be saved, evaluated at the
+// end of the event and configured through /Actions/EventSelection/.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "EventSelection.h"
+
+#include "TrackHistory.h"
+#include "IonizationSD.h"
+#include "IonizationHit.h"
+#include "SensorSD.h"
+#include "SensorHit.h"
+
+#include <G4Event.hh>
+#include <G4GenericMessenger.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4SDManager.hh>
+#include <G4HCtable.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4Navigator.hh>
+#include <G4TransportationManager.hh>
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+
+
+namespace nexus {
+
+
+  EventSelection::EventSelection():
+    msg_(nullptr), volume_(""), photons_cut_(false),
+    min_photons_(0), max_photons_(INT_MAX), or_logic_(false),
+    navigator_(nullptr)
+  {
+    msg_ = new G4GenericMessenger(this, "/Actions/EventSelection/",
+                                  "Conditions to save an event.");
+
+    msg_->DeclareMethod("volume", &EventSelection::SelectVolume,
+      "Select the ionization sensitive detector (e.g. ACTIVE) "
+      "configured by the volume energy commands.");
+
+    G4GenericMessenger::Command& min_energy_cmd =
+      msg_->DeclareMethodWithUnit("min_volume_energy", "MeV",
+                                  &EventSelection::SetMinVolumeEnergy,
+                                  "Minimum energy deposited in the volume.");
+    min_energy_cmd.SetParameterName("min_volume_energy", false);
+    min_energy_cmd.SetRange("min_volume_energy>=0.");
+
+    G4GenericMessenger::Command& max_energy_cmd =
+      msg_->DeclareMethodWithUnit("max_volume_energy", "MeV",
+                                  &EventSelection::SetMaxVolumeEnergy,
+                                  "Maximum energy deposited in the volume.");
+    max_energy_cmd.SetParameterName("max_volume_energy", false);
+    max_energy_cmd.SetRange("max_volume_energy>0.");
+
+    G4GenericMessenger::Command& min_photons_cmd =
+      msg_->DeclareMethod("min_detected_photons", &EventSelection::SetMinPhotons,
+                          "Minimum number of photons detected by the sensors.");
+    min_photons_cmd.SetParameterName("min_detected_photons", false);
+    min_photons_cmd.SetRange("min_detected_photons>=0");
+
+    G4GenericMessenger::Command& max_photons_cmd =
+      msg_->DeclareMethod("max_detected_photons", &EventSelection::SetMaxPhotons,
+                          "Maximum number of photons detected by the sensors.");
+    max_photons_cmd.SetParameterName("max_detected_photons", false);
+    max_photons_cmd.SetRange("max_detected_photons>=0");
+
+    msg_->DeclareMethod("particle", &EventSelection::AddParticle,
+      "Require any of the particles added with this command in the event.");
+
+    msg_->DeclareMethod("process", &EventSelection::AddProcess,
+      "Require any of the processes added with this command "
+      "(creator or final process of a particle) in the event.");
+
+    msg_->DeclareMethod("vertex_volume", &EventSelection::AddVertexVolume,
+      "Require a primary vertex in any of the physical volumes "
+      "added with this command.");
+
+    G4GenericMessenger::Command& logic_cmd =
+      msg_->DeclareMethod("logic", &EventSelection::SetLogic,
+                          "Combination of the conditions: and, or.");
+    logic_cmd.SetCandidates("and or");
+  }
+
+
+
+  EventSelection::~EventSelection()
+  {
+    delete msg_;
+    delete navigator_;
+  }
+
+
+
+  void EventSelection::SelectVolume(const G4String& volume)
+  {
+    volume_ = volume;
+    volume_energy_.emplace(volume_, std::make_pair(0., DBL_MAX));
+  }
+
+
+
+  void EventSelection::SetMinVolumeEnergy(G4double energy)
+  {
+    if (volume_ == "") {
+      G4Exception("[EventSelection]", "SetMinVolumeEnergy()", FatalException,
+                  "No volume selected with /Actions/EventSelection/volume.");
+    }
+    volume_energy_[volume_].first = energy;
+  }
+
+
+
+  void EventSelection::SetMaxVolumeEnergy(G4double energy)
+  {
+    if (volume_ == "") {
+      G4Exception("[EventSelection]", "SetMaxVolumeEnergy()", FatalException,
+                  "No volume selected with /Actions/EventSelection/volume.");
+    }
+    volume_energy_[volume_].second = energy;
+  }
+
+
+
+  void EventSelection::SetMinPhotons(G4int nphotons)
+  {
+    photons_cut_ = true;
+    min_photons_ = nphotons;
+  }
+
+
+
+  void EventSelection::SetMaxPhotons(G4int nphotons)
+  {
+    photons_cut_ = true;
+    max_photons_ = nphotons;
+  }
+
+
+
+  void EventSelection::AddParticle(const G4String& name)
+  {
+    particles_.push_back(name);
+    TrackHistory::Enable(true);
+  }
+
+
+
+  void EventSelection::AddProcess(const G4String& name)
+  {
+    processes_.push_back(name);
+    TrackHistory::Enable(true);
+  }
+
+
+
+  void EventSelection::AddVertexVolume(const G4String& name)
+  {
+    vertex_volumes_.push_back(name);
+  }
+
+
+
+  void EventSelection::SetLogic(const G4String& logic)
+  {
+    or_logic_ = (logic == "or");
+  }
+
+
+
+  G4bool EventSelection::Select(const G4Event* event)
+  {
+    std::vector<G4bool> conditions;
+
+    if (!volume_energy_.empty()) {
+      std::map<G4String, G4double> energies = VolumeEnergies(event);
+      for (const auto& cut: volume_energy_) {
+        G4double edep = energies[cut.first];
+        conditions.push_back(edep >= cut.second.first && edep <= cut.second.second);
+      }
+    }
+
+    if (photons_cut_) {
+      G4int nphotons = DetectedPhotons(event);
+      conditions.push_back(nphotons >= min_photons_ && nphotons <= max_photons_);
+    }
+
+    if (!particles_.empty())
+      conditions.push_back(HasParticleOrProcess(true));
+
+    if (!processes_.empty())
+      conditions.push_back(HasParticleOrProcess(false));
+
+    if (!vertex_volumes_.empty())
+      conditions.push_back(VertexInVolumes(event));
+
+    if (conditions.empty()) return true;
+
+    if (or_logic_)
+      return std::any_of(conditions.begin(), conditions.end(),
+                         [](G4bool c) { return c; });
+    else
+      return std::all_of(conditions.begin(), conditions.end(),
+                         [](G4bool c) { return c; });
+  }
+
+
+
+  std::map<G4String, G4double>
+  EventSelection::VolumeEnergies(const G4Event* event) const
+  {
+    std::map<G4String, G4double> energies;
+
+    G4HCofThisEvent* hce = event->GetHCofThisEvent();
+    if (!hce) return energies;
+
+    G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+    G4HCtable* hct = sdmgr->GetHCtable();
+
+    for (G4int i=0; i<hct->entries(); i++) {
+      if (hct->GetHCname(i) != IonizationSD::GetCollectionUniqueName()) continue;
+
+      G4String sdname = hct->GetSDname(i);
+      G4int hcid = sdmgr->GetCollectionID(sdname + "/" + hct->GetHCname(i));
+      IonizationHitsCollection* hits =
+        dynamic_cast<IonizationHitsCollection*>(hce->GetHC(hcid));
+      if (!hits) continue;
+
+      for (size_t j=0; j<hits->entries(); j++)
+        energies[sdname] += (*hits)[j]->GetEnergyDeposit();
+    }
+
+    return energies;
+  }
+
+
+
+  G4int EventSelection::DetectedPhotons(const G4Event* event) const
+  {
+    G4int nphotons = 0;
+
+    G4HCofThisEvent* hce = event->GetHCofThisEvent();
+    if (!hce) return nphotons;
+
+    G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+    G4HCtable* hct = sdmgr->GetHCtable();
+
+    for (G4int i=0; i<hct->entries(); i++) {
+      if (hct->GetHCname(i) != SensorSD::GetCollectionUniqueName()) continue;
+
+      G4int hcid = sdmgr->GetCollectionID(hct->GetSDname(i) + "/" + hct->GetHCname(i));
+      SensorHitsCollection* hits =
+        dynamic_cast<SensorHitsCollection*>(hce->GetHC(hcid));
+      if (!hits) continue;
+
+      for (size_t j=0; j<hits->entries(); j++)
+        for (const auto& bin: (*hits)[j]->GetHistogram())
+          nphotons += bin.second;
+    }
+
+    return nphotons;
+  }
+
+
+
+  G4bool EventSelection::HasParticleOrProcess(G4bool particle) const
+  {
+    // The tracks of the event are those recorded by the tracking
+    // action, as not all of them have a stored trajectory
+    for (const G4String& name: particle ? particles_ : processes_) {
+      if (particle ? TrackHistory::HasParticle(name)
+                   : TrackHistory::HasProcess(name))
+        return true;
+    }
+
+    return false;
+  }
+
+
+
+  G4bool EventSelection::VertexInVolumes(const G4Event* event)
+  {
+    // A navigator of our own, so that the state of
+    // the tracking navigator is not modified
+    if (!navigator_) {
+      navigator_ = new G4Navigator();
+      navigator_->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                 ->GetNavigatorForTracking()->GetWorldVolume());
+    }
+
+    for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+      G4VPhysicalVolume* volume =
+        navigator_->LocateGlobalPointAndSetup(event->GetPrimaryVertex(i)->GetPosition(),
+                                              nullptr, false, true);
+      if (!volume) continue;
+
+      if (std::find(vertex_volumes_.begin(), vertex_volumes_.end(),
+                    volume->GetName()) != vertex_volumes_.end())
+        return true;
+    }
+
+    return false;
+  }
+
+} // end namespace nexus
@@ -0,0 +1,82 @@
+// ----------------------------------------------------------------------------
+// nexus | EventSelection.h
+//
+// Conditions that an event must fulfill to be saved, evaluated at the
+// end of the event and configured through /Actions/EventSelection/.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EVENT_SELECTION_H
+#define EVENT_SELECTION_H
+
+#include <G4String.hh>
+
+#include <map>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+class G4Navigator;
+
+
+namespace nexus {
+
+  /// Each command adds a condition on the event. The conditions are
+  /// combined with a logical AND (default) or OR. An event with no
+  /// conditions set is always selected.
+
+  class EventSelection
+  {
+  public:
+    /// Constructor
+    EventSelection();
+    /// Destructor
+    ~EventSelection();
+
+    /// Returns true if the event fulfills the conditions
+    G4bool Select(const G4Event*);
+
+  private:
+    void SelectVolume(const G4String&);
+    void SetMinVolumeEnergy(G4double);
+    void SetMaxVolumeEnergy(G4double);
+    void SetMinPhotons(G4int);
+    void SetMaxPhotons(G4int);
+    void AddParticle(const G4String&);
+    void AddProcess(const G4String&);
+    void AddVertexVolume(const G4String&);
+    void SetLogic(const G4String&);
+
+    /// Energy deposited in each ionization sensitive detector
+    std::map<G4String, G4double> VolumeEnergies(const G4Event*) const;
+    /// Photons detected by all the sensors
+    G4int DetectedPhotons(const G4Event*) const;
+    /// True if any track of the event has one of the particles
+    /// or processes
+    G4bool HasParticleOrProcess(G4bool particle) const;
+    /// True if a primary vertex is in one of the vertex volumes
+    G4bool VertexInVolumes(const G4Event*);
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4String volume_; ///< Volume configured by the energy commands
+    /// Allowed energy range in each ionization sensitive detector
+    std::map<G4String, std::pair<G4double, G4double>> volume_energy_;
+
+    G4bool photons_cut_;
+    G4int min_photons_, max_photons_;
+
+    std::vector<G4String> particles_;
+    std::vector<G4String> processes_;
+    std::vector<G4String> vertex_volumes_;
+
+    G4bool or_logic_;
+
+    G4Navigator* navigator_; ///< Locates the vertices in the geometry
+  };
+
+} // end namespace nexus
+
+#endif
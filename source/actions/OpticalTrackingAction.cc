@@ -12,6 +12,7 @@
 
 #include "Trajectory.h"
 #include "TrajectoryMap.h"
+#include "TrackHistory.h"
 #include "FactoryBase.h"
 
 #include <G4Track.hh>
@@ -55,6 +56,9 @@ void OpticalTrackingAction::PreUserTrackingAction(const G4Track* track)
 
 void OpticalTrackingAction::PostUserTrackingAction(const G4Track* track)
 {
+  // Recorded for the event selection
+  TrackHistory::Record(track);
+
   Trajectory* trj = (Trajectory*) TrajectoryMap::Get(track->GetTrackID());
 
   // Do nothing if the track has no associated trajectory in the map
@@ -15,6 +15,9 @@
 #include "DetectorConstruction.h"
 #include "PrimaryGeneration.h"
 #include "FactoryBase.h"
+#include "SensorDigitization.h"
+#include "RandomUtils.h"
+#include "DetectionPreSampling.h"
 
 #include <G4GenericPhysicsList.hh>
 #include <G4UImanager.hh>
@@ -27,6 +30,9 @@
 #include <G4UserSteppingAction.hh>
 #include <G4UserStackingAction.hh>
 
+#include <algorithm>
+#include <sstream>
+
 using namespace nexus;
 using std::make_unique;
 using std::unique_ptr;
@@ -36,7 +42,11 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
                                          geo_name_(""), pm_name_(""),
                                          runact_name_(""), evtact_name_(""),
                                          stepact_name_(""), trkact_name_(""),
-                                         stkact_name_(""), pman_(false)
+                                         stkact_name_(""), pman_(false),
+                                         run_seed_(0), clock_seed_(false),
+                                         event_seeding_(false),
+                                         event_seed_(0),
+                                         seeding_before_replay_(false)
 {
   // Create and configure a generic messenger for the app
   msg_ = make_unique<G4GenericMessenger>(this, "/nexus/", "Nexus control commands.");
@@ -55,6 +65,13 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   msg_->DeclareMethod("random_seed", &NexusApp::SetRandomSeed,
                       "Set a seed for the random number generator.");
 
+  // Define the commands to reseed the random number generator for every
+  // event, from the run seed and the event ID, and to replay events
+  msg_->DeclareProperty("event_seeding", event_seeding_,
+                        "Reseed the random number generator for every event.");
+  msg_->DeclareMethod("replay_events", &NexusApp::ReplayEvents,
+                      "IDs of the events to simulate again, in isolation.");
+
 // Define the command to set the desired generator
   msg_->DeclareProperty("RegisterGenerator", gen_name_, "");
 
@@ -71,6 +88,10 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   msg_->DeclareProperty("RegisterTrackingAction", trkact_name_, "");
   msg_->DeclareProperty("RegisterStackingAction", stkact_name_, "");
 
+  // Define the digitization commands of the sensors, which
+  // are created later on with the geometry
+  SensorDigitization::Instance();
+
 
   /////////////////////////////////////////////////////////
 
@@ -205,6 +226,62 @@ void NexusApp::Initialize()
 
 
 
+void NexusApp::BeamOn(G4int n_event, const char* macroFile, G4int n_select)
+{
+  // When replaying events, the run has exactly the events in the list.
+  // A run of no events (e.g. to initialize) is left as is, and the
+  // replay kept for the next one
+  G4bool replay = !replay_ids_.empty() && n_event > 0;
+  if (replay && n_event != (G4int)replay_ids_.size()) {
+    G4cout << "Replaying " << replay_ids_.size() << " events." << G4endl;
+    n_event = replay_ids_.size();
+  }
+
+  // A run resumed from a checkpoint has only the remaining events
+  if (pman_ && pm_->GetResumedEvents() > 0)
+    n_event = std::max(n_event - pm_->GetResumedEvents(), 0);
+
+  // Check the photon sources, and renormalize the sensor efficiencies,
+  // before any photon is emitted
+  if (DetectionPreSamplingEnabled()) DetectionSurvivalProbability();
+
+  G4RunManager::BeamOn(n_event, macroFile, n_select);
+
+  // The replay only applies to this run
+  if (replay) {
+    replay_ids_.clear();
+    event_seeding_ = seeding_before_replay_;
+  }
+}
+
+
+
+G4Event* NexusApp::GenerateEvent(G4int i_event)
+{
+  // The events of a resumed run follow those completed before the
+  // checkpoint, starting with the random engine as it was then
+  G4int resumed = pman_ ? pm_->GetResumedEvents() : 0;
+  if (resumed > 0) {
+    if (i_event == 0) pm_->RestoreRandomEngine();
+    i_event += resumed;
+  }
+
+  if (event_seeding_) {
+    int64_t start_id = pman_ ? pm_->GetStartID() : 0;
+
+    // The i-th event of a replay run is the i-th event of the list
+    if (!replay_ids_.empty())
+      i_event = replay_ids_[i_event] - start_id;
+
+    event_seed_ = EventSeed(run_seed_, i_event, start_id);
+    SetEventSeed(event_seed_);
+  }
+
+  return G4RunManager::GenerateEvent(i_event);
+}
+
+
+
 void NexusApp::ExecuteMacroFile(const char* filename)
 {
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -221,6 +298,34 @@ void NexusApp::SetRandomSeed(G4int seed)
   // Set the seed chosen by the user for the pseudo-random number
   // generator unless a negative number was provided, in which case
   // we will set as seed the system time.
-  if (seed < 0) CLHEP::HepRandom::setTheSeed(time(0));
-  else CLHEP::HepRandom::setTheSeed(seed);
+  clock_seed_ = (seed < 0);
+  if (clock_seed_) run_seed_ = time(0);
+  else run_seed_ = seed;
+  CLHEP::HepRandom::setTheSeed(run_seed_);
+}
+
+
+
+void NexusApp::ResumeRandomSeed(G4long seed)
+{
+  run_seed_ = seed;
+  CLHEP::HepRandom::setTheSeed(run_seed_);
+}
+
+
+
+void NexusApp::ReplayEvents(G4String ids)
+{
+  if (replay_ids_.empty()) seeding_before_replay_ = event_seeding_;
+
+  std::istringstream iss(ids);
+  int64_t id;
+  while (iss >> id) replay_ids_.push_back(id);
+
+  if (!iss.eof()) {
+    G4Exception("[NexusApp]", "ReplayEvents()", FatalException,
+                ("Invalid list of event IDs: " + ids).c_str());
+  }
+
+  event_seeding_ = true;
 }
@@ -30,9 +30,30 @@ namespace nexus {
 
     virtual void Initialize();
 
+    /// Run the events, or the events to replay if any. A run
+    /// resumed from a checkpoint runs only the remaining events
+    virtual void BeamOn(G4int n_event, const char* macroFile=0, G4int n_select=-1);
+
+    /// Reseeds the random engine before generating the
+    /// event, if the event seeding is enabled. The events
+    /// of a resumed run continue the numbering of the checkpoint
+    virtual G4Event* GenerateEvent(G4int i_event);
+
     /// Returns the number of events to be processed in the current run
     G4int GetNumberOfEventsToBeProcessed() const;
 
+    /// Returns true if the random engine is reseeded for every event
+    G4bool EventSeeding() const;
+    /// Returns the seed of the run
+    G4long GetRandomSeed() const;
+    /// Returns true if the seed of the run was taken from the system time
+    G4bool RandomSeedFromClock() const;
+    /// Sets the seed of the run of a job resumed from a checkpoint
+    /// (the random engine is then restored from the checkpoint)
+    void ResumeRandomSeed(G4long);
+    /// Returns the seed of the current event (0 without event seeding)
+    uint64_t GetEventSeed() const;
+
   private:
     void RegisterMacro(G4String);
 
@@ -44,6 +65,11 @@ namespace nexus {
     /// If a negative value is chosen, the system time is set as seed.
     void SetRandomSeed(G4int);
 
+    /// Add events to replay in the next run, given their IDs separated
+    /// by spaces. The event seeding is enabled for that run, and the run
+    /// seed and start ID must be those of the original job.
+    void ReplayEvents(G4String);
+
   private:
     std::unique_ptr<G4GenericMessenger> msg_;
     G4String gen_name_; ///< Name of the chosen primary generator
@@ -62,6 +88,13 @@ namespace nexus {
 
     std::unique_ptr<PersistencyManagerBase> pm_;
 
+    G4long run_seed_; ///< Seed of the run
+    G4bool clock_seed_; ///< Seed of the run taken from the system time
+    G4bool event_seeding_; ///< Reseed the random engine for every event?
+    uint64_t event_seed_; ///< Seed of the current event
+    std::vector<int64_t> replay_ids_; ///< IDs of the events to replay
+    G4bool seeding_before_replay_; ///< Event seeding to restore after the replay
+
   };
 
   // INLINE DEFINITIONS ////////////////////////////////////
@@ -69,6 +102,18 @@ namespace nexus {
   inline G4int NexusApp::GetNumberOfEventsToBeProcessed() const
   { return numberOfEventToBeProcessed; }
 
+  inline G4bool NexusApp::EventSeeding() const
+  { return event_seeding_; }
+
+  inline G4long NexusApp::GetRandomSeed() const
+  { return run_seed_; }
+
+  inline G4bool NexusApp::RandomSeedFromClock() const
+  { return clock_seed_; }
+
+  inline uint64_t NexusApp::GetEventSeed() const
+  { return event_seed_; }
+
 } // namespace nexus
 
 #endif
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | TrackHistory.cc
+//
+// This class keeps the particles and processes that appeared in the
+// current event, whether their trajectories are stored or not.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "TrackHistory.h"
+
+#include <G4Track.hh>
+#include <G4Step.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4VProcess.hh>
+
+
+G4bool nexus::TrackHistory::enabled_ = false;
+std::set<const G4ParticleDefinition*> nexus::TrackHistory::particles_;
+std::set<const G4VProcess*> nexus::TrackHistory::processes_;
+
+
+namespace nexus {
+
+  TrackHistory::TrackHistory()
+  {
+  }
+
+
+
+  TrackHistory::~TrackHistory()
+  {
+  }
+
+
+
+  void TrackHistory::Enable(G4bool enabled)
+  {
+    enabled_ = enabled;
+  }
+
+
+
+  void TrackHistory::Record(const G4Track* track)
+  {
+    if (!enabled_) return;
+
+    particles_.insert(track->GetDefinition());
+
+    if (track->GetCreatorProcess())
+      processes_.insert(track->GetCreatorProcess());
+
+    const G4Step* step = track->GetStep();
+    if (step && step->GetPostStepPoint()->GetProcessDefinedStep())
+      processes_.insert(step->GetPostStepPoint()->GetProcessDefinedStep());
+  }
+
+
+
+  G4bool TrackHistory::HasParticle(const G4String& name)
+  {
+    for (const G4ParticleDefinition* particle: particles_)
+      if (particle->GetParticleName() == name) return true;
+    return false;
+  }
+
+
+
+  G4bool TrackHistory::HasProcess(const G4String& name)
+  {
+    for (const G4VProcess* process: processes_)
+      if (process->GetProcessName() == name) return true;
+    return false;
+  }
+
+
+
+  void TrackHistory::Clear()
+  {
+    particles_.clear();
+    processes_.clear();
+  }
+
+} // end namespace nexus
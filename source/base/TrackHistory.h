@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------------
+// nexus | TrackHistory.h
+//
+// This class keeps the particles and processes that appeared in the
+// current event, whether their trajectories are stored or not.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef TRACK_HISTORY_H
+#define TRACK_HISTORY_H
+
+#include <G4String.hh>
+
+#include <set>
+
+class G4Track;
+class G4ParticleDefinition;
+class G4VProcess;
+
+
+namespace nexus {
+
+  /// The tracking actions record every track at the end of its
+  /// tracking, including optical photons, ionization electrons and
+  /// the tracks without a stored trajectory. Nothing is recorded
+  /// unless recording is enabled (by EventSelection, when it has
+  /// conditions on particles or processes).
+
+  class TrackHistory
+  {
+  public:
+    /// Enable or disable the recording
+    static void Enable(G4bool);
+    /// Record the particle, creator process and final process of a track
+    static void Record(const G4Track*);
+    /// Return true if a track of the particle was recorded
+    static G4bool HasParticle(const G4String& name);
+    /// Return true if a track was created by the process or
+    /// ended with it
+    static G4bool HasProcess(const G4String& name);
+    /// Forget the tracks recorded (at the start of each event)
+    static void Clear();
+
+  private:
+    // Constructors, destructor and assignement op are hidden
+    // so that no instance of the class can be created.
+    TrackHistory();
+    TrackHistory(const TrackHistory&);
+    ~TrackHistory();
+
+  private:
+    static G4bool enabled_;
+    // Definitions and processes are shared by all the tracks,
+    // so that pointers are enough to tell them apart
+    static std::set<const G4ParticleDefinition*> particles_;
+    static std::set<const G4VProcess*> processes_;
+  };
+
+} // namespace nexus
+
+#endif
@@ -50,4 +50,20 @@ namespace nexus {
     map_[trj->GetTrackID()] = trj;
   }
 
+
+
+  void TrajectoryMap::Link(int trackId, G4VTrajectory* trj)
+  {
+    map_[trackId] = trj;
+  }
+
+
+
+  int TrajectoryMap::StoredAncestor(int trackId)
+  {
+    G4VTrajectory* trj = Get(trackId);
+    if (!trj) return trackId;
+    else return trj->GetTrackID();
+  }
+
 } // namespace nexus
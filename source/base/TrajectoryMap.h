@@ -23,6 +23,13 @@ namespace nexus {
     static G4VTrajectory* Get(int trackId);
     /// Add a trajectory to the map
     static void Add(G4VTrajectory*);
+    /// Associate a track without trajectory of its own to the
+    /// trajectory of an ancestor (e.g., for its energy deposit)
+    static void Link(int trackId, G4VTrajectory*);
+    /// Return the ID of the track if its trajectory is stored, or else
+    /// that of its closest stored ancestor. Tracks unknown to the map
+    /// keep their own ID
+    static int StoredAncestor(int trackId);
     /// Clear the map
     static void Clear();
 
@@ -6,7 +6,9 @@
 // FORTRAN package, with nexus.
 // It provides the primary vertex of a Xe-136 double beta decay.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta is also allowed. Input files are memory-mapped and
+// indexed by event, so that jobs can start at any event (start_id) and
+// several files can be chained, optionally wrapping around at the end.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -16,27 +18,47 @@
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
 #include "FactoryBase.h"
+#include "IOUtils.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4RunManager.hh>
 #include <G4ParticleTable.hh>
 #include <G4ParticleDefinition.hh>
 #include "decay0.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 using namespace nexus;
 
+namespace {
+
+  /// Return the position just after the end of the current line
+  const char* SkipLine(const char* ptr, const char* end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+    return eol ? eol + 1 : end;
+  }
+
+}
+
 REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
   G4VPrimaryGenerator(), msg_(0), decay_file_("th-e1-spectrum.dat"),
+  cur_file_(0), cur_evt_(0), start_id_(0), wrap_(false), next_id_(-1),
   opened_(false), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
     "Control commands of the Decay0 interface.");
 
-  msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
+  msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile,
+                      "Decay0 input file. Repeat the command to chain several files.");
+  msg_->DeclareProperty("start_id", start_id_,
+                        "Index of the first event read from the input files.");
+  msg_->DeclareProperty("wrap", wrap_,
+                        "Restart from the first input file after the last event.");
   msg_->DeclareProperty("region", region_, "");
   msg_->DeclareProperty("decay_file", decay_file_,
                         "Name of the file with the decay info");
@@ -58,7 +80,6 @@ Decay0Interface::Decay0Interface():
 
 Decay0Interface::~Decay0Interface()
 {
-  if (file_.is_open()) file_.close();
   if (fOutDebug_.is_open()) fOutDebug_.close();
   if (decay0_ != 0) delete decay0_;
 }
@@ -73,15 +94,65 @@ void Decay0Interface::OpenInputFile(G4String filename)
      return;
    }
 
-  file_.open(filename.data());
+  std::unique_ptr<MappedFile> file(new MappedFile(filename));
 
-  if (file_.good()) {
-    opened_ = true;
-    ProcessHeader();
-  }
-  else {
+  if (!file->IsOpen()) {
     G4Exception("[Decay0Interface]", "SetInputFile()", JustWarning,
       "Cannot open Decay0 input file.");
+    return;
+  }
+
+  std::vector<std::size_t> offsets;
+  IndexEvents(*file, ProcessHeader(*file), offsets);
+
+  G4cout << "[Decay0Interface] " << offsets.size() << " events found in "
+         << filename << G4endl;
+
+  files_.push_back(std::move(file));
+  offsets_.push_back(std::move(offsets));
+  opened_ = true;
+}
+
+
+
+void Decay0Interface::SeekEvent(G4int event_id)
+{
+  cur_file_ = 0;
+  cur_evt_  = 0;
+
+  std::size_t total = 0;
+  for (const auto& offsets: offsets_) total += offsets.size();
+
+  std::size_t index = std::max(start_id_, 0) + std::max(event_id, 0);
+  if (index >= total) {
+    if (wrap_ && total > 0) index %= total;
+    else {
+      cur_file_ = files_.size();
+      return;
+    }
+  }
+
+  while (index >= offsets_[cur_file_].size()) {
+    index -= offsets_[cur_file_].size();
+    ++cur_file_;
+  }
+  cur_evt_ = index;
+}
+
+
+
+void Decay0Interface::NextEvent()
+{
+  ++cur_evt_;
+
+  while (cur_file_ < files_.size() && cur_evt_ >= offsets_[cur_file_].size()) {
+    cur_evt_ = 0;
+    ++cur_file_;
+    if (cur_file_ == files_.size() && wrap_) {
+      cur_file_ = 0;
+      G4cout << "[Decay0Interface] End of input reached, "
+             << "restarting from the first event." << G4endl;
+    }
   }
 }
 
@@ -143,22 +214,34 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
   //G4cout << "GeneratePrimaryVertex()" << G4endl;
 
-  // reading event-related information
-  G4int entries;     // number of particles in the event
-  G4long evt_no;     // event number
-  G4double evt_time; // initial time in seconds
-
-  file_ >> evt_no >> evt_time >> entries;
-
+  // The input is read in sequence while the event IDs are consecutive,
+  // and otherwise (first event of a run, replayed events) from the
+  // event that corresponds to the ID
+  if (event->GetEventID() != next_id_) SeekEvent(event->GetEventID());
+  next_id_ = event->GetEventID() + 1;
 
-  // abort if end-of-file was reached in last operation
-  if (file_.eof()) {
+  // abort if the end of the input was reached
+  if (cur_file_ >= files_.size()) {
     G4cout  << "[Decay0Interface] End-of-File reached. "
             << "Aborting the run..." << G4endl;
     G4RunManager::GetRunManager()->AbortRun();
     return;
   }
 
+  const MappedFile& file = *files_[cur_file_];
+  const char* ptr = file.Data() + offsets_[cur_file_][cur_evt_];
+  const char* end = file.Data() + file.Size();
+
+  // reading event-related information
+  G4long entries;    // number of particles in the event
+  G4long evt_no;     // event number
+  G4double evt_time; // initial time in seconds
+
+  ParseInteger(ptr, end, evt_no);
+  ParseReal(ptr, end, evt_time);
+  ParseInteger(ptr, end, entries);
+  ptr = SkipLine(ptr, end);
+
   //G4cout << "entries: " << entries << G4endl;
 
   // generate a position in the detector
@@ -170,10 +253,16 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
   for (G4int i=0; i<entries; i++) {
     //G4cout << i << G4endl;
 
-    G4int g3code;           // GEANT3 particle code
+    G4long g3code;          // GEANT3 particle code
     G4double px, py, pz;    // Momentum components in MeV
 
-    file_ >> g3code >> px >> py >> pz >> particle_time;
+    if (!(ParseInteger(ptr, end, g3code) && ParseReal(ptr, end, px) &&
+          ParseReal(ptr, end, py) && ParseReal(ptr, end, pz) &&
+          ParseReal(ptr, end, particle_time))) {
+      G4Exception("[Decay0Interface]", "GeneratePrimaryVertex()", FatalException,
+                  "Malformed particle line in Decay0 input file.");
+    }
+    ptr = SkipLine(ptr, end);
 
     G4ParticleDefinition* g4code =
       G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(g3code));
@@ -194,18 +283,60 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
     // add vertex to the event
     event->AddPrimaryVertex(vertex);
   }
+
+  NextEvent();
 }
 
 
 
-void Decay0Interface::ProcessHeader()
+std::size_t Decay0Interface::ProcessHeader(const MappedFile& file) const
 {
-  G4String line;
+  const char* begin = file.Data();
+  const char* end   = begin + file.Size();
+  const char* ptr   = begin;
+
+  // Events start two lines after the one containing "First event"
+  const std::string tag("First event");
+  while (ptr < end) {
+    const char* next = SkipLine(ptr, end);
+    const G4bool found =
+      std::search(ptr, next, tag.begin(), tag.end()) != next;
+    ptr = next;
+    if (found) break;
+  }
 
-  while (!G4StrUtil::contains(line, "First event")) getline(file_, line);
+  ptr = SkipLine(ptr, end);
+  ptr = SkipLine(ptr, end);
 
-  getline(file_, line);
-  getline(file_, line);
+  return ptr - begin;
+}
+
+
+
+void Decay0Interface::IndexEvents(const MappedFile& file, std::size_t start,
+                                  std::vector<std::size_t>& offsets) const
+{
+  const char* begin = file.Data();
+  const char* end   = begin + file.Size();
+  const char* ptr   = begin + start;
+
+  while (ptr < end) {
+    const char* evt_begin = ptr;
+
+    G4long evt_no, entries;
+    G4double evt_time;
+    if (!(ParseInteger(ptr, end, evt_no) && ParseReal(ptr, end, evt_time) &&
+          ParseInteger(ptr, end, entries)))
+      break;
+
+    // skip the particle lines; a truncated last event is dropped
+    ptr = SkipLine(ptr, end);
+    G4long i = 0;
+    for (; i<entries && ptr<end; ++i) ptr = SkipLine(ptr, end);
+    if (i < entries) break;
+
+    offsets.push_back(evt_begin - begin);
+  }
 }
 
 
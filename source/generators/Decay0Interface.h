@@ -5,7 +5,9 @@
 // interfacing the DECAY0 c++ code, translated from the original
 // FORTRAN package, with nexus.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta is also allowed. Input files are memory-mapped and
+// indexed by event, so that jobs can start at any event (start_id) and
+// several files can be chained, optionally wrapping around at the end.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -15,6 +17,8 @@
 
 #include <G4VPrimaryGenerator.hh>
 #include <fstream>
+#include <memory>
+#include <vector>
 
 class G4GenericMessenger;
 class G4Event;
@@ -24,6 +28,7 @@ class decay0;
 namespace nexus {
 
   class GeometryBase;
+  class MappedFile;
 
 
   /// This primary generator sets the G4Event objects according to the
@@ -43,10 +48,22 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
-    /// Open the Decay0 input file selected by the user
+    /// Open the Decay0 input file selected by the user. Successive
+    /// calls chain the files, which are read in the order given
     void OpenInputFile(G4String);
-    /// Parse information in the file header
-    void ProcessHeader();
+    /// Return the offset of the first event, after the file header
+    std::size_t ProcessHeader(const MappedFile&) const;
+    /// Fill the offsets of the events found from the given position on
+    void IndexEvents(const MappedFile&, std::size_t,
+                     std::vector<std::size_t>&) const;
+    /// Move to the event start_id_ + event_id of the chained input
+    /// files. Each event ID reads thus always the same input event:
+    /// the events of a run resumed from a checkpoint, numbered after
+    /// those completed before it, continue the reading from there, and
+    /// replayed events read again the input of their IDs
+    void SeekEvent(G4int event_id);
+    /// Move to the next event of the chained input files
+    void NextEvent();
 
     /// Return the PDG code equivalent to a given GEANT3 particle code
     G4int G3toPDG(const G4int);
@@ -56,7 +73,13 @@ namespace nexus {
 
     G4String decay_file_;
 
-    std::ifstream file_; ///< ASCII file produced by Decay0
+    std::vector<std::unique_ptr<MappedFile>> files_; ///< ASCII files produced by Decay0
+    std::vector<std::vector<std::size_t>> offsets_; ///< Start of each event in files_
+    std::size_t cur_file_; ///< Index of the file of the next event
+    std::size_t cur_evt_;  ///< Index of the next event in its file
+    G4int start_id_;       ///< Event of the chained files read first
+    G4bool wrap_;          ///< Restart from the first file at the end of the last one
+    G4int next_id_;        ///< ID of the event at the current position
     G4String region_; ///< region of generation of vertices in geometry
 
     G4bool opened_;
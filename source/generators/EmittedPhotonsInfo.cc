@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// nexus | EmittedPhotonsInfo.cc
+//
+// Information attached to a primary vertex of optical photons: the number
+// of photons emitted, before detection pre-sampling drops any of them.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "EmittedPhotonsInfo.h"
+
+using namespace nexus;
+
+EmittedPhotonsInfo::EmittedPhotonsInfo(G4long nphotons):
+  nphotons_(nphotons)
+{
+}
+
+EmittedPhotonsInfo::~EmittedPhotonsInfo()
+{
+}
+
+void EmittedPhotonsInfo::Print() const
+{
+  G4cout << "Photons emitted: " << nphotons_ << G4endl;
+}
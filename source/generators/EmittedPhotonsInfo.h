@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// nexus | EmittedPhotonsInfo.h
+//
+// Information attached to a primary vertex of optical photons: the number
+// of photons emitted, before detection pre-sampling drops any of them.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EMITTED_PHOTONS_INFO_H
+#define EMITTED_PHOTONS_INFO_H
+
+#include <G4VUserPrimaryVertexInformation.hh>
+#include "globals.hh"
+
+namespace nexus {
+
+  class EmittedPhotonsInfo: public G4VUserPrimaryVertexInformation
+  {
+  public:
+    //constructor
+    EmittedPhotonsInfo(G4long nphotons);
+    //destructor
+    ~EmittedPhotonsInfo();
+
+    void Print() const;
+    G4long GetNumberOfPhotons() const;
+
+  private:
+
+    G4long nphotons_;
+  };
+
+  inline G4long EmittedPhotonsInfo::GetNumberOfPhotons() const
+  { return nphotons_; }
+
+} // end namespace nexus
+
+#endif
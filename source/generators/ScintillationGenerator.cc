@@ -3,7 +3,9 @@
 //
 // This class is the primary generator of a number of optical photons with
 // energy following the scintillation spectrum of the material
-// where the vertex is produced.
+// where the vertex is produced. Optionally, vertices are taken in turn
+// from a regular grid of points, one per event, to produce light tables
+// in a single job.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -14,6 +16,8 @@
 #include "GeometryBase.h"
 #include "OpticalMaterialProperties.h"
 #include "FactoryBase.h"
+#include "DetectionPreSampling.h"
+#include "EmittedPhotonsInfo.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4ParticleDefinition.hh>
@@ -21,8 +25,10 @@
 #include <G4ParticleTable.hh>
 #include <G4PrimaryVertex.hh>
 #include <G4Event.hh>
-#include <G4RandomDirection.hh>
 #include <G4OpticalPhoton.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
@@ -43,6 +49,13 @@ ScintillationGenerator::ScintillationGenerator() :
 
   msg_->DeclareProperty("nphotons", nphotons_, "Number of photons");
 
+  msg_->DeclarePropertyWithUnit("grid_min", "mm", grid_min_,
+                                "First point of the grid of vertices.");
+  msg_->DeclarePropertyWithUnit("grid_max", "mm", grid_max_,
+                                "Last point of the grid of vertices.");
+  msg_->DeclarePropertyWithUnit("grid_step", "mm", grid_step_,
+                                "Spacing of the grid of vertices (0 for a fixed coordinate).");
+
   geom_navigator_ =
     G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
 
@@ -59,15 +72,87 @@ ScintillationGenerator::~ScintillationGenerator()
 void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   G4ParticleDefinition* particle_definition = G4OpticalPhoton::Definition();
-  // Generate an initial position for the particle using the geometry and set time to 0.
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  // Generate an initial position for the particle using the geometry
+  // (or the next point of the grid, if defined) and set time to 0.
+  G4ThreeVector position;
+  if (grid_step_ != G4ThreeVector()) position = GridVertex(event->GetEventID());
+  else                               position = geom_->GenerateVertex(region_);
   G4double time = 0.;
 
   // Energy is sampled from integral (like it is done in G4Scintillation)
 
   G4VPhysicalVolume* vol =
     geom_navigator_->LocateGlobalPointAndSetup(position, 0, false);
-  G4Material* mat = vol->GetLogicalVolume()->GetMaterial();
+  if (!vol) {
+    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "Vertex is outside the world volume!");
+  }
+  const SpectrumSampler& spectrum =
+    GetSpectrum(vol->GetLogicalVolume()->GetMaterial());
+
+  // Create a new vertex, which keeps the number of photons emitted
+  // for the normalization of light tables
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  vertex->SetUserInformation(new EmittedPhotonsInfo(nphotons_));
+
+  // Only the photons that may be detected are generated
+  // if the detection efficiency is pre-sampled
+  G4double survival = DetectionSurvivalProbability();
+  G4int nphotons = nphotons_;
+  if (survival < 1.)
+    nphotons = G4int(CLHEP::RandBinomial::shoot(nphotons_, survival));
+
+  // Random numbers are drawn from the engine in blocks:
+  // one for the energy and two for each of momentum direction and polarization
+  const G4int nrand = 5;
+  const G4int block = 4096;
+  std::vector<G4double> rnd(nrand * block);
+  CLHEP::HepRandomEngine* engine = G4Random::getTheEngine();
+
+  for (G4int first = 0; first < nphotons; first += block) {
+
+    G4int n = std::min(block, nphotons - first);
+    engine->flatArray(nrand * n, rnd.data());
+
+    for (G4int i = 0; i < n; ++i) {
+      const G4double* u = &rnd[nrand * i];
+
+      // Determine photon energy
+      G4double pmod = spectrum.Sample(u[0]);
+
+      // Generate random direction by default (as in G4RandomDirection)
+      G4double cost = 1. - 2.*u[1];
+      G4double sint = std::sqrt((1. - cost) * (1. + cost));
+      G4double phi  = twopi * u[2];
+
+      // Create the new primary particle and set it some properties
+      G4PrimaryParticle* particle =
+        new G4PrimaryParticle(particle_definition,
+                              pmod * sint * std::cos(phi),
+                              pmod * sint * std::sin(phi),
+                              pmod * cost);
+
+      G4double pol_cost = 1. - 2.*u[3];
+      G4double pol_sint = std::sqrt((1. - pol_cost) * (1. + pol_cost));
+      G4double pol_phi  = twopi * u[4];
+      particle->SetPolarization(pol_sint * std::cos(pol_phi),
+                                pol_sint * std::sin(pol_phi),
+                                pol_cost);
+
+      // Add particle to the vertex and this to the event
+      vertex->SetPrimary(particle);
+    }
+  }
+
+  event->AddPrimaryVertex(vertex);
+}
+
+
+const SpectrumSampler& ScintillationGenerator::GetSpectrum(const G4Material* mat)
+{
+  auto it = spectra_.find(mat);
+  if (it != spectra_.end()) return it->second;
+
   G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
 
   if (!mpt) {
@@ -84,48 +169,36 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
                 FatalException, "Fast time decay constant not defined for this material!");
   }
 
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    new G4PhysicsOrderedFreeVector();
-  ComputeCumulativeDistribution(*spectrum, *spectrum_integral);
-  G4double sc_max = spectrum_integral->GetMaxValue();
-
-  // Create a new vertex
-  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
-
-  for ( G4int i = 0; i<nphotons_; i++)
-    {
-      // Generate random direction by default
-      G4ThreeVector _momentum_direction = G4RandomDirection();
-      // Determine photon energy
-      G4double sc_value = G4UniformRand()*sc_max;
-      G4double pmod = spectrum_integral->GetEnergy(sc_value);
-      G4double px = pmod * _momentum_direction.x();
-      G4double py = pmod * _momentum_direction.y();
-      G4double pz = pmod * _momentum_direction.z();
-
-      // Create the new primary particle and set it some properties
-      G4PrimaryParticle* particle =
-        new G4PrimaryParticle(particle_definition, px, py, pz);
+  SpectrumSampler& sampler = spectra_[mat] = SpectrumSampler(*spectrum);
 
-      G4ThreeVector polarization = G4RandomDirection();
-      particle->SetPolarization(polarization);
+  if (sampler.IsEmpty()) {
+    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "Scintillation spectrum is empty!");
+  }
 
-      // Add particle to the vertex and this to the event
-      vertex->SetPrimary(particle);
-    }
-  event->AddPrimaryVertex(vertex);
+  return sampler;
 }
 
-void ScintillationGenerator::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
+
+G4ThreeVector ScintillationGenerator::GridVertex(G4int event_id) const
 {
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+  // Number of points along each axis (a single one if the step is null)
+  G4int n[3];
+  for (G4int i=0; i<3; ++i) {
+    n[i] = 1;
+    if (grid_step_[i] > 0.)
+      n[i] += G4int((grid_max_[i] - grid_min_[i]) / grid_step_[i] + 0.5);
+    if (n[i] < 1) n[i] = 1;
   }
+
+  // Loop over x first, then y, then z. If more events than points are
+  // requested, the grid is traversed again from the beginning.
+  G4int idx = event_id % (n[0] * n[1] * n[2]);
+  G4int ix  = idx % n[0];
+  G4int iy  = (idx / n[0]) % n[1];
+  G4int iz  = idx / (n[0] * n[1]);
+
+  return G4ThreeVector(grid_min_.x() + ix * grid_step_.x(),
+                       grid_min_.y() + iy * grid_step_.y(),
+                       grid_min_.z() + iz * grid_step_.z());
 }
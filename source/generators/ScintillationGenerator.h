@@ -3,7 +3,9 @@
 //
 // This class is the primary generator of a number of optical photons with
 // energy following the scintillation spectrum of the material
-// where the vertex is produced.
+// where the vertex is produced. Optionally, vertices are taken in turn
+// from a regular grid of points, one per event, to produce light tables
+// in a single job.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -11,13 +13,17 @@
 #ifndef SCINTILLATION_GENERATOR_H
 #define SCINTILLATION_GENERATOR_H
 
+#include "SpectrumSampler.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <G4Navigator.hh>
 #include <G4TransportationManager.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
+
+#include <map>
 
 class G4GenericMessenger;
 class G4Event;
+class G4Material;
 
 namespace nexus {
 
@@ -38,8 +44,12 @@ namespace nexus {
 
   private:
 
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
+    /// Return the sampler of the scintillation spectrum
+    /// of the material, building it on first use
+    const SpectrumSampler& GetSpectrum(const G4Material*);
+
+    /// Return the grid point corresponding to an event
+    G4ThreeVector GridVertex(G4int event_id) const;
 
     G4GenericMessenger* msg_;
     G4Navigator* geom_navigator_; ///< Geometry Navigator
@@ -48,6 +58,12 @@ namespace nexus {
     G4String region_;
     G4int    nphotons_;
 
+    G4ThreeVector grid_min_;  ///< First point of the vertex grid
+    G4ThreeVector grid_max_;  ///< Last point of the vertex grid
+    G4ThreeVector grid_step_; ///< Grid spacing (grid mode is off if null)
+
+    std::map<const G4Material*, SpectrumSampler> spectra_; ///< Spectra already built
+
   };
 
 } // end namespace nexus
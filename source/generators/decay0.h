@@ -93,9 +93,23 @@ class decay0 {
     mutable double e1_;
     mutable double ebb1_;
     mutable double ebb2_;
-    mutable std::vector<double> spthe2_;
 
-    void initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
+    // Sampling tables, built once in initSpectrum (and cached on disk, see cacheFileName)
+    // so that (e1, e2) are sampled by inverse cdf lookup instead of acceptance/rejection.
+    static const size_t nTableE2_ = 256; // points of the e2 conditional cdf, over the allowed e2 range
+    double e1Low_, e1High_;    // sampling range of e1
+    std::vector<double> cdf1_; // cdf of e1 over the 1 keV bins of spthe1_ (size spthe1_.size()+1)
+    std::vector<float> cdf2_;  // cdf of e2 for each e1 bin, nTableE2_ values per bin
+
+    bool initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
+    bool buildSamplingTables(); // Called from initSpectrum, fill cdf1_ and cdf2_; false if the e1 spectrum is empty
+    void writeSpectrumFile() const; // Dump spthe1_ to fname_
+    std::string cacheFileName() const; // File where spectrum and tables are cached for this configuration
+    bool readCache(); // Load spectrum and tables from the cache file, if it matches this configuration
+    void writeCache() const;
+    double fe2(double e2, void *p) const; // Probability of e2 for the modes where it is random
+    double sampleE1(size_t &bin) const;  // Sample e1 from cdf1_, return also its bin
+    double sampleE2(size_t bin) const;   // Sample e2 from the cdf of the bin of e1_
     void decay0DoItbb(std::vector<decay0Part> &outPart) const; // Main method, generate the two electrons.
     void Ba136low(std::vector<decay0Part> &outPart) const;  // Baryum 136 de-excitation.
 //    void Xe130low(std::vector<decay0Part> &outPart) const;  // Xenon de-excitation. // we (NEXT) don't care...
@@ -152,8 +166,6 @@ class decay0 {
         ebb1_ = e1; ebb2_=e2;
 	size_t nnE1= static_cast<size_t> (e1*1000.) + 1;
 	spthe1_.resize(nnE1);
-	size_t nnE2= static_cast<size_t> (e2*1000.) + 1;
-	spthe2_.resize(nnE2);
     } // Advanced option ?
     inline std::string GetNuclide() const { return nuclideName_;}
     inline size_t GetFinalStateNumber() { return fsNum_;}
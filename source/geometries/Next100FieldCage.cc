@@ -13,6 +13,7 @@
 #include "IonizationSD.h"
 #include "OpticalMaterialProperties.h"
 #include "UniformElectricDriftField.h"
+#include "FieldMapDriftField.h"
 #include "XenonProperties.h"
 #include "CylinderPointSampler.h"
 #include "BoxPointSampler.h"
@@ -155,6 +156,11 @@ Next100FieldCage::Next100FieldCage(G4double grid_thickn):
   ELlong_diff_cmd.SetParameterName("ELlong_diff", true);
   ELlong_diff_cmd.SetUnitCategory("Diffusion");
 
+  msg_->DeclareProperty("drift_field_map", drift_field_map_,
+                        "Map of drift velocity, diffusion and distortion "
+                        "for the drift region. If not given, the field "
+                        "is uniform, with the diffusion set above.");
+
   msg_->DeclareProperty("elfield", elfield_,
                         "True if the EL field is on (full simulation), "
                         "false if it's not (parametrized simulation.");
@@ -325,14 +331,26 @@ void Next100FieldCage::BuildActive()
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
   /// Define a drift field for this volume
-  UniformElectricDriftField* field = new UniformElectricDriftField();
+  BaseDriftField* field = 0;
   G4double global_active_zpos = active_zpos_ - GetCoordOrigin().z();
-  field->SetCathodePosition(global_active_zpos + active_length_/2.);
-  field->SetAnodePosition(global_active_zpos - active_length_/2.);
-  field->SetDriftVelocity(1. * mm/microsecond);
-  field->SetTransverseDiffusion(drift_transv_diff_);
-  field->SetLongitudinalDiffusion(drift_long_diff_);
-  field->SetLifetime(e_lifetime_);
+  if (drift_field_map_ == "") {
+    UniformElectricDriftField* uniform_field = new UniformElectricDriftField();
+    uniform_field->SetCathodePosition(global_active_zpos + active_length_/2.);
+    uniform_field->SetAnodePosition(global_active_zpos - active_length_/2.);
+    uniform_field->SetDriftVelocity(1. * mm/microsecond);
+    uniform_field->SetTransverseDiffusion(drift_transv_diff_);
+    uniform_field->SetLongitudinalDiffusion(drift_long_diff_);
+    uniform_field->SetLifetime(e_lifetime_);
+    field = uniform_field;
+  }
+  else {
+    FieldMapDriftField* map_field =
+      new FieldMapDriftField(drift_field_map_,
+                             global_active_zpos - active_length_/2.,
+                             global_active_zpos + active_length_/2.);
+    map_field->SetLifetime(e_lifetime_);
+    field = map_field;
+  }
   G4Region* drift_region = new G4Region("DRIFT");
   drift_region->SetUserInformation(field);
   drift_region->AddRootLogicalVolume(active_logic);
@@ -68,6 +68,7 @@ namespace nexus {
 
     // Diffusion constants
     G4double drift_transv_diff_, drift_long_diff_;
+    G4String drift_field_map_; ///< Map file of the drift field, uniform field if empty
     G4double ELtransv_diff_; ///< transversal diffusion in the EL gap
     G4double ELlong_diff_; ///< longitudinal diffusion in the EL gap
     // Electric field
@@ -21,6 +21,8 @@
 #include <G4Tubs.hh>
 #include <G4LogicalVolume.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
+#include <G4VPVParameterisation.hh>
 #include <G4Material.hh>
 #include <G4NistManager.hh>
 #include <G4OpticalSurface.hh>
@@ -31,6 +33,34 @@
 using namespace nexus;
 
 
+namespace {
+
+  // Places the copies of a volume on the nodes of a square grid of
+  // n x n cells. Copy number i*n + j corresponds to the node at
+  // (first + i*pitch, first + j*pitch), as in the loop of placements.
+
+  class SiPMGridParameterisation: public G4VPVParameterisation
+  {
+  public:
+    SiPMGridParameterisation(G4int n, G4double first, G4double pitch, G4double z):
+      n_(n), first_(first), pitch_(pitch), z_(z) {}
+
+    void ComputeTransformation(const G4int copy_no,
+                               G4VPhysicalVolume* pv) const override
+    {
+      pv->SetTranslation(G4ThreeVector(first_ + (copy_no / n_) * pitch_,
+                                       first_ + (copy_no % n_) * pitch_, z_));
+      pv->SetRotation(nullptr);
+    }
+
+  private:
+    G4int n_;
+    G4double first_, pitch_, z_;
+  };
+
+}
+
+
 Next100SiPMBoard::Next100SiPMBoard():
   GeometryBase     (),
   size_            (122.40  * mm),
@@ -41,6 +71,7 @@ Next100SiPMBoard::Next100SiPMBoard():
   time_binning_    (1. * microsecond),
   visibility_      (true),
   sipm_visibility_ (false),
+  parameterised_   (false),
   mpv_             (nullptr),
   vtxgen_          (nullptr),
   sipm_            (new Next100SiPM())
@@ -52,6 +83,9 @@ Next100SiPMBoard::Next100SiPMBoard():
 
   msg_->DeclareProperty("sipm_vis", sipm_visibility_, "Visibility of Next100 SiPMs.");
 
+  msg_->DeclareProperty("sipm_board_parameterised", parameterised_,
+                        "Place the SiPM holes of the boards as a parameterised volume.");
+
   G4GenericMessenger::Command& time_binning_cmd =
   msg_->DeclareProperty("sipm_time_binning", time_binning_,
                         "TP SiPMs time binning.");
@@ -225,7 +259,8 @@ void Next100SiPMBoard::Construct()
   sipm_->SetSiPMCoatingThickness(2. * micrometer);
   sipm_->SetTimeBinning(time_binning_);
   sipm_->SetSensorDepth(2);
-  sipm_->SetMotherDepth(4);
+  // The parameterised holes are placed in an extra volume of the mask
+  sipm_->SetMotherDepth(parameterised_ ? 5 : 4);
   sipm_->SetNamingOrder(1000);
   sipm_->Construct();
 
@@ -242,39 +277,82 @@ void Next100SiPMBoard::Construct()
   // Placing now 8x8 replicas of the gas hole and SiPM
 
   G4double zpos = board_thickness_ + sipm_thickn/2.;
-  G4VPhysicalVolume* mask_hole_phys_vol;
-
-  G4int counter = 0;
+  G4double first_pos = -size_/2. + margin_;
 
   for (auto i=0; i<8; i++) {
+    for (auto j=0; j<8; j++) {
+      sipm_positions_.push_back(G4ThreeVector(first_pos + i * pitch_,
+                                              first_pos + j * pitch_, zpos));
+    }
+  }
 
-    G4double xpos = -size_/2. + margin_ + i * pitch_;
+  G4LogicalVolume* mask_body_logic_vol = nullptr;
 
-    for (auto j=0; j<8; j++) {
+  if (parameterised_) {
+    // A parameterised volume must be the only daughter of its mother,
+    // so the holes are placed in a teflon volume filling the mask
+    // below the WLS coating, which gets the same optical surface.
+    // Copy numbers follow the same i*8+j ordering as the placements.
+    G4String mask_body_name = mask_name + "_BODY";
+
+    G4Box* mask_body_solid_vol =
+      new G4Box(mask_body_name, size_/2., size_/2., mask_hole_length/2.);
+
+    mask_body_logic_vol =
+      new G4LogicalVolume(mask_body_solid_vol, teflon, mask_body_name);
+
+    new G4PVPlacement(nullptr, G4ThreeVector(0., 0., mask_hole_zpos),
+                      mask_body_logic_vol, mask_body_name, mask_logic_vol,
+                      false, 0, false);
+
+    new G4LogicalSkinSurface(mask_body_name+"_OPSURF",
+                             mask_body_logic_vol, mask_opsurf);
+
+    new G4PVParameterised(mask_wls_hole_name, mask_wls_hole_logic_vol,
+                          mask_wls_logic_vol, kUndefined, 64,
+                          new SiPMGridParameterisation(8, first_pos, pitch_, 0.));
+
+    new G4PVParameterised(mask_hole_name, mask_hole_logic_vol,
+                          mask_body_logic_vol, kUndefined, 64,
+                          new SiPMGridParameterisation(8, first_pos, pitch_, 0.));
+
+    // The hole walls are only in contact with the gas of their
+    // hole, so a single skin surface replaces the border surfaces.
+    new G4LogicalSkinSurface(mask_wall_wls_name+"_OPSURF",
+                             wall_wls_logic_vol, mask_wls_opsurf);
+  }
+  else {
+    G4VPhysicalVolume* mask_hole_phys_vol;
+
+    G4int counter = 0;
+
+    for (auto i=0; i<8; i++) {
+
+      G4double xpos = first_pos + i * pitch_;
+
+      for (auto j=0; j<8; j++) {
+
+        G4double ypos = first_pos + j * pitch_;
+
+        // Placement of the WLS gas hole
+        new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, 0.),
+                          mask_wls_hole_logic_vol, mask_wls_hole_name,
+                          mask_wls_logic_vol, false, counter, false);
+        // Placement of the hole+SiPM
+        mask_hole_phys_vol =
+          new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, mask_hole_zpos),
+                            mask_hole_logic_vol, mask_hole_name, mask_logic_vol,
+                            false, counter, false);
+
+        new G4LogicalBorderSurface(mask_wall_wls_name+"_OPSURF",
+                                   mask_hole_phys_vol, wall_wls_phys_vol,
+                                   mask_wls_opsurf);
+        new G4LogicalBorderSurface(mask_wls_name+"_OPSURF",
+                                   wall_wls_phys_vol, mask_hole_phys_vol,
+                                   mask_wls_opsurf);
 
-      G4double ypos = -size_/2. + margin_ + j * pitch_;
-
-      G4ThreeVector sipm_position(xpos, ypos, zpos);
-      sipm_positions_.push_back(sipm_position);
-
-      // Placement of the WLS gas hole
-      new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, 0.),
-                        mask_wls_hole_logic_vol, mask_wls_hole_name,
-                        mask_wls_logic_vol, false, counter, false);
-      // Placement of the hole+SiPM
-      mask_hole_phys_vol =
-        new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, mask_hole_zpos),
-                          mask_hole_logic_vol, mask_hole_name, mask_logic_vol,
-                          false, counter, false);
-
-      new G4LogicalBorderSurface(mask_wall_wls_name+"_OPSURF",
-                                 mask_hole_phys_vol, wall_wls_phys_vol,
-                                 mask_wls_opsurf);
-      new G4LogicalBorderSurface(mask_wls_name+"_OPSURF",
-                                 wall_wls_phys_vol, mask_hole_phys_vol,
-                                 mask_wls_opsurf);
-
-      counter++;
+        counter++;
+      }
     }
   }
 
@@ -287,9 +365,13 @@ void Next100SiPMBoard::Construct()
   if (visibility_) {
     G4VisAttributes light_blue = LightBlue();
     mask_logic_vol  ->SetVisAttributes(light_blue);
+    if (mask_body_logic_vol)
+      mask_body_logic_vol->SetVisAttributes(light_blue);
   }
   else{
     mask_logic_vol  ->SetVisAttributes(G4VisAttributes::GetInvisible());
+    if (mask_body_logic_vol)
+      mask_body_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
   }
   mask_hole_logic_vol    ->SetVisAttributes(G4VisAttributes::GetInvisible());
   mask_wls_logic_vol     ->SetVisAttributes(G4VisAttributes::GetInvisible());
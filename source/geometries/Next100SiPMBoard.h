@@ -52,6 +52,7 @@ namespace nexus {
     G4double time_binning_;
     std::vector<G4ThreeVector> sipm_positions_;
     G4bool   visibility_, sipm_visibility_;
+    G4bool   parameterised_; ///< Place the SiPM holes as a G4PVParameterised
     G4VPhysicalVolume*  mpv_;
     BoxPointSampler*    vtxgen_;
     Next100SiPM* sipm_;
@@ -17,6 +17,7 @@
 #include "GenericPhotosensor.h"
 #include "SensorSD.h"
 #include "Visibilities.h"
+#include "WLSFiberFastModel.h"
 
 #include <G4UnitsTable.hh>
 #include <G4GenericMessenger.hh>
@@ -28,16 +29,49 @@
 #include <G4SDManager.hh>
 #include <G4VisAttributes.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
+#include <G4VPVParameterisation.hh>
 #include <G4OpticalSurface.hh>
 #include <G4LogicalSkinSurface.hh>
 #include <G4LogicalBorderSurface.hh>
 #include <G4UserLimits.hh>
 #include <G4Transform3D.hh>
+#include <G4Region.hh>
 
 
 using namespace nexus;
 
 
+namespace {
+
+  // Places the copies of a volume with the positions
+  // and rotations (of the object) given for each copy number.
+
+  class FiberSensorParameterisation: public G4VPVParameterisation
+  {
+  public:
+    void AddCopy(const G4RotationMatrix& rot, const G4ThreeVector& pos)
+    {
+      // The physical volume holds the rotation of the frame
+      rotations_.push_back(rot.inverse());
+      positions_.push_back(pos);
+    }
+
+    void ComputeTransformation(const G4int copy_no,
+                               G4VPhysicalVolume* pv) const override
+    {
+      pv->SetTranslation(positions_[copy_no]);
+      pv->SetRotation(&rotations_[copy_no]);
+    }
+
+  private:
+    mutable std::vector<G4RotationMatrix> rotations_;
+    std::vector<G4ThreeVector> positions_;
+  };
+
+}
+
+
 NextFlexFieldCage::NextFlexFieldCage():
   GeometryBase(),
   mother_logic_            (nullptr),
@@ -62,6 +96,9 @@ NextFlexFieldCage::NextFlexFieldCage():
   photoe_prob_             (0),                  // OpticalPhotoElectric Probability
   fiber_claddings_         (2),                  // Number of fiber claddings (0, 1 or 2)
   fiber_sensor_binning_    (100. * ns),          // Size of fiber sensors time binning
+  fiber_sensors_parameterised_ (false),          // Fiber sensors as parameterised rings
+  fiber_sensor_smartless_  (0.),                 // Smart voxel tuning of fiber sensors mother
+  fiber_fast_model_        (false),              // Fast light transport along fibers
   wls_mat_name_            ("TPB"),              // UV wls material name
   fiber_mat_name_          ("EJ280"),            // Fiber core material name
   el_gap_gen_disk_diam_    (0.),                 // EL_GAP generator diameter
@@ -226,6 +263,20 @@ void NextFlexFieldCage::DefineConfigurationParameters()
   fiber_sensor_binning_cmd.SetUnitCategory("Time");
   fiber_sensor_binning_cmd.SetRange("fiber_sensor_time_binning>=0.");
 
+  msg_->DeclareProperty("fiber_sensors_parameterised", fiber_sensors_parameterised_,
+                        "Place the fiber sensors as parameterised rings.");
+
+  G4GenericMessenger::Command& fiber_sensor_smartless_cmd =
+    msg_->DeclareProperty("fiber_sensor_smartless", fiber_sensor_smartless_,
+                          "Smart voxel quality of the volume holding the fiber sensors "
+                          "(0 keeps the Geant4 default).");
+  fiber_sensor_smartless_cmd.SetParameterName("fiber_sensor_smartless", false);
+  fiber_sensor_smartless_cmd.SetRange("fiber_sensor_smartless>=0.");
+
+  msg_->DeclareProperty("fiber_fast_model", fiber_fast_model_,
+                        "Transport the light trapped in the fibers to their ends "
+                        "with WLSFiberFastModel (needs /PhysicsList/Nexus/fast_simulation).");
+
   // EL_GAP GENERATOR
   G4GenericMessenger::Command& el_gap_gen_disk_diam_cmd =
     msg_->DeclareProperty("el_gap_gen_disk_diam", el_gap_gen_disk_diam_,
@@ -831,6 +882,20 @@ void NextFlexFieldCage::BuildFibers()
   // Updating info
   if (fiber_claddings_ == 0) out_logic_volume = core_logic;
 
+  // Fast light transport, trapped by the outermost cladding
+  if (fiber_fast_model_) {
+    G4Material* clad_mat = mother_logic_->GetMaterial();
+    if      (fiber_claddings_ == 1) clad_mat = iClad_mat_;
+    else if (fiber_claddings_ >= 2) clad_mat = oClad_mat_;
+
+    G4Region* core_region = new G4Region(core_name);
+    core_region->AddRootLogicalVolume(core_logic);
+
+    WLSFiberFastModel* fast_model =
+      new WLSFiberFastModel(core_region, fiber_mat_, clad_mat, fiber_length);
+    fast_model->SetBarrel(true);
+  }
+
   // Vertex generator
   fiber_gen_ =
     new CylinderPointSampler(inner_rad, outer_rad, fiber_length/2., 0., twopi,
@@ -957,6 +1022,17 @@ void NextFlexFieldCage::BuildFiberSensors()
   G4RotationMatrix sensor_right_rot;
   sensor_right_rot.rotateY(pi);
 
+  // In parameterised mode, the sensors of each end are the copies
+  // of a G4PVParameterised inside a ring of gas. A parameterised
+  // volume must be the only daughter of its mother, and the copy
+  // number of the ring provides the offset of the sensor IDs.
+  FiberSensorParameterisation* left_param  = nullptr;
+  FiberSensorParameterisation* right_param = nullptr;
+  if (fiber_sensors_parameterised_) {
+    left_param  = new FiberSensorParameterisation();
+    right_param = new FiberSensorParameterisation();
+  }
+
   for (G4int sensor_id=0; sensor_id < num_fiber_sensors_; sensor_id++) {
 
     G4double phi = sensor_id * fiber_sensor_phi;
@@ -971,9 +1047,13 @@ void NextFlexFieldCage::BuildFiberSensors()
     if (verbosity_) G4cout << "* Left  fiber sensor " << first_left_sensor_id_ + sensor_id
                            << " position: " << case_left_pos << G4endl;
 
-    new G4PVPlacement(G4Transform3D(sensor_left_rot, case_left_pos), left_sensor_logic,
-                      left_sensor_logic->GetName(), mother_logic_, true,
-                      first_left_sensor_id_ + sensor_id, false);
+    if (left_param)
+      left_param->AddCopy(sensor_left_rot,
+                          case_left_pos - G4ThreeVector(0., 0., sensor_left_posZ));
+    else
+      new G4PVPlacement(G4Transform3D(sensor_left_rot, case_left_pos), left_sensor_logic,
+                        left_sensor_logic->GetName(), mother_logic_, true,
+                        first_left_sensor_id_ + sensor_id, false);
 
     // Right Sensors
     if (sensor_id > 0) sensor_right_rot.rotateZ(-fiber_sensor_phi);
@@ -985,9 +1065,52 @@ void NextFlexFieldCage::BuildFiberSensors()
     if (verbosity_) G4cout << "* Right fiber sensor " << first_right_sensor_id_ + sensor_id
                            << " position: " << case_right_pos << G4endl;
 
-    new G4PVPlacement(G4Transform3D(sensor_right_rot, case_right_pos), right_sensor_logic,
-                                    right_sensor_logic->GetName(), mother_logic_, true,
-                                    first_right_sensor_id_ + sensor_id, false);
+    if (right_param)
+      right_param->AddCopy(sensor_right_rot,
+                           case_right_pos - G4ThreeVector(0., 0., sensor_right_posZ));
+    else
+      new G4PVPlacement(G4Transform3D(sensor_right_rot, case_right_pos), right_sensor_logic,
+                                      right_sensor_logic->GetName(), mother_logic_, true,
+                                      first_right_sensor_id_ + sensor_id, false);
+  }
+
+  if (fiber_sensors_parameterised_) {
+    // The rings enclose the corners of the squared sensors
+    G4double ring_outer_rad =
+      std::sqrt(std::pow(fiber_inner_rad_ + fiber_sensor_size_, 2) +
+                std::pow(fiber_sensor_size_/2., 2));
+
+    G4Tubs* ring_solid =
+      new G4Tubs("F_SENSOR_RING", fiber_inner_rad_, ring_outer_rad,
+                 fiber_sensor_thickness_/2., 0., twopi);
+
+    G4LogicalVolume* left_ring_logic =
+      new G4LogicalVolume(ring_solid, mother_logic_->GetMaterial(), "F_SENSOR_RING_L");
+    G4LogicalVolume* right_ring_logic =
+      new G4LogicalVolume(ring_solid, mother_logic_->GetMaterial(), "F_SENSOR_RING_R");
+
+    new G4PVPlacement(nullptr, G4ThreeVector(0., 0., sensor_left_posZ),
+                      left_ring_logic, left_ring_logic->GetName(), mother_logic_,
+                      false, first_left_sensor_id_, false);
+    new G4PVPlacement(nullptr, G4ThreeVector(0., 0., sensor_right_posZ),
+                      right_ring_logic, right_ring_logic->GetName(), mother_logic_,
+                      false, first_right_sensor_id_, false);
+
+    new G4PVParameterised(left_sensor_logic->GetName(), left_sensor_logic,
+                          left_ring_logic, kUndefined, num_fiber_sensors_, left_param);
+    new G4PVParameterised(right_sensor_logic->GetName(), right_sensor_logic,
+                          right_ring_logic, kUndefined, num_fiber_sensors_, right_param);
+
+    left_ring_logic ->SetVisAttributes(G4VisAttributes::GetInvisible());
+    right_ring_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+
+    if (fiber_sensor_smartless_ > 0.) {
+      left_ring_logic ->SetSmartless(fiber_sensor_smartless_);
+      right_ring_logic->SetSmartless(fiber_sensor_smartless_);
+    }
+  }
+  else if (fiber_sensor_smartless_ > 0.) {
+    mother_logic_->SetSmartless(fiber_sensor_smartless_);
   }
 
   /// Verbosity
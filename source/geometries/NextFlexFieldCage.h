@@ -149,6 +149,9 @@ namespace nexus {
     G4double fiber_sensor_thickness_;
     G4double fiber_sensor_binning_;
     G4int    num_fiber_sensors_;
+    G4bool   fiber_sensors_parameterised_; // Sensors in parameterised rings
+    G4double fiber_sensor_smartless_;      // Smart voxel tuning (0: default)
+    G4bool   fiber_fast_model_;            // Fast light transport (WLSFiberFastModel)
 
 
     // Materials
@@ -12,14 +12,37 @@
 
 #include <G4MaterialPropertiesTable.hh>
 
+#include <map>
+#include <vector>
+
 
 using namespace nexus;
 using namespace CLHEP;
 
 namespace opticalprops {
 
+  namespace {
+
+    typedef std::pair<std::string, std::vector<G4double>> TableKey;
+
+    /// Returns the cache entry of the table built by a function with the
+    /// given parameters. The entry is null if the table was not built yet.
+    /// Tables are shared by all the materials and surfaces using them,
+    /// so they must not be modified after being returned.
+    G4MaterialPropertiesTable*& CachedTable(const std::string& function,
+                                            const std::vector<G4double>& params = {})
+    {
+      static std::map<TableKey, G4MaterialPropertiesTable*> tables;
+      return tables[TableKey(function, params)];
+    }
+
+  }
+
   G4MaterialPropertiesTable* Vacuum()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Vacuum");
+    if (cached) return cached;
+
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
     std::vector<G4double> photEnergy = {optPhotMinE_, optPhotMaxE_};
@@ -32,13 +55,16 @@ namespace opticalprops {
     std::vector<G4double> absLength = {noAbsLength_, noAbsLength_};
     mpt->AddProperty("ABSLENGTH", photEnergy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* FusedSilica()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("FusedSilica");
+    if (cached) return cached;
+
     // Optical properties of Suprasil 311/312(c) synthetic fused silica.
     // Obtained from http://heraeus-quarzglas.com
 
@@ -101,7 +127,7 @@ namespace opticalprops {
 
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -109,6 +135,9 @@ namespace opticalprops {
   G4MaterialPropertiesTable* FakeFusedSilica(G4double transparency,
                                              G4double thickness)
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("FakeFusedSilica", {transparency, thickness});
+    if (cached) return cached;
+
     // Optical properties of Suprasil 311/312(c) synthetic fused silica.
     // Obtained from http://heraeus-quarzglas.com
 
@@ -123,12 +152,15 @@ namespace opticalprops {
     std::vector<G4double> abs_l      = {abs_length, abs_length};
     mpt->AddProperty("ABSLENGTH", abs_energy, abs_l);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
   G4MaterialPropertiesTable* Epoxy()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Epoxy");
+    if (cached) return cached;
+
     // This is the material used as a window for NEXT-100 SiPMs.
 
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -240,13 +272,16 @@ namespace opticalprops {
     };
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* ITO()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("ITO");
+    if (cached) return cached;
+
     // Input data: complex refraction index obtained from:
     // https://refractiveindex.info/?shelf=other&book=In2O3-SnO2&page=Moerland
     // Only valid in [1000 - 400] nm
@@ -293,13 +328,16 @@ namespace opticalprops {
     //         << "  Abs Length: " << std::setw(5) << abs_length[i] / nm << " nm" << G4endl;
     //}
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* PEDOT()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("PEDOT");
+    if (cached) return cached;
+
     // Input data: complex refraction index obtained from:
     // https://refractiveindex.info/?shelf=other&book=PEDOT-PSS&page=Chen
     // Only valid in [1097 - 302] nm
@@ -346,13 +384,16 @@ namespace opticalprops {
     //         << "  Abs Length: " << std::setw(5) << abs_length[i] / nm << " nm" << G4endl;
     //}
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* GlassEpoxy()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("GlassEpoxy");
+    if (cached) return cached;
+
     // Optical properties of Optorez 1330 glass epoxy.
     // Obtained from http://refractiveindex.info and
     // https://www.zeonex.com/Optics.aspx.html#glass-like
@@ -400,13 +441,16 @@ namespace opticalprops {
     };
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* Sapphire()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Sapphire");
+    if (cached) return cached;
+
     // Input data: Sellmeier equation coeficients extracted from:
     // https://refractiveindex.info/?shelf=3d&book=crystals&page=sapphire
     // C[i] coeficients at line 362 are squared.
@@ -463,13 +507,16 @@ namespace opticalprops {
     };
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* OptCoupler()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("OptCoupler");
+    if (cached) return cached;
+
     // gel NyoGel OCK-451
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
@@ -514,7 +561,7 @@ namespace opticalprops {
     };
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -523,6 +570,9 @@ namespace opticalprops {
   G4MaterialPropertiesTable* GAr(G4double sc_yield,
                                 G4double e_lifetime)
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("GAr", {sc_yield, e_lifetime});
+    if (cached) return cached;
+
     // An argon gas proportional scintillation counter with UV avalanche photodiode scintillation
     // readout C.M.B. Monteiro, J.A.M. Lopes, P.C.P.S. Simoes, J.M.F. dos Santos, C.A.N. Conde
     //
@@ -589,18 +639,24 @@ namespace opticalprops {
     mpt->AddConstProperty("SCINTILLATIONYIELD2", .864);
     mpt->AddConstProperty("RESOLUTIONSCALE",    1.0);
     mpt->AddConstProperty("ATTACHMENT",         e_lifetime, 1);
+    mpt->AddConstProperty("IONIZATIONENERGY",   26.4 * eV, 1);
+    mpt->AddConstProperty("FANOFACTOR",         .23, 1);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   /// Gaseous xenon ///
   G4MaterialPropertiesTable* GXe(G4double pressure,
-                                 G4double /*temperature*/,
+                                 G4double temperature,
                                 G4int    sc_yield,
                                 G4double e_lifetime)
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("GXe",
+      {pressure, temperature, G4double(sc_yield), e_lifetime});
+    if (cached) return cached;
+
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
     // REFRACTIVE INDEX
@@ -653,8 +709,10 @@ namespace opticalprops {
     mpt->AddConstProperty("SCINTILLATIONYIELD1", .1);
     mpt->AddConstProperty("SCINTILLATIONYIELD2", .9);
     mpt->AddConstProperty("ATTACHMENT",         e_lifetime, 1);
+    mpt->AddConstProperty("IONIZATIONENERGY",   22.4 * eV, 1);
+    mpt->AddConstProperty("FANOFACTOR",         .15, 1);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -662,6 +720,9 @@ namespace opticalprops {
   /// Liquid xenon ///
   G4MaterialPropertiesTable* LXe()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("LXe");
+    if (cached) return cached;
+
     /// The time constants are taken from E. Hogenbirk et al 2018 JINST 13 P10031
     G4MaterialPropertiesTable* LXe_mpt = new G4MaterialPropertiesTable();
 
@@ -708,6 +769,8 @@ namespace opticalprops {
     LXe_mpt->AddConstProperty("SCINTILLATIONYIELD1", .03);
     LXe_mpt->AddConstProperty("SCINTILLATIONYIELD2", .97);
     LXe_mpt->AddConstProperty("ATTACHMENT", 1000.*ms, 1);
+    LXe_mpt->AddConstProperty("IONIZATIONENERGY", 15.6 * eV, 1);
+    LXe_mpt->AddConstProperty("FANOFACTOR", .059, 1);
 
     std::vector<G4double> abs_energy = {optPhotMinE_, optPhotMaxE_};
     std::vector<G4double> abs_length = {noAbsLength_, noAbsLength_};
@@ -719,7 +782,7 @@ namespace opticalprops {
 
     LXe_mpt->AddProperty("RAYLEIGH", rayleigh_energy, rayleigh_length);
 
-    return LXe_mpt;
+    return cached = LXe_mpt;
   }
 
 
@@ -732,6 +795,11 @@ namespace opticalprops {
                                       G4double e_lifetime,
                                       G4double photoe_p)
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("FakeGrid",
+      {pressure, temperature, transparency, thickness,
+       G4double(sc_yield), e_lifetime, photoe_p});
+    if (cached) return cached;
+
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
     // PROPERTIES FROM XENON
@@ -748,6 +816,8 @@ namespace opticalprops {
     mpt->AddConstProperty("SCINTILLATIONYIELD1", xenon_pt->GetConstProperty("SCINTILLATIONYIELD1"));
     mpt->AddConstProperty("SCINTILLATIONYIELD2", xenon_pt->GetConstProperty("SCINTILLATIONYIELD2"));
     mpt->AddConstProperty("ATTACHMENT",         xenon_pt->GetConstProperty("ATTACHMENT"), 1);
+    mpt->AddConstProperty("IONIZATIONENERGY",   xenon_pt->GetConstProperty("IONIZATIONENERGY"), 1);
+    mpt->AddConstProperty("FANOFACTOR",         xenon_pt->GetConstProperty("FANOFACTOR"), 1);
 
     // ABSORPTION LENGTH
     G4double abs_length   = -thickness/log(transparency);
@@ -761,7 +831,7 @@ namespace opticalprops {
     mpt->AddConstProperty("WORK_FUNCTION", stainless_wf, 1);
     mpt->AddConstProperty("OP_PHOTOELECTRIC_PROBABILITY", photoe_p, 1);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -769,6 +839,9 @@ namespace opticalprops {
   /// PTFE (== TEFLON) ///
   G4MaterialPropertiesTable* PTFE()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("PTFE");
+    if (cached) return cached;
+
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
     // REFLECTIVITY
@@ -802,13 +875,16 @@ namespace opticalprops {
     std::vector<G4double> rIndex = {1.41, 1.41};
     mpt->AddProperty("RINDEX", ENERGIES_2, rIndex);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* PolishedAl()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("PolishedAl");
+    if (cached) return cached;
+
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
     std::vector<G4double> ENERGIES = {
@@ -864,7 +940,7 @@ namespace opticalprops {
     // from https://refractiveindex.info/?shelf=3d&book=metals&page=aluminium
     mpt->AddProperty("RINDEX", ENERGIES_3, rIndex);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -872,6 +948,9 @@ namespace opticalprops {
   /// TPB (tetraphenyl butadiene) ///
   G4MaterialPropertiesTable* TPB()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("TPB");
+    if (cached) return cached;
+
     // Data from https://doi.org/10.1140/epjc/s10052-018-5807-z
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
@@ -991,13 +1070,16 @@ namespace opticalprops {
     // to Xe scintillation spectrum peak.
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.65);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* DegradedTPB(G4double wls_eff)
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("DegradedTPB", {wls_eff});
+    if (cached) return cached;
+
     // It has all the same properties of TPB except the WaveLengthShifting probability
     // that is set by parameter, trying to model a degraded behaviour of the TPB coating
 
@@ -1013,7 +1095,7 @@ namespace opticalprops {
     // Except WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", wls_eff);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -1021,6 +1103,9 @@ namespace opticalprops {
   /// TPH (p-terphenyl) ///
   G4MaterialPropertiesTable* TPH()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("TPH");
+    if (cached) return cached;
+
     // Data from https://doi.org/10.1016/j.nima.2011.12.036
     // and https://iopscience.iop.org/article/10.1088/1748-0221/5/04/P04007/
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1105,13 +1190,16 @@ namespace opticalprops {
     // This is set to QE at the Xenon peak, which the paper claims to be >90%
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.9);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* EJ280()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("EJ280");
+    if (cached) return cached;
+
     // https://eljentechnology.com/products/wavelength-shifting-plastics/ej-280-ej-282-ej-284-ej-286
     // and data sheets from the provider.
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1229,13 +1317,16 @@ namespace opticalprops {
     // WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.86);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* EJ286()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("EJ286");
+    if (cached) return cached;
+
     // https://eljentechnology.com/products/wavelength-shifting-plastics/ej-280-ej-282-ej-284-ej-286
     // and data sheets from the provider.
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1353,13 +1444,16 @@ namespace opticalprops {
     // WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.92);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* Y11()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Y11");
+    if (cached) return cached;
+
     // http://kuraraypsf.jp/psf/index.html
     // http://kuraraypsf.jp/psf/ws.html
     // Excel provided by kuraray with Tabulated WLS absorption lengths
@@ -1440,13 +1534,16 @@ namespace opticalprops {
     // WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.87);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* B2()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("B2");
+    if (cached) return cached;
+
     // http://kuraraypsf.jp/psf/index.html
     // http://kuraraypsf.jp/psf/ws.html
     // Excel provided by kuraray with Tabulated WLS absorption lengths
@@ -1548,13 +1645,16 @@ namespace opticalprops {
     // WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 0.87);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* Pethylene()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Pethylene");
+    if (cached) return cached;
+
     // Fiber cladding material.
     // Properties from geant4/examples/extended/optical/wls
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1569,13 +1669,16 @@ namespace opticalprops {
     std::vector<G4double> absLength  = {noAbsLength_, noAbsLength_};
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
 
   G4MaterialPropertiesTable* FPethylene()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("FPethylene");
+    if (cached) return cached;
+
     // Fiber cladding material.
     // Properties from geant4/examples/extended/optical/wls
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1590,7 +1693,7 @@ namespace opticalprops {
     std::vector<G4double> absLength  = {noAbsLength_, noAbsLength_};
     mpt->AddProperty("ABSLENGTH", abs_energy, absLength);
 
-    return mpt;
+    return cached = mpt;
   }
 
 
@@ -1598,6 +1701,9 @@ namespace opticalprops {
   /// PMMA == PolyMethylmethacrylate ///
   G4MaterialPropertiesTable* PMMA()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("PMMA");
+    if (cached) return cached;
+
     // Fiber cladding material.
     // Properties from geant4/examples/extended/optical/wls
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -1622,12 +1728,15 @@ namespace opticalprops {
     };
     mpt->AddProperty("ABSLENGTH", abs_energy, abslength);
 
-    return mpt;
+    return cached = mpt;
   }
 
   // Copper Optical Properties Table
   G4MaterialPropertiesTable * Copper()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Copper");
+    if (cached) return cached;
+
        G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
       // Reflectivity
@@ -1649,12 +1758,15 @@ namespace opticalprops {
       mpt->AddProperty("SPECULARSPIKECONSTANT",{optPhotMinE_, optPhotMaxE_}, {0.75, 0.75});
       mpt->AddProperty("BACKSCATTERCONSTANT",  {optPhotMinE_, optPhotMaxE_}, {0., 0.});
       mpt->AddProperty("REFLECTIVITY", refl_energies, reflectivities);
-      return mpt;
+      return cached = mpt;
   }
 
   // Stainles Steel Optical Properties Table
   G4MaterialPropertiesTable * Steel()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("Steel");
+    if (cached) return cached;
+
       G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
       // Reflectivity
@@ -1674,12 +1786,15 @@ namespace opticalprops {
       mpt->AddProperty("SPECULARSPIKECONSTANT",{optPhotMinE_, optPhotMaxE_}, {0.75, 0.75});
       mpt->AddProperty("BACKSCATTERCONSTANT",  {optPhotMinE_, optPhotMaxE_}, {0., 0.});
       mpt->AddProperty("REFLECTIVITY", refl_energies, reflectivities);
-      return mpt;
+      return cached = mpt;
   }
 
   /// Generic material, to be modifed by the user ///
   G4MaterialPropertiesTable* XXX()
   {
+    G4MaterialPropertiesTable*& cached = CachedTable("XXX");
+    if (cached) return cached;
+
     // Playing material properties
     G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
@@ -1709,6 +1824,6 @@ namespace opticalprops {
     // WLS Quantum Efficiency
     mpt->AddConstProperty("WLSMEANNUMBERPHOTONS", 1.);
 
-    return mpt;
+    return cached = mpt;
   }
 }
@@ -8,12 +8,17 @@
 
 #include "XenonProperties.h"
 #include "Interpolation.h"
+#include "Table2D.h"
 
 #include <G4SystemOfUnits.hh>
 #include <G4PhysicalConstants.hh>
 #include <G4AnalyticalPolSolver.hh>
 #include <G4MaterialPropertiesTable.hh>
 
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
 using namespace nexus;
 
 
@@ -255,7 +260,8 @@ std::pair<G4int, G4int> MakeXeDensityDataTable(std::vector<std::vector<G4double>
   std::ifstream inFile;
   inFile.open(filename);
   if (!inFile) {
-    throw "File could not be opened";
+    G4Exception("[XenonProperties]", "MakeXeDensityDataTable()", FatalException,
+                ("File " + filename + " could not be opened").c_str());
   }
 
   // Read lines in file
@@ -282,8 +288,6 @@ std::pair<G4int, G4int> MakeXeDensityDataTable(std::vector<std::vector<G4double>
     }
   }
 
-  npressures = npressures-1;
-
   inFile.close();
 
   std::pair<G4int, G4int> nkeys = std::make_pair(npressures, ntemps);
@@ -292,94 +296,63 @@ std::pair<G4int, G4int> MakeXeDensityDataTable(std::vector<std::vector<G4double>
 }
 
 
-G4double GetGasDensity(G4double pressure, G4double temperature)
-{
-  // Interpolate to calculate the density
-  // at a given pressure and temperature
-  G4double density = 5.324 * kg/m3;
-  std::vector<std::vector<G4double>> data;
-  std::pair<G4int, G4int> nkeys = MakeXeDensityDataTable(data);
-  G4int npressures = nkeys.first;
-  G4int ntemps     = nkeys.second;
+namespace {
 
-  // Find correct interval and use bilinear interpolation
-  G4bool found = false;
-  G4int tcount = 0;
-  G4int pcount = 0;
-  G4int count = 0;
-  G4double t1, t2, p1, p2, d11, d12, d21, d22, d1, d2;
-
-  while (tcount < ntemps-1) {
-    t1 = data[count][0];
-    t2 = data[count+npressures][0];
-
-    if (temperature >= t1 && temperature < t2) {
-      while (pcount < npressures-1) {
-        p1 = data[count][1];
-        p2 = data[count+1][1];
-
-        if (pressure >= p1 && pressure < p2) {
-          d11 = data[count][2];
-          d12 = data[count+1][2];
-          d21 = data[count+npressures][2];
-          d22 = data[count+npressures+1][2];
-
-          density = BilinearInterpolation(temperature, t1, t2,
-            pressure, p1, p2,
-            d11, d12, d21, d22);
-            found = true;
-            break;
-        }
-        pcount++;
-        count++;
+  // Density table read from file the first time it is needed.
+  // The rows of the file must form a regular grid, with the
+  // pressure running fastest.
+  const Table2D& XeDensityTable()
+  {
+    static const Table2D table = [] {
+      std::vector<std::vector<G4double>> data;
+      std::pair<G4int, G4int> nkeys = MakeXeDensityDataTable(data);
+      G4int npressures = nkeys.first;
+      G4int ntemps     = nkeys.second;
+
+      if (npressures < 2 || ntemps < 2 ||
+          data.size() != std::size_t(npressures * ntemps)) {
+        G4Exception("[XenonProperties]", "XeDensityTable()", FatalException,
+                    "Xenon density table is not a regular grid");
       }
 
-      if (!found) {
-        if (pressure == data[count][1]) {
-          d1 = data[count][2];
-          d2 = data[count+npressures][2];
-          density = LinearInterpolation(temperature, t1, t2, d1, d2);
-          found = true;
-        } else {
-          throw "Unknown xenon density for this pressure!";
+      const G4double t0 = data[0][0];
+      const G4double p0 = data[0][1];
+      const G4double t1 = data.back()[0];
+      const G4double p1 = data.back()[1];
+      const G4double dt = (t1 - t0) / (ntemps - 1);
+      const G4double dp = (p1 - p0) / (npressures - 1);
+
+      std::vector<G4double> density(data.size());
+      for (std::size_t k=0; k<data.size(); ++k) {
+        G4int it = k / npressures;
+        G4int ip = k % npressures;
+        if (std::abs(data[k][0] - (t0 + it * dt)) > 1.e-3 * dt ||
+            std::abs(data[k][1] - (p0 + ip * dp)) > 1.e-3 * dp) {
+          G4Exception("[XenonProperties]", "XeDensityTable()", FatalException,
+                      "Xenon density table is not a regular grid");
         }
+        density[k] = data[k][2];
       }
 
-      break;
-    }
-    tcount++;
-    pcount = 0;
-    count += npressures;
-  }
+      return Table2D(t0, t1, ntemps, p0, p1, npressures, density);
+    }();
 
-  if (!found) {
-    if (temperature == data[count][0]) {
-      while (pcount< npressures-1) {
-        p1 = data[count][1];
-        p2 = data[count+1][1];
-
-        if (pressure >= p1 && pressure < p2){
-          d1 = data[count][2];
-          d2 = data[count+1][2];
-
-          density = LinearInterpolation(pressure, p1, p2, d1, d2);
-          found = true;
-          break;
-        }
-        pcount++;
-        count++;
-      }
-      if (!found) {
-        if (pressure == data[count][1]) {
-          density = data[count][2];
-          found = true;
-        } else {
-          throw "Unknown xenon density for this pressure!";
-        }
-      }
-    } else {
-        throw "Unknown xenon density for this temperature";
-    }
+    return table;
   }
-  return density;
+
+}
+
+
+G4double GetGasDensity(G4double pressure, G4double temperature)
+{
+  // Bilinear interpolation in the table of densities
+  // at a given pressure and temperature
+  const Table2D& table = XeDensityTable();
+
+  if (!table.InRangeY(pressure))
+    throw std::out_of_range("Unknown xenon density for this pressure");
+  if (!table.InRangeX(temperature))
+    throw std::out_of_range("Unknown xenon density for this temperature");
+
+  return table.Interpolate(temperature, pressure);
 }
@@ -24,7 +24,11 @@ G4double XenonRefractiveIndex(G4double energy, G4double density);
 G4double GXeScintillation(G4double energy, G4double pressure);
 G4double LXeScintillation(G4double energy);
 
+/// Read the table of xenon gas densities from file. Returns the
+/// number of pressures (per temperature) and temperatures in it.
 std::pair<G4int, G4int> MakeXeDensityDataTable(std::vector<std::vector<G4double>> &data);
+/// Density of xenon gas interpolated in the table read once from file.
+/// Throws std::out_of_range for pressures or temperatures outside it.
 G4double GetGasDensity(G4double pressure, G4double temperature);
 
 /// Electroluminescence yield of pure xenon gas
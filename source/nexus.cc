@@ -8,6 +8,8 @@
 
 #include "NexusApp.h"
 #include "NexusExceptionHandler.h"
+#include "BinaryReader.h"
+#include "HDF5Writer.h"
 
 #include <G4StateManager.hh>
 #include <G4UImanager.hh>
@@ -22,18 +24,45 @@ using namespace nexus;
 
 void PrintUsage()
 {
-  G4cerr  << "\nUsage: ./nexus [-b|i] [-n number] <init_macro>\n" << G4endl;
+  G4cerr  << "\nUsage: ./nexus [-b|i] [-n number] <init_macro>\n"
+          << "       ./nexus -c <binary_output_file>\n" << G4endl;
   G4cerr  << "Available options:" << G4endl;
   G4cerr  << "   -b, --batch           : Run in batch mode (default)\n"
           << "   -i, --interactive     : Run in interactive mode\n"
           << "   -o, --overlap-check   : Turn warnings into exceptions and increase precision in overlap check\n"
           << "   -n, --nevents         : Number of events to simulate\n"
-          << "   -p, --precision       : Number of significant figures in verbosity"
+          << "   -p, --precision       : Number of significant figures in verbosity\n"
+          << "   -c, --convert         : Convert a binary output file to HDF5 and exit"
           << G4endl;
   exit(EXIT_FAILURE);
 }
 
 
+G4int ConvertToHDF5(G4String filename)
+{
+  // The HDF5 file has the same name, with the .h5 extension
+  HDF5Writer writer;
+  G4String output = filename;
+  if (output.size() > 4 && output.substr(output.size() - 4) == ".bin")
+    output.erase(output.size() - 4);
+  output += writer.GetExtension();
+
+  BinaryReader reader;
+  if (!reader.Open(filename)) {
+    G4cerr << filename << " is not a nexus binary output file" << G4endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!reader.Convert(writer, output)) {
+    G4cerr << filename << " is truncated or corrupt; the records before "
+           << "the first bad one have been written to " << output << G4endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
 G4int main(int argc, char** argv)
 {
   ////////////////////////////////////////////////////////////////////
@@ -47,6 +76,7 @@ G4int main(int argc, char** argv)
   G4bool overlap_check = false;
   G4int nevents = 0;
   G4int precision = -1;
+  G4String convert_filename = "";
 
   static struct option long_options[] =
   {
@@ -55,6 +85,7 @@ G4int main(int argc, char** argv)
     {"overlaps",    no_argument,       0, 'o'},
     {"precision",   required_argument, 0, 'p'},
     {"nevents",     required_argument, 0, 'n'},
+    {"convert",     required_argument, 0, 'c'},
     {0, 0, 0, 0}
   };
 
@@ -64,7 +95,7 @@ G4int main(int argc, char** argv)
 
     //  int option_index = 0;
     opterr = 0;
-    c = getopt_long(argc, argv, "biop:n:", long_options, 0);
+    c = getopt_long(argc, argv, "biop:n:c:", long_options, 0);
 
     if (c==-1) break; // Exit if we are done reading options
 
@@ -90,6 +121,10 @@ G4int main(int argc, char** argv)
         nevents = atoi(optarg);
         break;
 
+      case 'c':
+        convert_filename = optarg;
+        break;
+
       case '?':
         break;
 
@@ -98,6 +133,9 @@ G4int main(int argc, char** argv)
     }
   }
 
+  // The conversion of a binary output file needs no macro
+  if (convert_filename != "") return ConvertToHDF5(convert_filename);
+
   // If there is no other command-line argument to be processed, abort
   // because the user has not provided a configuration macro.
   // (The variable optind is set by getopt_long to the index of the next
@@ -0,0 +1,290 @@
+// ----------------------------------------------------------------------------
+// nexus | BinaryReader.cc
+//
+// This class reads the binary output files written by BinaryWriter and
+// converts them to any other output format (e.g. HDF5).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+
+#include <cstring>
+
+using namespace nexus;
+
+
+BinaryReader::BinaryReader():
+  options_{false, false, false, false, false}, cursor_(0), overrun_(false)
+{
+}
+
+BinaryReader::~BinaryReader()
+{
+  Close();
+}
+
+bool BinaryReader::Open(std::string fileName)
+{
+  Close();
+
+  file_.open(fileName, std::ios::in | std::ios::binary);
+  if (!file_) return false;
+
+  char magic[8];
+  uint32_t version = 0;
+  file_.read(magic, sizeof(magic));
+  file_.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!file_ || std::memcmp(magic, "NEXUSBIN", 8) != 0 ||
+      version != BinaryWriter::kVersion) {
+    Close();
+    return false;
+  }
+
+  char options[5];
+  file_.read(options, 5);
+  if (!file_) {
+    Close();
+    return false;
+  }
+  for (size_t i=0; i<5; i++) options_[i] = options[i];
+
+  return true;
+}
+
+void BinaryReader::Close()
+{
+  if (file_.is_open()) file_.close();
+  file_.clear();
+}
+
+bool BinaryReader::NextRecord(uint8_t& type)
+{
+  uint32_t size;
+  file_.read(reinterpret_cast<char*>(&type), sizeof(type));
+  file_.read(reinterpret_cast<char*>(&size), sizeof(size));
+  if (!file_) return false;
+
+  record_.resize(size);
+  file_.read(record_.data(), size);
+  cursor_  = 0;
+  overrun_ = false;
+  return (bool)file_;
+}
+
+template <typename T>
+T BinaryReader::Get()
+{
+  T value{};
+  if (cursor_ + sizeof(T) > record_.size()) {
+    overrun_ = true;
+    return value;
+  }
+  std::memcpy(&value, record_.data() + cursor_, sizeof(T));
+  cursor_ += sizeof(T);
+  return value;
+}
+
+std::string BinaryReader::GetString()
+{
+  uint16_t length = Get<uint16_t>();
+  if (cursor_ + length > record_.size()) {
+    overrun_ = true;
+    return "";
+  }
+  std::string str(record_.data() + cursor_, length);
+  cursor_ += length;
+  return str;
+}
+
+bool BinaryReader::Convert(WriterBase& writer, std::string output_filename)
+{
+  writer.Open(output_filename, GetDebug(), GetSaveStr(), GetLightTable(),
+              GetSparseSns(), GetEventInfo());
+
+  bool ok = true;
+  uint8_t type;
+  while (file_.peek() != std::char_traits<char>::eof()) {
+    if (!NextRecord(type) || !Replay(type, writer)) {
+      ok = false;
+      break;
+    }
+  }
+
+  writer.Close();
+  return ok;
+}
+
+bool BinaryReader::Replay(uint8_t type, WriterBase& writer)
+{
+  const bool str = GetSaveStr();
+
+  switch (type) {
+
+  case BinaryWriter::kRunInfo: {
+    std::string key   = GetString();
+    std::string value = GetString();
+    if (overrun_) return false;
+    writer.WriteRunInfo(key.c_str(), value.c_str());
+    break;
+  }
+
+  case BinaryWriter::kSensorData: {
+    int64_t evt_number     = Get<int64_t>();
+    unsigned int sensor_id = Get<unsigned int>();
+    unsigned int time_bin  = Get<unsigned int>();
+    unsigned int charge    = Get<unsigned int>();
+    if (overrun_) return false;
+    writer.WriteSensorDataInfo(evt_number, sensor_id, time_bin, charge);
+    break;
+  }
+
+  case BinaryWriter::kSensorWaveform: {
+    unsigned int sensor_id = Get<unsigned int>();
+    unsigned int nbins     = Get<unsigned int>();
+    if (overrun_ || record_.size() - cursor_ != 2 * sizeof(unsigned int) * (size_t)nbins)
+      return false;
+    std::vector<std::pair<unsigned int, float>> data(nbins);
+    for (auto& bin: data) {
+      bin.first  = Get<unsigned int>();
+      bin.second = Get<unsigned int>();
+    }
+    writer.WriteSensorWaveform(sensor_id, data);
+    break;
+  }
+
+  case BinaryWriter::kSensorEvent: {
+    int64_t evt_number = Get<int64_t>();
+    if (overrun_) return false;
+    writer.WriteSensorEvent(evt_number);
+    break;
+  }
+
+  case BinaryWriter::kHitInfo: {
+    int64_t evt_number = Get<int64_t>();
+    int particle_indx  = Get<int>();
+    int hit_indx       = Get<int>();
+    float x      = Get<float>();
+    float y      = Get<float>();
+    float z      = Get<float>();
+    float time   = Get<float>();
+    float energy = Get<float>();
+    std::string label_str = str ? GetString() : "";
+    int label = str ? 0 : Get<int>();
+    if (overrun_) return false;
+    writer.WriteHitInfo(str, evt_number, particle_indx, hit_indx, x, y, z,
+                        time, energy, label_str.c_str(), label);
+    break;
+  }
+
+  case BinaryWriter::kParticleInfo: {
+    int64_t evt_number = Get<int64_t>();
+    int particle_indx  = Get<int>();
+    std::string name_str = str ? GetString() : "";
+    int name = str ? 0 : Get<int>();
+    char primary  = Get<char>();
+    int mother_id = Get<int>();
+    float vertex[8];
+    for (float& v: vertex) v = Get<float>();
+    std::string ini_vol_str = str ? GetString() : "";
+    std::string fin_vol_str = str ? GetString() : "";
+    int ini_vol = str ? 0 : Get<int>();
+    int fin_vol = str ? 0 : Get<int>();
+    float momentum[6];
+    for (float& p: momentum) p = Get<float>();
+    float kin_energy = Get<float>();
+    float length     = Get<float>();
+    std::string creator_str = str ? GetString() : "";
+    std::string final_str   = str ? GetString() : "";
+    int creator = str ? 0 : Get<int>();
+    int final   = str ? 0 : Get<int>();
+    if (overrun_) return false;
+    writer.WriteParticleInfo(str, evt_number, particle_indx, name_str.c_str(),
+                             name, primary, mother_id,
+                             vertex[0], vertex[1], vertex[2], vertex[3],
+                             vertex[4], vertex[5], vertex[6], vertex[7],
+                             ini_vol_str.c_str(), fin_vol_str.c_str(),
+                             ini_vol, fin_vol,
+                             momentum[0], momentum[1], momentum[2],
+                             momentum[3], momentum[4], momentum[5],
+                             kin_energy, length,
+                             creator_str.c_str(), final_str.c_str(),
+                             creator, final);
+    break;
+  }
+
+  case BinaryWriter::kSensorPos: {
+    unsigned int sensor_id = Get<unsigned int>();
+    std::string name = GetString();
+    float x = Get<float>();
+    float y = Get<float>();
+    float z = Get<float>();
+    if (overrun_) return false;
+    writer.WriteSensorPosInfo(sensor_id, name.c_str(), x, y, z);
+    break;
+  }
+
+  case BinaryWriter::kStep: {
+    int64_t evt_number = Get<int64_t>();
+    int particle_id    = Get<int>();
+    std::string particle_name = GetString();
+    int step_id        = Get<int>();
+    std::string initial_volume = GetString();
+    std::string final_volume   = GetString();
+    std::string proc_name      = GetString();
+    float point[7];
+    for (float& v: point) v = Get<float>();
+    if (overrun_) return false;
+    writer.WriteStep(evt_number, particle_id, particle_name.c_str(), step_id,
+                     initial_volume.c_str(), final_volume.c_str(),
+                     proc_name.c_str(), point[0], point[1], point[2],
+                     point[3], point[4], point[5], point[6]);
+    break;
+  }
+
+  case BinaryWriter::kStringMap: {
+    std::string name = GetString();
+    int name_id = Get<int>();
+    if (overrun_) return false;
+    writer.WriteStringMapInfo(name.c_str(), name_id);
+    break;
+  }
+
+  case BinaryWriter::kLightTablePoint: {
+    unsigned int point_id = Get<unsigned int>();
+    float x = Get<float>();
+    float y = Get<float>();
+    float z = Get<float>();
+    uint64_t nphotons = Get<uint64_t>();
+    if (overrun_) return false;
+    writer.WriteLightTablePoint(point_id, x, y, z, nphotons);
+    break;
+  }
+
+  case BinaryWriter::kLightTableProb: {
+    unsigned int point_id  = Get<unsigned int>();
+    unsigned int sensor_id = Get<unsigned int>();
+    uint64_t charge        = Get<uint64_t>();
+    float probability      = Get<float>();
+    if (overrun_) return false;
+    writer.WriteLightTableProb(point_id, sensor_id, charge, probability);
+    break;
+  }
+
+  case BinaryWriter::kEventInfo: {
+    int64_t evt_number = Get<int64_t>();
+    char selected      = Get<char>();
+    uint64_t seed      = Get<uint64_t>();
+    if (overrun_) return false;
+    writer.WriteEventInfo(evt_number, selected, seed);
+    break;
+  }
+
+  default:
+    return false;
+  }
+
+  // The payload must have been used up
+  return cursor_ == record_.size();
+}
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | BinaryReader.h
+//
+// This class reads the binary output files written by BinaryWriter and
+// converts them to any other output format (e.g. HDF5).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BINARY_READER_H
+#define BINARY_READER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  class WriterBase;
+
+  /// The format of the file is described in BinaryWriter.h. The records
+  /// are replayed, in the order they were written, as calls to the same
+  /// Write methods of another writer, which is thus given the same
+  /// output as if it had been used in the job.
+
+  class BinaryReader {
+
+  public:
+    /// constructor
+    BinaryReader();
+    /// destructor
+    ~BinaryReader();
+
+    /// open file, returning false if it is not a nexus binary file
+    /// of a known version
+    bool Open(std::string filename);
+
+    /// close file
+    void Close();
+
+    /// options of the job that wrote the file
+    bool GetDebug()      const;
+    bool GetSaveStr()    const;
+    bool GetLightTable() const;
+    bool GetSparseSns()  const;
+    bool GetEventInfo()  const;
+
+    /// Open the output file of the writer with the options of the job
+    /// and make the Write calls of all the records. Returns false if a
+    /// record is truncated or corrupt; the records before it are
+    /// converted anyway.
+    bool Convert(WriterBase& writer, std::string output_filename);
+
+  private:
+    /// Read the payload of the next record, returning false at the
+    /// end of the file or if the record is truncated
+    bool NextRecord(uint8_t& type);
+    /// Replay the current record
+    bool Replay(uint8_t type, WriterBase& writer);
+
+    /// Read a field of the payload of the current record
+    template <typename T> T Get();
+    std::string GetString();
+
+  private:
+    std::ifstream file_; ///< input file
+
+    bool options_[5]; ///< debug, save_str, light_table, sparse_sns, event_info
+
+    std::vector<char> record_; ///< payload of the current record
+    size_t cursor_;            ///< position of the next field in the payload
+    bool overrun_;             ///< a field went past the end of the payload
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline bool BinaryReader::GetDebug()      const { return options_[0]; }
+  inline bool BinaryReader::GetSaveStr()    const { return options_[1]; }
+  inline bool BinaryReader::GetLightTable() const { return options_[2]; }
+  inline bool BinaryReader::GetSparseSns()  const { return options_[3]; }
+  inline bool BinaryReader::GetEventInfo()  const { return options_[4]; }
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,273 @@
+// ----------------------------------------------------------------------------
+// nexus | BinaryWriter.cc
+//
+// This class writes the nexus output as a flat stream of binary records,
+// to be converted offline. It avoids the overhead of HDF5 in high-rate
+// production jobs.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "BinaryWriter.h"
+
+#include <G4Exception.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+using namespace nexus;
+
+
+namespace {
+  // Size of the buffer of the file stream
+  const size_t buffer_size = 1 << 20;
+}
+
+
+BinaryWriter::BinaryWriter():
+  stream_buffer_(buffer_size), isOpen_(false)
+{
+}
+
+BinaryWriter::~BinaryWriter()
+{
+  Close();
+}
+
+std::string BinaryWriter::GetExtension() const
+{
+  return ".bin";
+}
+
+void BinaryWriter::Open(std::string fileName, bool debug, bool save_str,
+                        bool light_table, bool sparse_sns, bool event_info)
+{
+  // The buffer must be set before the file is opened
+  file_.rdbuf()->pubsetbuf(stream_buffer_.data(), stream_buffer_.size());
+  file_.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if (!file_) {
+    G4Exception("[BinaryWriter]", "Open()", FatalException,
+                ("Cannot open output file " + fileName).c_str());
+  }
+
+  file_.write("NEXUSBIN", 8);
+  uint32_t version = kVersion;
+  file_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  char options[5] = {debug, save_str, light_table, sparse_sns, event_info};
+  file_.write(options, sizeof(options));
+
+  isOpen_ = true;
+}
+
+void BinaryWriter::Close()
+{
+  if (!isOpen_) return;
+
+  isOpen_ = false;
+  file_.close();
+}
+
+std::string BinaryWriter::Checkpoint()
+{
+  file_.flush();
+  return std::to_string((std::streamoff)file_.tellp());
+}
+
+void BinaryWriter::Resume(std::string fileName, bool, bool, bool, bool, bool,
+                          const std::string& position)
+{
+  // The records written after the checkpoint are dropped
+  std::error_code error;
+  std::filesystem::resize_file(fileName, std::stoull(position), error);
+
+  file_.rdbuf()->pubsetbuf(stream_buffer_.data(), stream_buffer_.size());
+  if (!error)
+    file_.open(fileName, std::ios::out | std::ios::binary | std::ios::app);
+
+  if (error || !file_) {
+    G4Exception("[BinaryWriter]", "Resume()", FatalException,
+                ("Cannot resume output file " + fileName).c_str());
+  }
+
+  isOpen_ = true;
+}
+
+void BinaryWriter::PutString(const char* str)
+{
+  uint16_t length = std::min(strlen(str), (size_t)UINT16_MAX);
+  Put(length);
+  record_.insert(record_.end(), str, str + length);
+}
+
+void BinaryWriter::WriteRecord(RecordType type)
+{
+  uint32_t size = record_.size();
+  file_.put(type);
+  file_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file_.write(record_.data(), record_.size());
+  record_.clear();
+}
+
+void BinaryWriter::WriteRunInfo(const char* param_key, const char* param_value)
+{
+  PutString(param_key);
+  PutString(param_value);
+  WriteRecord(kRunInfo);
+}
+
+void BinaryWriter::WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge)
+{
+  Put(evt_number);
+  Put(sensor_id);
+  Put(time_bin);
+  Put(charge);
+  WriteRecord(kSensorData);
+}
+
+void BinaryWriter::WriteSensorWaveform(unsigned int sensor_id, const std::vector<std::pair<unsigned int, float>>& data)
+{
+  if (data.empty()) return;
+
+  Put(sensor_id);
+  Put((unsigned int)data.size());
+  for (const auto& bin: data) {
+    Put(bin.first);
+    Put((unsigned int)(bin.second + 0.5));
+  }
+  WriteRecord(kSensorWaveform);
+}
+
+void BinaryWriter::WriteSensorEvent(int64_t evt_number)
+{
+  Put(evt_number);
+  WriteRecord(kSensorEvent);
+}
+
+void BinaryWriter::WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label)
+{
+  Put(evt_number);
+  Put(particle_indx);
+  Put(hit_indx);
+  Put(hit_position_x);
+  Put(hit_position_y);
+  Put(hit_position_z);
+  Put(hit_time);
+  Put(hit_energy);
+  if (str) PutString(label_str);
+  else     Put(label);
+  WriteRecord(kHitInfo);
+}
+
+void BinaryWriter::WriteParticleInfo(bool str, int64_t evt_number, int particle_indx, const char* particle_name_str, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume_str, const char* final_volume_str, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc_str, const char* final_proc_str, int creator_proc, int final_proc)
+{
+  Put(evt_number);
+  Put(particle_indx);
+  if (str) PutString(particle_name_str);
+  else     Put(particle_name);
+  Put(primary);
+  Put(mother_id);
+  Put(initial_vertex_x);
+  Put(initial_vertex_y);
+  Put(initial_vertex_z);
+  Put(initial_vertex_t);
+  Put(final_vertex_x);
+  Put(final_vertex_y);
+  Put(final_vertex_z);
+  Put(final_vertex_t);
+  if (str) {
+    PutString(initial_volume_str);
+    PutString(final_volume_str);
+  } else {
+    Put(initial_volume);
+    Put(final_volume);
+  }
+  Put(ini_momentum_x);
+  Put(ini_momentum_y);
+  Put(ini_momentum_z);
+  Put(final_momentum_x);
+  Put(final_momentum_y);
+  Put(final_momentum_z);
+  Put(kin_energy);
+  Put(length);
+  if (str) {
+    PutString(creator_proc_str);
+    PutString(final_proc_str);
+  } else {
+    Put(creator_proc);
+    Put(final_proc);
+  }
+  WriteRecord(kParticleInfo);
+}
+
+void BinaryWriter::WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z)
+{
+  Put(sensor_id);
+  PutString(sensor_name);
+  Put(x);
+  Put(y);
+  Put(z);
+  WriteRecord(kSensorPos);
+}
+
+void BinaryWriter::WriteStep(int64_t evt_number,
+                             int particle_id, const char* particle_name,
+                             int step_id,
+                             const char* initial_volume,
+                             const char*   final_volume,
+                             const char*      proc_name,
+                             float initial_x, float initial_y, float initial_z,
+                             float   final_x, float   final_y, float   final_z,
+                             float time)
+{
+  Put(evt_number);
+  Put(particle_id);
+  PutString(particle_name);
+  Put(step_id);
+  PutString(initial_volume);
+  PutString(final_volume);
+  PutString(proc_name);
+  Put(initial_x);
+  Put(initial_y);
+  Put(initial_z);
+  Put(final_x);
+  Put(final_y);
+  Put(final_z);
+  Put(time);
+  WriteRecord(kStep);
+}
+
+void BinaryWriter::WriteStringMapInfo(const char* name, int name_id)
+{
+  PutString(name);
+  Put(name_id);
+  WriteRecord(kStringMap);
+}
+
+void BinaryWriter::WriteLightTablePoint(unsigned int point_id, float x, float y, float z, uint64_t nphotons)
+{
+  Put(point_id);
+  Put(x);
+  Put(y);
+  Put(z);
+  Put(nphotons);
+  WriteRecord(kLightTablePoint);
+}
+
+void BinaryWriter::WriteLightTableProb(unsigned int point_id, unsigned int sensor_id, uint64_t charge, float probability)
+{
+  Put(point_id);
+  Put(sensor_id);
+  Put(charge);
+  Put(probability);
+  WriteRecord(kLightTableProb);
+}
+
+void BinaryWriter::WriteEventInfo(int64_t evt_number, char selected, uint64_t seed)
+{
+  Put(evt_number);
+  Put(selected);
+  Put(seed);
+  WriteRecord(kEventInfo);
+}
@@ -0,0 +1,117 @@
+// ----------------------------------------------------------------------------
+// nexus | BinaryWriter.h
+//
+// This class writes the nexus output as a flat stream of binary records,
+// to be converted offline. It avoids the overhead of HDF5 in high-rate
+// production jobs.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BINARY_WRITER_H
+#define BINARY_WRITER_H
+
+#include "WriterBase.h"
+
+#include <fstream>
+#include <vector>
+
+namespace nexus {
+
+  /// The file starts with the 8 characters "NEXUSBIN", the format version
+  /// (uint32) and the options of the job (5 bytes: debug, save_str,
+  /// light_table, sparse_sns, event_info). Then comes one record per
+  /// call to the Write methods: record type (uint8), payload size in
+  /// bytes (uint32) and payload. The fields of the payload are those
+  /// of the method, in the same order, with native byte order and
+  /// sizes (char 1, int and float 4, int64_t 8). Strings are stored as
+  /// their length (uint16) followed by their characters. The volume,
+  /// particle and process names are strings if save_str is set and
+  /// ints otherwise. The files are read back and converted by
+  /// BinaryReader.
+
+  class BinaryWriter: public WriterBase {
+
+  public:
+    /// Record types
+    enum RecordType: uint8_t {
+      kRunInfo = 1, kSensorData, kSensorWaveform, kSensorEvent,
+      kHitInfo, kParticleInfo, kSensorPos, kStep, kStringMap,
+      kLightTablePoint, kLightTableProb, kEventInfo
+    };
+
+    static const uint32_t kVersion = 1;
+
+    /// constructor
+    BinaryWriter();
+    /// destructor
+    ~BinaryWriter();
+
+    std::string GetExtension() const override;
+
+    /// open file
+    void Open(std::string filename, bool debug, bool save_str,
+              bool light_table=false, bool sparse_sns=false,
+              bool event_info=false) override;
+
+    /// close file
+    void Close() override;
+
+    /// The position is the size of the file in bytes. As the file is
+    /// only appended to, it can be resumed after any crash
+    std::string Checkpoint() override;
+    void Resume(std::string filename, bool debug, bool save_str,
+                bool light_table, bool sparse_sns, bool event_info,
+                const std::string& position) override;
+
+    void WriteRunInfo(const char* param_key, const char* param_value) override;
+    void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge) override;
+    /// Written as the sensor ID, the number of bins and the
+    /// (time bin, charge) pairs, both as unsigned ints
+    void WriteSensorWaveform(unsigned int sensor_id, const std::vector<std::pair<unsigned int, float>>& data) override;
+    void WriteSensorEvent(int64_t evt_number) override;
+    void WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label) override;
+    void WriteParticleInfo(bool str, int64_t evt_number, int particle_indx, const char* particle_name_str, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume_str, const char* final_volume_str, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc_str, const char* final_proc_str, int creator_proc, int final_proc) override;
+    void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z) override;
+    void WriteStep(int64_t evt_number,
+                   int particle_id, const char* particle_name,
+                   int step_id,
+                   const char* initial_volume,
+                   const char*   final_volume,
+                   const char*      proc_name,
+                   float initial_x, float initial_y, float initial_z,
+                   float   final_x, float   final_y, float   final_z,
+                   float time) override;
+    void WriteStringMapInfo(const char* name, int name_id) override;
+    void WriteLightTablePoint(unsigned int point_id, float x, float y, float z, uint64_t nphotons) override;
+    void WriteLightTableProb(unsigned int point_id, unsigned int sensor_id, uint64_t charge, float probability) override;
+    void WriteEventInfo(int64_t evt_number, char selected, uint64_t seed) override;
+
+  private:
+    /// Append a field to the payload of the current record
+    template <typename T> void Put(T value);
+    void PutString(const char* str);
+    /// Write the current record to the file
+    void WriteRecord(RecordType type);
+
+  private:
+    std::ofstream file_; ///< output file
+    std::vector<char> stream_buffer_; ///< buffer of the file stream
+    std::vector<char> record_; ///< payload of the current record
+
+    bool isOpen_;
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  template <typename T>
+  inline void BinaryWriter::Put(T value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    record_.insert(record_.end(), bytes, bytes + sizeof(T));
+  }
+
+} // namespace nexus
+
+#endif
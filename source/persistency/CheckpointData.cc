@@ -0,0 +1,120 @@
+// ----------------------------------------------------------------------------
+// nexus | CheckpointData.cc
+//
+// State of the persistency manager saved in the checkpoint of an output
+// file, to resume an interrupted job.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "CheckpointData.h"
+
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+using namespace nexus;
+
+
+void CheckpointData::Write(std::ostream& out) const
+{
+  out << std::setprecision(std::numeric_limits<G4double>::max_digits10);
+
+  out << "events " << events << "\n"
+      << "options " << store_steps << " " << save_str << " "
+      << light_table << " " << sparse_sns << " " << start_id << " "
+      << output_format << " " << save_rejected << " "
+      << event_seeding << "\n"
+      << "run_seed " << run_seed << "\n"
+      << "writer " << writer_position << "\n"
+      << "nevt " << nevt << " " << first_evt << "\n"
+      << "counters " << saved_evts << " " << interacting_evts << " "
+      << str_counter << "\n";
+
+  for (const auto& str: str_map)
+    out << "string " << str.second << " " << str.first << "\n";
+
+  for (const auto& id: sensors)
+    out << "sensor " << id << "\n";
+
+  for (const auto& bin: sensdet_bin)
+    out << "binning " << bin.second << " " << bin.first << "\n";
+
+  for (size_t i=0; i<lt_points.size(); ++i) {
+    out << "lt_point " << lt_points[i].x() << " " << lt_points[i].y() << " "
+        << lt_points[i].z() << " " << lt_nphotons[i] << "\n";
+    for (const auto& sns: lt_charge[i])
+      out << "lt_charge " << i << " " << sns.first << " " << sns.second << "\n";
+  }
+
+  for (const auto& vol: absorbed)
+    out << "absorbed " << vol.second << " " << vol.first << "\n";
+
+  // The random engine goes last, as its status takes several lines
+  out << "engine\n" << engine_state;
+}
+
+
+G4bool CheckpointData::Read(std::istream& in)
+{
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream iss(line);
+    std::string key, name;
+    iss >> key;
+
+    if (key == "events") {
+      iss >> events;
+    } else if (key == "options") {
+      iss >> store_steps >> save_str >> light_table >> sparse_sns >> start_id
+          >> output_format >> save_rejected >> event_seeding;
+    } else if (key == "run_seed") {
+      iss >> run_seed;
+    } else if (key == "writer") {
+      std::getline(iss >> std::ws, writer_position);
+    } else if (key == "nevt") {
+      iss >> nevt >> first_evt;
+    } else if (key == "counters") {
+      iss >> saved_evts >> interacting_evts >> str_counter;
+    } else if (key == "string") {
+      G4int id;
+      iss >> id >> std::ws;
+      std::getline(iss, name);
+      str_map[name] = id;
+    } else if (key == "sensor") {
+      G4int id;
+      iss >> id;
+      sensors.push_back(id);
+    } else if (key == "binning") {
+      G4double bin_size;
+      iss >> bin_size >> std::ws;
+      std::getline(iss, name);
+      sensdet_bin[name] = bin_size;
+    } else if (key == "lt_point") {
+      G4double x, y, z;
+      int64_t nphotons;
+      iss >> x >> y >> z >> nphotons;
+      lt_points.push_back(G4ThreeVector(x, y, z));
+      lt_nphotons.push_back(nphotons);
+      lt_charge.emplace_back();
+    } else if (key == "lt_charge") {
+      size_t point;
+      G4int id;
+      int64_t charge;
+      iss >> point >> id >> charge;
+      if (point < lt_charge.size()) lt_charge[point][id] = charge;
+    } else if (key == "absorbed") {
+      G4long nphotons;
+      iss >> nphotons >> std::ws;
+      std::getline(iss, name);
+      absorbed[name] = nphotons;
+    } else if (key == "engine") {
+      engine_state.assign(std::istreambuf_iterator<char>(in),
+                          std::istreambuf_iterator<char>());
+      break;
+    }
+  }
+
+  return !engine_state.empty();
+}
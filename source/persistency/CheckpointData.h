@@ -0,0 +1,72 @@
+// ----------------------------------------------------------------------------
+// nexus | CheckpointData.h
+//
+// State of the persistency manager saved in the checkpoint of an output
+// file, to resume an interrupted job.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef CHECKPOINT_DATA_H
+#define CHECKPOINT_DATA_H
+
+#include <G4ThreeVector.hh>
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  /// The checkpoint is a text file with one line per item, a keyword
+  /// followed by its values (e.g. "events 1000"). Names come last in
+  /// their line, so that they may contain spaces. The status of the
+  /// random engine, which spans several lines, ends the file: a file
+  /// without it is incomplete.
+
+  struct CheckpointData {
+    G4int events = 0; ///< Events of the run completed
+
+    // Options of the job, which the resumed job must share
+    G4bool store_steps = false;
+    G4bool save_str = false;
+    G4bool light_table = false;
+    G4bool sparse_sns = false;
+    int64_t start_id = -1;
+    std::string output_format;
+    G4bool save_rejected = false;
+    G4bool event_seeding = false;
+    G4long run_seed = 0;
+
+    std::string writer_position; ///< Returned by WriterBase::Checkpoint
+
+    // Bookkeeping of the persistency manager
+    int64_t nevt = 0;
+    G4bool first_evt = true;
+    int64_t saved_evts = 0;
+    int64_t interacting_evts = 0;
+    G4int str_counter = 0;
+    std::map<G4String, G4int> str_map;
+    std::vector<G4int> sensors;
+    std::map<G4String, G4double> sensdet_bin;
+
+    // Light table accumulated so far
+    std::vector<G4ThreeVector> lt_points;
+    std::vector<int64_t> lt_nphotons;
+    std::vector<std::map<G4int, int64_t>> lt_charge;
+
+    std::map<G4String, G4long> absorbed; ///< Tally of the optical absorber
+
+    std::string engine_state; ///< Status of the random engine
+
+    /// Write the checkpoint to a stream
+    void Write(std::ostream&) const;
+    /// Read a checkpoint from a stream, returning false if it is
+    /// incomplete
+    G4bool Read(std::istream&);
+  };
+
+} // namespace nexus
+
+#endif
@@ -8,6 +8,8 @@
 
 #include "HDF5Writer.h"
 
+#include <G4Exception.hh>
+
 #include <sstream>
 #include <cstring>
 #include <stdlib.h>
@@ -21,7 +23,9 @@ using namespace nexus;
 
 HDF5Writer::HDF5Writer():
   file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0), istrmap_(0)
+  ipart_(0), ipos_(0), istep_(0), istrmap_(0),
+  iltpoint_(0), iltprob_(0),
+  isnsevt_(0), isnssns_(0), isnsrun_(0), isnschg_(0), ievtinfo_(0)
 {
 }
 
@@ -29,48 +33,157 @@ HDF5Writer::~HDF5Writer()
 {
 }
 
-void HDF5Writer::Open(std::string fileName, bool debug, bool save_str)
+std::string HDF5Writer::GetExtension() const
 {
-  firstEvent_= true;
+  return ".h5";
+}
 
+void HDF5Writer::Open(std::string fileName, bool debug, bool save_str,
+                      bool light_table, bool sparse_sns, bool event_info)
+{
   file_ = H5Fcreate( fileName.c_str(), H5F_ACC_TRUNC,
                       H5P_DEFAULT, H5P_DEFAULT );
 
+  OpenTables(true, debug, save_str, light_table, sparse_sns, event_info);
+}
+
+void HDF5Writer::Resume(std::string fileName, bool debug, bool save_str,
+                        bool light_table, bool sparse_sns, bool event_info,
+                        const std::string& position)
+{
+  file_ = H5Fopen(fileName.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+  if ((hid_t)file_ < 0) {
+    G4Exception("[HDF5Writer]", "Resume()", FatalException,
+                ("Cannot open output file " + fileName + ". A job killed "
+                 "while HDF5 updates the file may leave it unreadable: "
+                 "remove its checkpoint to run the job from the start.").c_str());
+  }
+
+  OpenTables(false, debug, save_str, light_table, sparse_sns, event_info);
+
+  // The file must have the tables of the job, and no others
+  size_t ntables = 0;
+  for (std::string group: {"/MC", "/DEBUG"}) {
+    H5G_info_t info;
+    if (H5Lexists(file_, group.c_str(), H5P_DEFAULT) > 0 &&
+        H5Gget_info_by_name(file_, group.c_str(), &info, H5P_DEFAULT) >= 0)
+      ntables += info.nlinks;
+  }
+
+  // The rows written after the checkpoint are dropped
+  std::istringstream iss(position);
+  bool match = ntables == tables_.size();
+  for (auto& table: tables_) {
+    match = match && (iss >> *table.second) &&
+      truncateTable(table.first, *table.second);
+  }
+
+  std::string extra;
+  if (!match || (iss >> extra)) {
+    G4Exception("[HDF5Writer]", "Resume()", FatalException,
+                "The checkpoint does not match the tables of the file.");
+  }
+}
+
+std::string HDF5Writer::Checkpoint()
+{
+  H5Fflush(file_, H5F_SCOPE_GLOBAL);
+
+  std::ostringstream oss;
+  for (const auto& table: tables_)
+    oss << *table.second << " ";
+  return oss.str();
+}
+
+size_t HDF5Writer::OpenTable(bool create, size_t group, std::string name,
+                             size_t memtype, size_t& counter)
+{
+  size_t table = create ? createTable(group, name, memtype)
+                        : openTable(group, name);
+  if ((hid_t)table < 0) {
+    G4Exception("[HDF5Writer]", "OpenTable()", FatalException,
+                ("Cannot " + std::string(create ? "create" : "open") +
+                 " table " + name).c_str());
+  }
+  tables_.emplace_back(table, &counter);
+  return table;
+}
+
+size_t HDF5Writer::OpenGroup(bool create, std::string name)
+{
+  size_t group = create ? createGroup(file_, name)
+                        : openGroup(file_, name);
+  if ((hid_t)group < 0) {
+    G4Exception("[HDF5Writer]", "OpenGroup()", FatalException,
+                ("Cannot " + std::string(create ? "create" : "open") +
+                 " group " + name).c_str());
+  }
+  return group;
+}
+
+void HDF5Writer::OpenTables(bool create, bool debug, bool save_str,
+                            bool light_table, bool sparse_sns, bool event_info)
+{
+  firstEvent_= true;
+  sparseSns_ = sparse_sns;
+  tables_.clear();
+
   std::string group_name = "/MC";
-  size_t group = createGroup(file_, group_name);
+  size_t group = OpenGroup(create, group_name);
 
-  std::string run_table_name = "configuration";
   memtypeRun_ = createRunType();
-  runTable_ = createTable(group, run_table_name, memtypeRun_);
+  runTable_ = OpenTable(create, group, "configuration", memtypeRun_, irun_);
 
-  std::string sns_data_table_name = "sns_response";
-  memtypeSnsData_ = createSensorDataType();
-  snsDataTable_ = createTable(group, sns_data_table_name, memtypeSnsData_);
+  // The light table replaces the sensor response
+  if (sparse_sns && !light_table) {
+    memtypeSnsEvent_ = createSensorEventType();
+    snsEventTable_ = OpenTable(create, group, "sns_events", memtypeSnsEvent_, isnsevt_);
+
+    memtypeSnsSensor_ = createSensorBlockType();
+    snsSensorTable_ = OpenTable(create, group, "sns_sensors", memtypeSnsSensor_, isnssns_);
+
+    memtypeSnsRun_ = createSensorRunType();
+    snsRunTable_ = OpenTable(create, group, "sns_runs", memtypeSnsRun_, isnsrun_);
+
+    snsChargeTable_ = OpenTable(create, group, "sns_charges", H5T_NATIVE_UINT, isnschg_);
+  }
+  else if (!sparse_sns) {
+    memtypeSnsData_ = createSensorDataType();
+    snsDataTable_ = OpenTable(create, group, "sns_response", memtypeSnsData_, ismp_);
+  }
 
-  std::string hit_info_table_name = "hits";
   memtypeHitInfo_ = createHitInfoType(save_str);
-  hitInfoTable_ = createTable(group, hit_info_table_name, memtypeHitInfo_);
+  hitInfoTable_ = OpenTable(create, group, "hits", memtypeHitInfo_, ihit_);
 
-  std::string particle_info_table_name = "particles";
   memtypeParticleInfo_ = createParticleInfoType(save_str);
-  particleInfoTable_ = createTable(group, particle_info_table_name, memtypeParticleInfo_);
+  particleInfoTable_ = OpenTable(create, group, "particles", memtypeParticleInfo_, ipart_);
 
-  std::string sns_pos_table_name = "sns_positions";
   memtypeSnsPos_ = createSensorPosType();
-  snsPosTable_ = createTable(group, sns_pos_table_name, memtypeSnsPos_);
+  snsPosTable_ = OpenTable(create, group, "sns_positions", memtypeSnsPos_, ipos_);
 
   if (!save_str) {
-    std::string str_map_table_name = "string_map";
     memtypeStringMap_ = createStringMapType();
-    stringMapTable_ = createTable(group, str_map_table_name, memtypeStringMap_);
+    stringMapTable_ = OpenTable(create, group, "string_map", memtypeStringMap_, istrmap_);
+  }
+
+  if (light_table) {
+    memtypeLtPoint_ = createLightTablePointType();
+    ltPointTable_ = OpenTable(create, group, "light_table_points", memtypeLtPoint_, iltpoint_);
+
+    memtypeLtProb_ = createLightTableProbType();
+    ltProbTable_ = OpenTable(create, group, "light_table", memtypeLtProb_, iltprob_);
+  }
+
+  if (event_info) {
+    memtypeEventInfo_ = createEventInfoType();
+    eventInfoTable_ = OpenTable(create, group, "events", memtypeEventInfo_, ievtinfo_);
   }
 
   if (debug) {
     std::string debug_group_name = "/DEBUG";
-    size_t debug_group = createGroup(file_, debug_group_name);
-    std::string step_table_name = "steps";
+    size_t debug_group = OpenGroup(create, debug_group_name);
     memtypeStep_ = createStepType();
-    stepTable_   = createTable(debug_group, step_table_name, memtypeStep_);
+    stepTable_   = OpenTable(create, debug_group, "steps", memtypeStep_, istep_);
   }
 
   isOpen_ = true;
@@ -107,6 +220,55 @@ void HDF5Writer::WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id,
   ismp_++;
 }
 
+void HDF5Writer::WriteSensorWaveform(unsigned int sensor_id, const std::vector<std::pair<unsigned int, float>>& data)
+{
+  if (data.empty()) return;
+
+  sns_sensor_t snsSensor;
+  snsSensor.sensor_id = sensor_id;
+  snsSensor.first_run = isnsrun_ + snsRuns_.size();
+  snsSensor.nruns = 0;
+
+  // Consecutive time bins are grouped in runs
+  for (size_t i=0; i<data.size(); i++) {
+    if (i == 0 || data[i].first != data[i-1].first + 1) {
+      sns_run_t snsRun;
+      snsRun.time_bin = data[i].first;
+      snsRun.first_charge = isnschg_ + snsCharges_.size();
+      snsRun.nbins = 0;
+      snsRuns_.push_back(snsRun);
+      snsSensor.nruns++;
+    }
+    snsRuns_.back().nbins++;
+    snsCharges_.push_back((unsigned int)(data[i].second + 0.5));
+  }
+
+  snsSensors_.push_back(snsSensor);
+}
+
+void HDF5Writer::WriteSensorEvent(int64_t evt_number)
+{
+  sns_event_t snsEvent;
+  snsEvent.event_id = evt_number;
+  snsEvent.first_sensor = isnssns_;
+  snsEvent.nsensors = snsSensors_.size();
+  writeRows(&snsEvent, 1, snsEventTable_, memtypeSnsEvent_, isnsevt_);
+  isnsevt_++;
+
+  writeRows(snsSensors_.data(), snsSensors_.size(), snsSensorTable_, memtypeSnsSensor_, isnssns_);
+  isnssns_ += snsSensors_.size();
+
+  writeRows(snsRuns_.data(), snsRuns_.size(), snsRunTable_, memtypeSnsRun_, isnsrun_);
+  isnsrun_ += snsRuns_.size();
+
+  writeRows(snsCharges_.data(), snsCharges_.size(), snsChargeTable_, H5T_NATIVE_UINT, isnschg_);
+  isnschg_ += snsCharges_.size();
+
+  snsSensors_.clear();
+  snsRuns_.clear();
+  snsCharges_.clear();
+}
+
 void HDF5Writer::WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label)
 {
   hit_info_t trueInfo;
@@ -240,3 +402,39 @@ void HDF5Writer::WriteStringMapInfo(const char* name, int name_id)
   writeStringMap(&strmap, stringMapTable_, memtypeStringMap_, istrmap_);
   istrmap_++;
 }
+
+void HDF5Writer::WriteLightTablePoint(unsigned int point_id, float x, float y, float z, uint64_t nphotons)
+{
+  lt_point_t ltPoint;
+  ltPoint.point_id = point_id;
+  ltPoint.x = x;
+  ltPoint.y = y;
+  ltPoint.z = z;
+  ltPoint.nphotons = nphotons;
+
+  writeLtPoint(&ltPoint, ltPointTable_, memtypeLtPoint_, iltpoint_);
+  iltpoint_++;
+}
+
+void HDF5Writer::WriteLightTableProb(unsigned int point_id, unsigned int sensor_id, uint64_t charge, float probability)
+{
+  lt_prob_t ltProb;
+  ltProb.point_id = point_id;
+  ltProb.sensor_id = sensor_id;
+  ltProb.charge = charge;
+  ltProb.probability = probability;
+
+  writeLtProb(&ltProb, ltProbTable_, memtypeLtProb_, iltprob_);
+  iltprob_++;
+}
+
+void HDF5Writer::WriteEventInfo(int64_t evt_number, char selected, uint64_t seed)
+{
+  event_info_t evtInfo;
+  evtInfo.event_id = evt_number;
+  evtInfo.selected = selected;
+  evtInfo.seed = seed;
+
+  writeRows(&evtInfo, 1, eventInfoTable_, memtypeEventInfo_, ievtinfo_);
+  ievtinfo_++;
+}
@@ -9,14 +9,17 @@
 #ifndef HDF5WRITER_H
 #define HDF5WRITER_H
 
+#include "WriterBase.h"
 #include "hdf5_functions.h"
 
 #include <hdf5.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace nexus {
 
-  class HDF5Writer {
+  class HDF5Writer: public WriterBase {
 
   public:
     /// constructor
@@ -24,17 +27,35 @@ namespace nexus {
     /// destructor
     ~HDF5Writer();
 
+    std::string GetExtension() const override;
+
     /// open file
-    void Open(std::string filename, bool debug, bool save_str);
+    void Open(std::string filename, bool debug, bool save_str,
+              bool light_table=false, bool sparse_sns=false,
+              bool event_info=false) override;
 
     /// close file
-    void Close();
-
-    void WriteRunInfo(const char* param_key, const char* param_value);
-    void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
-    void WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label);
-    void WriteParticleInfo(bool str, int64_t evt_number, int particle_indx, const char* particle_name_str, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume_str, const char* final_volume_str, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc_str, const char* final_proc_str, int creator_proc, int final_proc);
-    void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z);
+    void Close() override;
+
+    /// The position is the number of rows of each table. The file is
+    /// only consistent on disk right after the flush: HDF5 keeps its
+    /// metadata in a cache that is written back as the tables grow,
+    /// so a job killed meanwhile may leave a file that cannot be
+    /// reopened. It must then be run again from the start
+    std::string Checkpoint() override;
+    void Resume(std::string filename, bool debug, bool save_str,
+                bool light_table, bool sparse_sns, bool event_info,
+                const std::string& position) override;
+
+    void WriteRunInfo(const char* param_key, const char* param_value) override;
+    void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge) override;
+    /// Sparse layout: the (time bin, charge) pairs of a sensor
+    /// are buffered until the event is written
+    void WriteSensorWaveform(unsigned int sensor_id, const std::vector<std::pair<unsigned int, float>>& data) override;
+    void WriteSensorEvent(int64_t evt_number) override;
+    void WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label) override;
+    void WriteParticleInfo(bool str, int64_t evt_number, int particle_indx, const char* particle_name_str, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume_str, const char* final_volume_str, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc_str, const char* final_proc_str, int creator_proc, int final_proc) override;
+    void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z) override;
     void WriteStep(int64_t evt_number,
                    int particle_id, const char* particle_name,
                    int step_id,
@@ -43,14 +64,28 @@ namespace nexus {
                    const char*      proc_name,
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z,
-                   float time);
-    void WriteStringMapInfo(const char* name, int name_id);
+                   float time) override;
+    void WriteStringMapInfo(const char* name, int name_id) override;
+    void WriteLightTablePoint(unsigned int point_id, float x, float y, float z, uint64_t nphotons) override;
+    void WriteLightTableProb(unsigned int point_id, unsigned int sensor_id, uint64_t charge, float probability) override;
+    void WriteEventInfo(int64_t evt_number, char selected, uint64_t seed) override;
+
+  private:
+    /// Create the tables in a new file, or open them in an existing one
+    void OpenTables(bool create, bool debug, bool save_str,
+                    bool light_table, bool sparse_sns, bool event_info);
+    /// Create or open a group
+    size_t OpenGroup(bool create, std::string name);
+    /// Create or open a table, and register it with its counter
+    size_t OpenTable(bool create, size_t group, std::string name,
+                     size_t memtype, size_t& counter);
 
   private:
     size_t file_; ///< HDF5 file
 
     bool isOpen_;
     bool firstEvent_; ///< First event
+    bool sparseSns_;  ///< Sparse layout of the sensor response
 
     //Datasets
     size_t runTable_;
@@ -60,6 +95,13 @@ namespace nexus {
     size_t snsPosTable_;
     size_t stepTable_;
     size_t stringMapTable_;
+    size_t ltPointTable_;
+    size_t ltProbTable_;
+    size_t snsEventTable_;
+    size_t snsSensorTable_;
+    size_t snsRunTable_;
+    size_t snsChargeTable_;
+    size_t eventInfoTable_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
@@ -68,6 +110,12 @@ namespace nexus {
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
     size_t memtypeStringMap_;
+    size_t memtypeLtPoint_;
+    size_t memtypeLtProb_;
+    size_t memtypeSnsEvent_;
+    size_t memtypeSnsSensor_;
+    size_t memtypeSnsRun_;
+    size_t memtypeEventInfo_;
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
@@ -76,6 +124,21 @@ namespace nexus {
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
     size_t istrmap_;  ///< counter for string map
+    size_t iltpoint_; ///< counter for light-table points
+    size_t iltprob_;  ///< counter for light-table probabilities
+    size_t isnsevt_;  ///< counter for events of the sparse sensor response
+    size_t isnssns_;  ///< counter for sensors of the sparse sensor response
+    size_t isnsrun_;  ///< counter for runs of bins of the sparse sensor response
+    size_t isnschg_;  ///< counter for charges of the sparse sensor response
+    size_t ievtinfo_; ///< counter for event information
+
+    /// Tables of the file with their counters, in order of creation
+    std::vector<std::pair<size_t, size_t*>> tables_;
+
+    // Sparse sensor response of the current event
+    std::vector<sns_sensor_t> snsSensors_;
+    std::vector<sns_run_t>    snsRuns_;
+    std::vector<unsigned int> snsCharges_;
 
   };
 
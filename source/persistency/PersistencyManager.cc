@@ -18,8 +18,12 @@
 #include "SaveAllSteppingAction.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
+#include "BinaryWriter.h"
 #include "PersistencyManagerBase.h"
 #include "FactoryBase.h"
+#include "OpticalAbsorber.h"
+#include "CheckpointData.h"
+#include "EmittedPhotonsInfo.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Event.hh>
@@ -29,15 +33,31 @@
 #include <G4HCtable.hh>
 #include <G4RunManager.hh>
 #include <G4Run.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4ProcessTable.hh>
+#include <G4OpticalPhoton.hh>
+#include <Randomize.hh>
 
 #include <string>
 #include <sstream>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
 
 using namespace nexus;
 
 
+namespace {
+  OpticalAbsorber* FindOpticalAbsorber()
+  {
+    return dynamic_cast<OpticalAbsorber*>(
+      G4ProcessTable::GetProcessTable()->FindProcess("OpticalAbsorber",
+                                                     G4OpticalPhoton::Definition()));
+  }
+}
+
+
 REGISTER_CLASS(PersistencyManager, PersistencyManagerBase)
 
 
@@ -46,8 +66,11 @@ PersistencyManagerBase(), msg_(0), output_file_("nexus_out"), ready_(false),
   store_evt_(true), store_steps_(false),
   interacting_evt_(false), save_ie_numb_(false), event_type_("other"),
   saved_evts_(0), interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0),
-  str_counter_(0), save_str_(true), particles_(true)
+  nevt_(0), start_id_(0), first_evt_(true), output_format_("hdf5"), writer_(0),
+  str_counter_(0), save_str_(true), particles_(true),
+  light_table_(false), lt_current_(0), sparse_sns_(false),
+  save_rejected_(false), checkpoint_interval_(0), completed_evts_(0),
+  resumed_evts_(0)
 {
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
   msg_->DeclareProperty("output_file", output_file_, "Path of output file.");
@@ -59,6 +82,34 @@ PersistencyManagerBase(), msg_(0), output_file_("nexus_out"), ready_(false),
                         "True if volume, process... names are saved as strings.");
   msg_->DeclareProperty("save_particles", particles_,
                         "True if particles table is saved.");
+  msg_->DeclareProperty("light_table", light_table_,
+                        "True if only the detection probability of each sensor "
+                        "per vertex is saved.");
+  msg_->DeclareProperty("sparse_sensor_data", sparse_sns_,
+                        "True if the sensor response is saved indexed by event "
+                        "(sns_events, sns_sensors, sns_runs and sns_charges) "
+                        "instead of as the flat sns_response table.");
+
+  G4GenericMessenger::Command& format_cmd =
+    msg_->DeclareProperty("output_format", output_format_,
+                          "Format of the output file: hdf5, or binary for "
+                          "a flat stream of records converted offline.");
+  format_cmd.SetCandidates("hdf5 binary");
+
+  msg_->DeclareProperty("save_rejected_events", save_rejected_,
+                        "True if the events rejected by the event action keep "
+                        "an event ID, their primary particles and a row in "
+                        "the events table.");
+
+  G4GenericMessenger::Command& checkpoint_cmd =
+    msg_->DeclareProperty("checkpoint_interval", checkpoint_interval_,
+                          "Number of events between checkpoints of the output "
+                          "file (0 for none). A job interrupted after a "
+                          "checkpoint resumes from it when run again. HDF5 "
+                          "files may be left unreadable by a crash; binary "
+                          "files are not.");
+  checkpoint_cmd.SetParameterName("checkpoint_interval", false);
+  checkpoint_cmd.SetRange("checkpoint_interval>=0");
 
   init_macro_ = "";
   macros_.clear();
@@ -71,7 +122,7 @@ PersistencyManagerBase(), msg_(0), output_file_("nexus_out"), ready_(false),
 PersistencyManager::~PersistencyManager()
 {
   delete msg_;
-  delete h5writer_;
+  delete writer_;
 }
 
 
@@ -79,10 +130,22 @@ PersistencyManager::~PersistencyManager()
 void PersistencyManager::OpenFile()
 {
   // If the output file was not set yet, do so
-  if (!h5writer_) {
-    h5writer_ = new HDF5Writer();
-    G4String hdf5file = output_file_ + ".h5";
-    h5writer_->Open(hdf5file, store_steps_, save_str_);
+  if (!writer_) {
+    if (output_format_ == "binary")
+      writer_ = new BinaryWriter();
+    else
+      writer_ = new HDF5Writer();
+    G4String file = output_file_ + writer_->GetExtension();
+    NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+    G4bool event_info = !light_table_ && (save_rejected_ || app->EventSeeding());
+
+    // With checkpoints, a job that was interrupted before
+    // the end of the run resumes from the last checkpoint
+    if (checkpoint_interval_ > 0 && std::ifstream(CheckpointFile()).good())
+      ResumeFromCheckpoint(file, event_info);
+    else
+      writer_->Open(file, store_steps_, save_str_, light_table_, sparse_sns_,
+                    event_info);
     return;
   } else {
     G4Exception("[PersistencyManager]", "OpenFile()",
@@ -94,20 +157,46 @@ void PersistencyManager::OpenFile()
 
 void PersistencyManager::CloseFile()
 {
-  if (!h5writer_) return;
+  if (!writer_) return;
 
-  h5writer_->Close();
+  writer_->Close();
+
+  // The run is complete, so its checkpoint is no longer needed
+  if (checkpoint_interval_ > 0)
+    std::remove(CheckpointFile().c_str());
 }
 
 
 
 G4bool PersistencyManager::Store(const G4Event* event)
+{
+  G4bool stored = StoreEvent(event);
+
+  // No checkpoint is written after the last event of the run,
+  // so that a resumed job always has events left to process
+  completed_evts_++;
+  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+  if (checkpoint_interval_ > 0 &&
+      completed_evts_ % checkpoint_interval_ == 0 &&
+      completed_evts_ < app->GetNumberOfEventsToBeProcessed() + resumed_evts_)
+    WriteCheckpoint();
+
+  return stored;
+}
+
+
+G4bool PersistencyManager::StoreEvent(const G4Event* event)
 {
   if (interacting_evt_) {
     interacting_evts_++;
   }
 
-  if (!store_evt_) {
+  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+
+  // Rejected events are dropped, unless their bookkeeping is kept
+  G4bool bookkeeping = save_rejected_ && !light_table_;
+
+  if (!store_evt_ && !bookkeeping) {
     TrajectoryMap::Clear();
     if (store_steps_) {
       SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
@@ -117,18 +206,33 @@ G4bool PersistencyManager::Store(const G4Event* event)
     return false;
   }
 
-  saved_evts_++;
-
   if (first_evt_) {
     first_evt_ = false;
     nevt_ = start_id_;
   }
 
+  // With event seeding, the ID of an event is the one its seed was
+  // derived from, so that it can be replayed
+  if (app->EventSeeding())
+    nevt_ = start_id_ + event->GetEventID();
+
+  if (!store_evt_) {
+    StoreRejectedEvent(event);
+    return false;
+  }
+
+  saved_evts_++;
+
   if (store_steps_)
     StoreSteps();
 
+  // In light-table mode only the response of the sensors to
+  // the photons generated at the event vertex is accumulated
+  if (light_table_)
+    StoreLightTablePoint(event);
+
   // Store the trajectories of the event
-  if (particles_) {
+  if (particles_ && !light_table_) {
     StoreTrajectories(event->GetTrajectoryContainer());
   }
 
@@ -137,6 +241,14 @@ G4bool PersistencyManager::Store(const G4Event* event)
   hit_map_.clear();
   StoreHits(event->GetHCofThisEvent());
 
+  // In the sparse layout, every saved event gets a row in the
+  // index, so that the n-th event can be read directly
+  if (sparse_sns_ && !light_table_)
+    writer_->WriteSensorEvent(nevt_);
+
+  if (!light_table_ && (bookkeeping || app->EventSeeding()))
+    writer_->WriteEventInfo(nevt_, 1, app->GetEventSeed());
+
   nevt_++;
 
   TrajectoryMap::Clear();
@@ -146,7 +258,32 @@ G4bool PersistencyManager::Store(const G4Event* event)
 }
 
 
-void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
+void PersistencyManager::StoreRejectedEvent(const G4Event* event)
+{
+  // The hits, sensor response and steps of the event are dropped
+  if (store_steps_) {
+    SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
+      G4RunManager::GetRunManager()->GetUserSteppingAction();
+    sa->Reset();
+  }
+
+  if (particles_)
+    StoreTrajectories(event->GetTrajectoryContainer(), true);
+
+  if (sparse_sns_ && !light_table_)
+    writer_->WriteSensorEvent(nevt_);
+
+  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+  writer_->WriteEventInfo(nevt_, 0, app->GetEventSeed());
+
+  nevt_++;
+
+  TrajectoryMap::Clear();
+}
+
+
+void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc,
+                                           G4bool primaries_only)
 {
   // If the pointer is null, no trajectories were stored in this event
   if (!tc) return;
@@ -156,6 +293,7 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
   for (size_t i=0; i<tc->entries(); ++i) {
     Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
     if (!trj) continue;
+    if (primaries_only && trj->GetParentID() != 0) continue;
 
     G4int trackid = trj->GetTrackID();
 
@@ -195,22 +333,24 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
     if (!trj->GetParentID()) {
       primary = 1;
     } else {
-      mother_id = trj->GetParentID();
+      // If the trajectory of the mother was not stored by the tracking
+      // action, the closest stored ancestor is taken instead
+      mother_id = TrajectoryMap::StoredAncestor(trj->GetParentID());
     }
-    h5writer_->WriteParticleInfo(save_str_, nevt_, trackid, p_name.c_str(),
-                                 (int)pname_id, primary, mother_id,
-				 (float)ini_xyz.x(), (float)ini_xyz.y(),
-                                 (float)ini_xyz.z(), (float)ini_t,
-				 (float)final_xyz.x(), (float)final_xyz.y(),
-                                 (float)final_xyz.z(), (float)final_t,
-                                 ini_volume.c_str(), final_volume.c_str(),
-				 (int)iniv_id, (int)finv_id,
-				 (float)ini_mom.x(), (float)ini_mom.y(),
-                                 (float)ini_mom.z(), (float)final_mom.x(),
-                                 (float)final_mom.y(), (float)final_mom.z(),
-				 kin_energy, length, creator_proc.c_str(),
-                                 final_proc.c_str(),
-                                 (int)creatpr_id, (int)finpr_id);
+    writer_->WriteParticleInfo(save_str_, nevt_, trackid, p_name.c_str(),
+                               (int)pname_id, primary, mother_id,
+                               (float)ini_xyz.x(), (float)ini_xyz.y(),
+                               (float)ini_xyz.z(), (float)ini_t,
+                               (float)final_xyz.x(), (float)final_xyz.y(),
+                               (float)final_xyz.z(), (float)final_t,
+                               ini_volume.c_str(), final_volume.c_str(),
+                               (int)iniv_id, (int)finv_id,
+                               (float)ini_mom.x(), (float)ini_mom.y(),
+                               (float)ini_mom.z(), (float)final_mom.x(),
+                               (float)final_mom.y(), (float)final_mom.z(),
+                               kin_energy, length, creator_proc.c_str(),
+                               final_proc.c_str(),
+                               (int)creatpr_id, (int)finpr_id);
 
   }
 }
@@ -237,8 +377,9 @@ void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
     // Fetch collection using the id number
     G4VHitsCollection* hits = hce->GetHC(hcid);
 
-    if (hcname == IonizationSD::GetCollectionUniqueName())
-      StoreIonizationHits(hits);
+    if (hcname == IonizationSD::GetCollectionUniqueName()) {
+      if (!light_table_) StoreIonizationHits(hits);
+    }
     else if (hcname == SensorSD::GetCollectionUniqueName()) {
       StoreSensorHits(hits);
     } else {
@@ -266,7 +407,9 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
     IonizationHit* hit = dynamic_cast<IonizationHit*>(hits->GetHit(i));
     if (!hit) continue;
 
-    G4int trackid = hit->GetTrackID();
+    // The hits of a track without stored trajectory are
+    // assigned to its closest stored ancestor
+    G4int trackid = TrajectoryMap::StoredAncestor(hit->GetTrackID());
 
     std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
     if (it != hit_map_.end()) {
@@ -279,10 +422,10 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
     ihits_->push_back(1);
 
     G4ThreeVector xyz = hit->GetPosition();
-    h5writer_->WriteHitInfo(save_str_, nevt_, trackid,  ihits_->size() - 1,
-			    xyz[0], xyz[1], xyz[2],
-			    hit->GetTime(), hit->GetEnergyDeposit(),
-                            sdname.c_str(), sdname_id);
+    writer_->WriteHitInfo(save_str_, nevt_, trackid,  ihits_->size() - 1,
+                          xyz[0], xyz[1], xyz[2],
+                          hit->GetTime(), hit->GetEnergyDeposit(),
+                          sdname.c_str(), sdname_id);
   }
 }
 
@@ -326,15 +469,22 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
       data.push_back(std::make_pair(time_bin, charge));
       amplitude = amplitude + (*it).second;
 
-      h5writer_->WriteSensorDataInfo(nevt_, (unsigned int)hit->GetSensorID(),
+      if (!light_table_ && !sparse_sns_)
+        writer_->WriteSensorDataInfo(nevt_, (unsigned int)hit->GetSensorID(),
                                      time_bin, charge);
     }
 
+    if (!light_table_ && sparse_sns_)
+      writer_->WriteSensorWaveform((unsigned int)hit->GetSensorID(), data);
+
+    if (light_table_ && lt_current_ < lt_charge_.size())
+      lt_charge_[lt_current_][hit->GetSensorID()] += (int64_t)(amplitude + 0.5);
+
     std::vector<G4int>::iterator pos_it =
       std::find(sns_posvec_.begin(), sns_posvec_.end(), hit->GetSensorID());
     if (pos_it == sns_posvec_.end()) {
-      h5writer_->WriteSensorPosInfo((unsigned int)hit->GetSensorID(), sdname.c_str(),
-				    (float)xyz.x(), (float)xyz.y(), (float)xyz.z());
+      writer_->WriteSensorPosInfo((unsigned int)hit->GetSensorID(), sdname.c_str(),
+                                  (float)xyz.x(), (float)xyz.y(), (float)xyz.z());
       sns_posvec_.push_back(hit->GetSensorID());
     }
 
@@ -361,47 +511,110 @@ void PersistencyManager::StoreSteps()
     G4String                   particle_name = key.second;
 
     for (size_t step_id=0; step_id < it->second.size(); ++step_id) {
-      h5writer_->WriteStep(nevt_, track_id, particle_name, step_id,
-                           initial_volumes[key][step_id],
-                             final_volumes[key][step_id],
-                                proc_names[key][step_id],
-                           initial_poss   [key][step_id].x(),
-                           initial_poss   [key][step_id].y(),
-                           initial_poss   [key][step_id].z(),
-                             final_poss   [key][step_id].x(),
-                             final_poss   [key][step_id].y(),
-                             final_poss   [key][step_id].z(),
-                                  times   [key][step_id]);
+      writer_->WriteStep(nevt_, track_id, particle_name, step_id,
+                         initial_volumes[key][step_id],
+                           final_volumes[key][step_id],
+                              proc_names[key][step_id],
+                         initial_poss   [key][step_id].x(),
+                         initial_poss   [key][step_id].y(),
+                         initial_poss   [key][step_id].z(),
+                           final_poss   [key][step_id].x(),
+                           final_poss   [key][step_id].y(),
+                           final_poss   [key][step_id].z(),
+                                times   [key][step_id]);
     }
   }
   sa->Reset();
 }
 
+void PersistencyManager::StoreLightTablePoint(const G4Event* event)
+{
+  // Events sharing the same vertex are accumulated in the same point
+  G4PrimaryVertex* vertex = event->GetPrimaryVertex();
+  if (!vertex) return;
+
+  G4ThreeVector xyz = vertex->GetPosition();
+  auto key = std::make_tuple(xyz.x(), xyz.y(), xyz.z());
+
+  auto it = lt_index_.find(key);
+  if (it == lt_index_.end()) {
+    it = lt_index_.emplace(key, lt_points_.size()).first;
+    lt_points_.push_back(xyz);
+    lt_nphotons_.push_back(0);
+    lt_charge_.emplace_back();
+  }
+  lt_current_ = it->second;
+
+  // Photons emitted, including those dropped by detection pre-sampling,
+  // which the vertices of ScintillationGenerator record
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+    G4PrimaryVertex* vtx = event->GetPrimaryVertex(i);
+    auto info = dynamic_cast<EmittedPhotonsInfo*>(vtx->GetUserInformation());
+    lt_nphotons_[lt_current_] +=
+      info ? info->GetNumberOfPhotons() : vtx->GetNumberOfParticle();
+  }
+}
+
+
+void PersistencyManager::StoreLightTable()
+{
+  for (size_t i=0; i<lt_points_.size(); ++i) {
+    const G4ThreeVector& xyz = lt_points_[i];
+    writer_->WriteLightTablePoint(i, (float)xyz.x(), (float)xyz.y(),
+                                  (float)xyz.z(), lt_nphotons_[i]);
+
+    if (lt_nphotons_[i] == 0) continue;
+
+    for (const auto& sns: lt_charge_[i]) {
+      float prob = (G4double)sns.second / lt_nphotons_[i];
+      writer_->WriteLightTableProb(i, (unsigned int)sns.first, sns.second, prob);
+    }
+  }
+}
+
+
 G4bool PersistencyManager::Store(const G4Run*)
 {
+  if (light_table_)
+    StoreLightTable();
+
   // Store the event type
   G4String key = "event_type";
-  h5writer_->WriteRunInfo(key, event_type_.c_str());
+  writer_->WriteRunInfo(key, event_type_.c_str());
 
   // Store the number of events to be processed
   NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
-  G4int num_events = app->GetNumberOfEventsToBeProcessed();
+  G4int num_events = app->GetNumberOfEventsToBeProcessed() + resumed_evts_;
+  completed_evts_ = 0;
+  resumed_evts_ = 0;
 
   key = "num_events";
-  h5writer_->WriteRunInfo(key,  std::to_string(num_events).c_str());
+  writer_->WriteRunInfo(key,  std::to_string(num_events).c_str());
   key = "saved_events";
-  h5writer_->WriteRunInfo(key,  std::to_string(saved_evts_).c_str());
+  writer_->WriteRunInfo(key,  std::to_string(saved_evts_).c_str());
+
+  key = "run_seed";
+  writer_->WriteRunInfo(key, std::to_string(app->GetRandomSeed()).c_str());
 
   if (save_ie_numb_) {
     key = "interacting_events";
-    h5writer_->WriteRunInfo(key,  std::to_string(interacting_evts_).c_str());
+    writer_->WriteRunInfo(key,  std::to_string(interacting_evts_).c_str());
   }
 
   // Store sensor time binning
   std::map<G4String, G4double>::const_iterator it;
   for (it = sensdet_bin_.begin(); it != sensdet_bin_.end(); ++it) {
-    h5writer_->WriteRunInfo((it->first + "_binning").c_str(),
-                           (std::to_string(it->second/microsecond)+" mus").c_str());
+    writer_->WriteRunInfo((it->first + "_binning").c_str(),
+                         (std::to_string(it->second/microsecond)+" mus").c_str());
+  }
+
+  // Store the optical photons killed in each absorber volume
+  OpticalAbsorber* absorber = FindOpticalAbsorber();
+  if (absorber && absorber->GetTally()) {
+    for (const auto& vol: absorber->GetAbsorbedPhotons()) {
+      writer_->WriteRunInfo((vol.first + "_absorbed_photons").c_str(),
+                            std::to_string(vol.second).c_str());
+    }
   }
 
   // Store configuration parameters
@@ -424,7 +637,7 @@ G4bool PersistencyManager::Store(const G4Run*)
     }
 
     for (const auto& p : inv_map) {
-      h5writer_->WriteStringMapInfo(p.second, p.first);
+      writer_->WriteStringMapInfo(p.second, p.first);
     }
   }
 
@@ -455,7 +668,7 @@ void PersistencyManager::SaveConfigurationInfo(G4String file_name)
         if (key[0] == '\n') {
           key.erase(0, 1);
         }
-	h5writer_->WriteRunInfo(key.c_str(), value.c_str());
+	writer_->WriteRunInfo(key.c_str(), value.c_str());
       }
 
       if (found_other_macro != std::string::npos)
@@ -468,6 +681,145 @@ void PersistencyManager::SaveConfigurationInfo(G4String file_name)
 }
 
 
+G4String PersistencyManager::CheckpointFile() const
+{
+  return output_file_ + writer_->GetExtension() + ".checkpoint";
+}
+
+
+void PersistencyManager::WriteCheckpoint()
+{
+  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+
+  CheckpointData data;
+  data.events           = completed_evts_;
+  data.store_steps      = store_steps_;
+  data.save_str         = save_str_;
+  data.light_table      = light_table_;
+  data.sparse_sns       = sparse_sns_;
+  data.start_id         = start_id_;
+  data.output_format    = output_format_;
+  data.save_rejected    = save_rejected_;
+  data.event_seeding    = app->EventSeeding();
+  data.run_seed         = app->GetRandomSeed();
+  data.nevt             = nevt_;
+  data.first_evt        = first_evt_;
+  data.saved_evts       = saved_evts_;
+  data.interacting_evts = interacting_evts_;
+  data.str_counter      = str_counter_;
+  data.str_map          = str_map_;
+  data.sensors          = sns_posvec_;
+  data.sensdet_bin      = sensdet_bin_;
+  data.lt_points        = lt_points_;
+  data.lt_nphotons      = lt_nphotons_;
+  data.lt_charge        = lt_charge_;
+
+  OpticalAbsorber* absorber = FindOpticalAbsorber();
+  if (absorber && absorber->GetTally())
+    data.absorbed = absorber->GetAbsorbedPhotons();
+
+  std::ostringstream engine;
+  CLHEP::HepRandom::getTheEngine()->put(engine);
+  data.engine_state = engine.str();
+
+  // The output file is flushed first, so that it contains
+  // all the events of the checkpoint
+  data.writer_position = writer_->Checkpoint();
+
+  G4String file = CheckpointFile();
+  std::ofstream out(file + ".tmp");
+  data.Write(out);
+  out.close();
+
+  if (!out) {
+    G4Exception("[PersistencyManager]", "WriteCheckpoint()", JustWarning,
+                ("Cannot write checkpoint " + file).c_str());
+    return;
+  }
+
+  // The previous checkpoint is replaced at once, so that
+  // an interrupted job always finds a complete one
+  std::rename((file + ".tmp").c_str(), file.c_str());
+}
+
+
+void PersistencyManager::ResumeFromCheckpoint(const G4String& file,
+                                              G4bool event_info)
+{
+  std::ifstream in(CheckpointFile());
+  CheckpointData data;
+
+  if (!data.Read(in)) {
+    G4Exception("[PersistencyManager]", "ResumeFromCheckpoint()",
+                FatalException, ("Invalid checkpoint " + CheckpointFile()).c_str());
+  }
+
+  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
+  if (data.store_steps != store_steps_ || data.save_str != save_str_ ||
+      data.light_table != light_table_ || data.sparse_sns != sparse_sns_ ||
+      data.start_id != start_id_ || data.output_format != output_format_ ||
+      data.save_rejected != save_rejected_ ||
+      data.event_seeding != app->EventSeeding()) {
+    G4Exception("[PersistencyManager]", "ResumeFromCheckpoint()",
+                FatalException, "The configuration of the job differs "
+                "from that of the checkpoint.");
+  }
+
+  // A seed taken from the system time differs from one job to the
+  // next, so the interrupted job's seed is taken instead. An explicit
+  // seed must be that of the checkpoint.
+  if (app->RandomSeedFromClock()) {
+    app->ResumeRandomSeed(data.run_seed);
+  }
+  else if (data.run_seed != app->GetRandomSeed()) {
+    G4Exception("[PersistencyManager]", "ResumeFromCheckpoint()",
+                FatalException, "The random seed of the job differs "
+                "from that of the checkpoint.");
+  }
+
+  resumed_evts_     = data.events;
+  nevt_             = data.nevt;
+  first_evt_        = data.first_evt;
+  saved_evts_       = data.saved_evts;
+  interacting_evts_ = data.interacting_evts;
+  str_counter_      = data.str_counter;
+  str_map_          = data.str_map;
+  sns_posvec_       = data.sensors;
+  sensdet_bin_      = data.sensdet_bin;
+  lt_points_        = data.lt_points;
+  lt_nphotons_      = data.lt_nphotons;
+  lt_charge_        = data.lt_charge;
+  engine_state_     = data.engine_state;
+
+  for (size_t i=0; i<lt_points_.size(); ++i)
+    lt_index_.emplace(std::make_tuple(lt_points_[i].x(), lt_points_[i].y(),
+                                      lt_points_[i].z()), i);
+
+  OpticalAbsorber* absorber = FindOpticalAbsorber();
+  if (absorber) {
+    for (const auto& vol: data.absorbed)
+      absorber->AddAbsorbedPhotons(vol.first, vol.second);
+  }
+
+  writer_->Resume(file, store_steps_, save_str_, light_table_, sparse_sns_,
+                  event_info, data.writer_position);
+  completed_evts_ = resumed_evts_;
+
+  G4cout << "Resuming " << file << " after " << resumed_evts_
+         << " events." << G4endl;
+}
+
+
+void PersistencyManager::RestoreRandomEngine()
+{
+  if (engine_state_.empty()) return;
+
+  std::istringstream iss(engine_state_);
+  CLHEP::HepRandom::getTheEngine()->get(iss);
+  engine_state_.clear();
+}
+
+
 G4int PersistencyManager::FindStringIDInMap(std::map<G4String, G4int>& vmap,
                                             G4String vol, G4int& counter)
 {
@@ -13,7 +13,10 @@
 #include "PersistencyManagerBase.h"
 
 #include <G4VPersistencyManager.hh>
+#include <G4ThreeVector.hh>
 #include <map>
+#include <string>
+#include <tuple>
 #include <vector>
 
 
@@ -23,7 +26,7 @@ class G4HCofThisEvent;
 class G4VHitsCollection;
 
 namespace nexus {
-  class HDF5Writer;
+  class WriterBase;
   class IonizationHit;
 }
 
@@ -59,16 +62,32 @@ namespace nexus {
     void OpenFile();
     void CloseFile();
 
+    int64_t GetStartID() const;
+
+    G4int GetResumedEvents() const;
+    void RestoreRandomEngine();
+
 
   private:
-    void StoreTrajectories(G4TrajectoryContainer*);
+    G4bool StoreEvent(const G4Event*);
+    void StoreRejectedEvent(const G4Event*);
+    void StoreTrajectories(G4TrajectoryContainer*, G4bool primaries_only=false);
     void StoreHits(G4HCofThisEvent*);
     void StoreIonizationHits(G4VHitsCollection*);
     void StoreSensorHits(G4VHitsCollection*);
     void StoreSteps();
+    void StoreLightTablePoint(const G4Event*);
+    void StoreLightTable();
 
     void SaveConfigurationInfo(G4String history);
 
+    /// Path of the checkpoint of the output file
+    G4String CheckpointFile() const;
+    /// Save the state of the job after the events completed so far
+    void WriteCheckpoint();
+    /// Restore the state of the job and reopen the output file
+    void ResumeFromCheckpoint(const G4String& file, G4bool event_info);
+
     G4int FindStringIDInMap(std::map<G4String, G4int>& vmap, G4String vol, G4int& counter);
 
 
@@ -94,7 +113,8 @@ namespace nexus {
     int64_t start_id_; ///< ID for the first event in file
     G4bool first_evt_; ///< true only for the first event of the run
 
-    HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
+    G4String output_format_; ///< Format of the output file (hdf5, binary)
+    WriterBase* writer_;  ///< Event writer to the output file
 
     std::vector<G4int>* ihits_;
     std::map<G4int, std::vector<G4int>* > hit_map_;
@@ -106,6 +126,21 @@ namespace nexus {
     G4bool particles_; ///< Store particles table
 
     std::map<G4String, G4double> sensdet_bin_;
+
+    G4bool light_table_; ///< Accumulate detection probabilities per vertex instead of sensor rows?
+    size_t lt_current_;  ///< Light-table point of the current event
+    std::map<std::tuple<G4double, G4double, G4double>, size_t> lt_index_; ///< vertex --> point id
+    std::vector<G4ThreeVector> lt_points_;  ///< Vertex of each point
+    std::vector<int64_t> lt_nphotons_;      ///< Photons generated at each point
+    std::vector<std::map<G4int, int64_t>> lt_charge_; ///< Photons detected per point and sensor
+
+    G4bool sparse_sns_; ///< Save the sensor response indexed by event
+    G4bool save_rejected_; ///< Keep the ID and primaries of rejected events
+
+    G4int checkpoint_interval_; ///< Events between checkpoints (0: none)
+    G4int completed_evts_; ///< Events of the run completed so far
+    G4int resumed_evts_;   ///< Events of the run completed before resuming
+    std::string engine_state_; ///< Random engine at the checkpoint, until restored
   };
 
 
@@ -119,6 +154,10 @@ namespace nexus {
   { interacting_evt_ = ie; }
   inline void PersistencyManager::SaveNumbOfInteractingEvents(G4bool sie)
   {save_ie_numb_ = sie;}
+  inline int64_t PersistencyManager::GetStartID() const
+  { return start_id_; }
+  inline G4int PersistencyManager::GetResumedEvents() const
+  { return resumed_evts_; }
   inline G4bool PersistencyManager::Store(const G4VPhysicalVolume*)
   { return false; }
   inline G4bool PersistencyManager::Retrieve(G4Event*&)
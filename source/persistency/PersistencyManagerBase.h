@@ -14,6 +14,15 @@ class PersistencyManagerBase: public G4VPersistencyManager
     virtual void OpenFile() = 0;
     virtual void CloseFile() = 0;
 
+    /// ID of the first event of the job
+    virtual int64_t GetStartID() const { return 0; }
+
+    /// Events of the run completed before the checkpoint
+    /// the job was resumed from
+    virtual G4int GetResumedEvents() const { return 0; }
+    /// Set the random engine as it was at the checkpoint
+    virtual void RestoreRandomEngine() {}
+
     G4String init_macro_;
     std::vector<G4String> macros_;
     std::vector<G4String> delayed_macros_;
@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDataReader.cc
+//
+// This class reads the sensor response of single events from nexus
+// output files written with the sparse layout (sparse_sensor_data).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorDataReader.h"
+
+#include <algorithm>
+
+using namespace nexus;
+
+
+SensorDataReader::SensorDataReader():
+  file_(-1), isOpen_(false), nevents_(0), sorted_(true)
+{
+}
+
+SensorDataReader::~SensorDataReader()
+{
+  Close();
+}
+
+bool SensorDataReader::Open(std::string fileName)
+{
+  Close();
+
+  file_ = H5Fopen(fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file_ < 0) return false;
+
+  if (H5Lexists(file_, "/MC/sns_events", H5P_DEFAULT) <= 0) {
+    H5Fclose(file_);
+    return false;
+  }
+
+  snsEventTable_  = H5Dopen2(file_, "/MC/sns_events",  H5P_DEFAULT);
+  snsSensorTable_ = H5Dopen2(file_, "/MC/sns_sensors", H5P_DEFAULT);
+  snsRunTable_    = H5Dopen2(file_, "/MC/sns_runs",    H5P_DEFAULT);
+  snsChargeTable_ = H5Dopen2(file_, "/MC/sns_charges", H5P_DEFAULT);
+
+  memtypeSnsEvent_  = createSensorEventType();
+  memtypeSnsSensor_ = createSensorBlockType();
+  memtypeSnsRun_    = createSensorRunType();
+
+  hid_t space = H5Dget_space(snsEventTable_);
+  hsize_t dims[1];
+  H5Sget_simple_extent_dims(space, dims, NULL);
+  H5Sclose(space);
+  nevents_ = dims[0];
+
+  // The IDs of all the events, read at once. Files of a single run
+  // store them in increasing order, but those of several runs or of
+  // replayed events need not.
+  hid_t memtypeId = H5Tcreate(H5T_COMPOUND, sizeof(int64_t));
+  H5Tinsert(memtypeId, "event_id", 0, H5T_NATIVE_INT64);
+  eventIds_.resize(nevents_);
+  bool ok = readRows(eventIds_.data(), nevents_, snsEventTable_, memtypeId, 0);
+  H5Tclose(memtypeId);
+  sorted_ = std::is_sorted(eventIds_.begin(), eventIds_.end());
+
+  isOpen_ = true;
+  if (!ok) Close();
+  return ok;
+}
+
+void SensorDataReader::Close()
+{
+  if (!isOpen_) return;
+
+  H5Tclose(memtypeSnsEvent_);
+  H5Tclose(memtypeSnsSensor_);
+  H5Tclose(memtypeSnsRun_);
+  H5Dclose(snsEventTable_);
+  H5Dclose(snsSensorTable_);
+  H5Dclose(snsRunTable_);
+  H5Dclose(snsChargeTable_);
+  H5Fclose(file_);
+
+  isOpen_ = false;
+  nevents_ = 0;
+  eventIds_.clear();
+}
+
+uint64_t SensorDataReader::GetNumberOfEvents() const
+{
+  return nevents_;
+}
+
+bool SensorDataReader::ReadEvent(uint64_t index, int64_t& event_id,
+                                 std::vector<Sample>& samples) const
+{
+  samples.clear();
+  if (!isOpen_ || index >= nevents_) return false;
+
+  sns_event_t snsEvent;
+  if (!readRows(&snsEvent, 1, snsEventTable_, memtypeSnsEvent_, index))
+    return false;
+  event_id = snsEvent.event_id;
+
+  if (snsEvent.nsensors == 0) return true;
+
+  // The sensors of an event, their runs and the charges
+  // of the runs are contiguous blocks of each table
+  std::vector<sns_sensor_t> snsSensors(snsEvent.nsensors);
+  if (!readRows(snsSensors.data(), snsSensors.size(), snsSensorTable_,
+                memtypeSnsSensor_, snsEvent.first_sensor))
+    return false;
+
+  const sns_sensor_t& last_sensor = snsSensors.back();
+  uint64_t first_run = snsSensors.front().first_run;
+  std::vector<sns_run_t> snsRuns(last_sensor.first_run + last_sensor.nruns - first_run);
+  if (!readRows(snsRuns.data(), snsRuns.size(), snsRunTable_,
+                memtypeSnsRun_, first_run))
+    return false;
+
+  const sns_run_t& last_run = snsRuns.back();
+  uint64_t first_charge = snsRuns.front().first_charge;
+  std::vector<unsigned int> snsCharges(last_run.first_charge + last_run.nbins - first_charge);
+  if (!readRows(snsCharges.data(), snsCharges.size(), snsChargeTable_,
+                H5T_NATIVE_UINT, first_charge))
+    return false;
+
+  samples.reserve(snsCharges.size());
+  for (const sns_sensor_t& sensor: snsSensors) {
+    for (unsigned int r=0; r<sensor.nruns; r++) {
+      const sns_run_t& run = snsRuns[sensor.first_run - first_run + r];
+      for (unsigned int b=0; b<run.nbins; b++) {
+        Sample sample;
+        sample.sensor_id = sensor.sensor_id;
+        sample.time_bin = run.time_bin + b;
+        sample.charge = snsCharges[run.first_charge - first_charge + b];
+        samples.push_back(sample);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool SensorDataReader::FindEvent(int64_t event_id, uint64_t& index) const
+{
+  if (!isOpen_) return false;
+
+  // Binary search if the IDs are in increasing order, linear otherwise
+  std::vector<int64_t>::const_iterator it;
+  if (sorted_)
+    it = std::lower_bound(eventIds_.begin(), eventIds_.end(), event_id);
+  else
+    it = std::find(eventIds_.begin(), eventIds_.end(), event_id);
+
+  if (it == eventIds_.end() || *it != event_id) return false;
+  index = it - eventIds_.begin();
+  return true;
+}
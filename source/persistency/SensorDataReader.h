@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDataReader.h
+//
+// This class reads the sensor response of single events from nexus
+// output files written with the sparse layout (sparse_sensor_data).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_DATA_READER_H
+#define SENSOR_DATA_READER_H
+
+#include "hdf5_functions.h"
+
+#include <hdf5.h>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  class SensorDataReader {
+
+  public:
+    /// One time bin of a sensor
+    struct Sample {
+      unsigned int sensor_id;
+      uint64_t time_bin;
+      unsigned int charge;
+    };
+
+    /// constructor
+    SensorDataReader();
+    /// destructor
+    ~SensorDataReader();
+
+    /// open file, returning false if it has no sparse sensor response
+    bool Open(std::string filename);
+
+    /// close file
+    void Close();
+
+    /// number of events in the file
+    uint64_t GetNumberOfEvents() const;
+
+    /// read the response of the n-th event of the file, with a fixed
+    /// number of reads regardless of the size of the file
+    bool ReadEvent(uint64_t index, int64_t& event_id,
+                   std::vector<Sample>& samples) const;
+
+    /// find the position in the file of an event, given its ID (the
+    /// first one, if several events share it)
+    bool FindEvent(int64_t event_id, uint64_t& index) const;
+
+  private:
+    hid_t file_; ///< HDF5 file
+
+    bool isOpen_;
+
+    //Datasets
+    hid_t snsEventTable_;
+    hid_t snsSensorTable_;
+    hid_t snsRunTable_;
+    hid_t snsChargeTable_;
+
+    hid_t memtypeSnsEvent_;
+    hid_t memtypeSnsSensor_;
+    hid_t memtypeSnsRun_;
+
+    uint64_t nevents_; ///< number of events in the file
+
+    std::vector<int64_t> eventIds_; ///< IDs of the events, in file order
+    bool sorted_; ///< the IDs are in increasing order
+  };
+
+} // namespace nexus
+
+#endif
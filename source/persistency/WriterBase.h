@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------------------
+// nexus | WriterBase.h
+//
+// This is an abstract base class for the output file formats used by
+// the persistency manager.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef WRITER_BASE_H
+#define WRITER_BASE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace nexus {
+
+  /// Abstract base class of the output file writers. The persistency
+  /// manager fills the output through this interface only, so the
+  /// format is chosen with /nexus/persistency/output_format.
+
+  class WriterBase {
+
+  public:
+    /// destructor
+    virtual ~WriterBase() {}
+
+    /// extension added to the name of the output file
+    virtual std::string GetExtension() const = 0;
+
+    /// open file
+    virtual void Open(std::string filename, bool debug, bool save_str,
+                      bool light_table=false, bool sparse_sns=false,
+                      bool event_info=false) = 0;
+
+    /// close file
+    virtual void Close() = 0;
+
+    /// Flush the file to disk and return the position reached by
+    /// the writer, to be passed to Resume. Called between events.
+    /// Whether the file can be resumed after a crash depends on
+    /// the format (see the writers)
+    virtual std::string Checkpoint() = 0;
+
+    /// Open an existing file, with the same options as when it was
+    /// created, and continue writing at a position returned by
+    /// Checkpoint. Anything written after that position is dropped
+    virtual void Resume(std::string filename, bool debug, bool save_str,
+                        bool light_table, bool sparse_sns, bool event_info,
+                        const std::string& position) = 0;
+
+    virtual void WriteRunInfo(const char* param_key, const char* param_value) = 0;
+    virtual void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge) = 0;
+    /// Sparse layout: (time bin, charge) pairs of a sensor, sorted by time bin
+    virtual void WriteSensorWaveform(unsigned int sensor_id, const std::vector<std::pair<unsigned int, float>>& data) = 0;
+    /// Sparse layout: end of the sensor response of an event
+    virtual void WriteSensorEvent(int64_t evt_number) = 0;
+    virtual void WriteHitInfo(bool str, int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label_str, int label) = 0;
+    virtual void WriteParticleInfo(bool str, int64_t evt_number, int particle_indx, const char* particle_name_str, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume_str, const char* final_volume_str, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc_str, const char* final_proc_str, int creator_proc, int final_proc) = 0;
+    virtual void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z) = 0;
+    virtual void WriteStep(int64_t evt_number,
+                           int particle_id, const char* particle_name,
+                           int step_id,
+                           const char* initial_volume,
+                           const char*   final_volume,
+                           const char*      proc_name,
+                           float initial_x, float initial_y, float initial_z,
+                           float   final_x, float   final_y, float   final_z,
+                           float time) = 0;
+    virtual void WriteStringMapInfo(const char* name, int name_id) = 0;
+    virtual void WriteLightTablePoint(unsigned int point_id, float x, float y, float z, uint64_t nphotons) = 0;
+    virtual void WriteLightTableProb(unsigned int point_id, unsigned int sensor_id, uint64_t charge, float probability) = 0;
+    /// Whether the event passed the selection, for all the events with
+    /// an ID, and the seed of the event (0 without event seeding)
+    virtual void WriteEventInfo(int64_t evt_number, char selected, uint64_t seed) = 0;
+  };
+
+} // namespace nexus
+
+#endif
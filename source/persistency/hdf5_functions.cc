@@ -33,6 +33,39 @@ hsize_t createSensorDataType()
 }
 
 
+hsize_t createSensorEventType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_event_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (sns_event_t, event_id), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "first_sensor", HOFFSET (sns_event_t, first_sensor), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "nsensors", HOFFSET (sns_event_t, nsensors), H5T_NATIVE_UINT);
+  return memtype;
+}
+
+
+hsize_t createSensorBlockType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_sensor_t));
+  H5Tinsert (memtype, "sensor_id", HOFFSET (sns_sensor_t, sensor_id), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "first_run", HOFFSET (sns_sensor_t, first_run), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "nruns", HOFFSET (sns_sensor_t, nruns), H5T_NATIVE_UINT);
+  return memtype;
+}
+
+
+hsize_t createSensorRunType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_run_t));
+  H5Tinsert (memtype, "time_bin", HOFFSET (sns_run_t, time_bin), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "first_charge", HOFFSET (sns_run_t, first_charge), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "nbins", HOFFSET (sns_run_t, nbins), H5T_NATIVE_UINT);
+  return memtype;
+}
+
+
 hsize_t createHitInfoType(bool str)
 {
   hid_t strtype = H5Tcopy(H5T_C_S1);
@@ -169,6 +202,39 @@ hsize_t createStringMapType()
   return memtype;
 }
 
+hsize_t createLightTablePointType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(lt_point_t));
+  H5Tinsert (memtype, "point_id", HOFFSET(lt_point_t, point_id), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "x"       , HOFFSET(lt_point_t, x       ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "y"       , HOFFSET(lt_point_t, y       ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "z"       , HOFFSET(lt_point_t, z       ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "nphotons", HOFFSET(lt_point_t, nphotons), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
+hsize_t createLightTableProbType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(lt_prob_t));
+  H5Tinsert (memtype, "point_id"   , HOFFSET(lt_prob_t, point_id   ), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "sensor_id"  , HOFFSET(lt_prob_t, sensor_id  ), H5T_NATIVE_UINT);
+  H5Tinsert (memtype, "charge"     , HOFFSET(lt_prob_t, charge     ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "probability", HOFFSET(lt_prob_t, probability), H5T_NATIVE_FLOAT);
+  return memtype;
+}
+
+hsize_t createEventInfoType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_info_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_info_t, event_id), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "selected", HOFFSET (event_info_t, selected), H5T_NATIVE_CHAR);
+  H5Tinsert (memtype, "seed", HOFFSET (event_info_t, seed), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
 hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
@@ -204,6 +270,30 @@ hid_t createGroup(hid_t file, std::string& groupName)
   return wfgroup;
 }
 
+hid_t openTable(hid_t group, std::string& table_name)
+{
+  //Open an existing dataset, to append rows to it
+  return H5Dopen2(group, table_name.c_str(), H5P_DEFAULT);
+}
+
+hid_t openGroup(hid_t file, std::string& groupName)
+{
+  return H5Gopen2(file, groupName.c_str(), H5P_DEFAULT);
+}
+
+bool truncateTable(hid_t dataset, hsize_t nrows)
+{
+  //Drop the rows after the first nrows, failing if there are fewer
+  hsize_t dims[1];
+  hid_t file_space = H5Dget_space(dataset);
+  H5Sget_simple_extent_dims(file_space, dims, NULL);
+  H5Sclose(file_space);
+  if (dims[0] < nrows) return false;
+
+  dims[0] = nrows;
+  return H5Dset_extent(dataset, dims) >= 0;
+}
+
 void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter)
 {
   hid_t memspace, file_space;
@@ -246,6 +336,53 @@ void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t cou
   H5Sclose(memspace);
 }
 
+void writeRows(const void* data, hsize_t nrows, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  if (nrows == 0) return;
+
+  hid_t memspace, file_space;
+  //Create memspace for nrows more rows
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {nrows};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  //Extend dataset
+  dims[0] = counter+nrows;
+  H5Dset_extent(dataset, dims);
+
+  //Write rows
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {nrows};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+
+bool readRows(void* data, hsize_t nrows, hid_t dataset, hid_t memtype, hsize_t first)
+{
+  if (nrows == 0) return true;
+
+  //Create memspace for nrows rows
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {nrows};
+  hid_t memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  //Read rows
+  hid_t file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {first};
+  hsize_t count[1] = {nrows};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  herr_t status = H5Dread(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+
+  return status >= 0;
+}
+
+
 void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter)
 {
   hid_t memspace, file_space;
@@ -347,3 +484,43 @@ void writeStringMap(string_map_t* strmap, hid_t dataset, hid_t memtype, hsize_t
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void writeLtPoint(lt_point_t* ltPoint, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, ltPoint);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeLtProb(lt_prob_t* ltProb, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, ltProb);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
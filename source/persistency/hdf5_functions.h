@@ -27,6 +27,27 @@
     unsigned int charge;
   } sns_data_t;
 
+  // Sparse layout of the sensor response: each event points to a block
+  // of sensors, each sensor to a block of runs of consecutive time bins,
+  // and each run to a block of charges
+  typedef struct{
+    int64_t event_id;
+    uint64_t first_sensor;
+    unsigned int nsensors;
+  } sns_event_t;
+
+  typedef struct{
+    unsigned int sensor_id;
+    uint64_t first_run;
+    unsigned int nruns;
+  } sns_sensor_t;
+
+  typedef struct{
+    uint64_t time_bin;
+    uint64_t first_charge;
+    unsigned int nbins;
+  } sns_run_t;
+
   typedef struct{
         int64_t event_id;
 	float x;
@@ -103,24 +124,58 @@ typedef struct{
   int32_t name_id;
 } string_map_t;
 
+typedef struct{
+  unsigned int point_id;
+  float x;
+  float y;
+  float z;
+  uint64_t nphotons;
+} lt_point_t;
+
+typedef struct{
+  unsigned int point_id;
+  unsigned int sensor_id;
+  uint64_t charge;
+  float probability;
+} lt_prob_t;
+
+  typedef struct{
+    int64_t event_id;
+    char selected;
+    uint64_t seed;
+  } event_info_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
+  hsize_t createSensorEventType();
+  hsize_t createSensorBlockType();
+  hsize_t createSensorRunType();
   hsize_t createHitInfoType(bool str);
   hsize_t createParticleInfoType(bool str);
   hsize_t createSensorPosType();
   hsize_t createStepType();
   hsize_t createStringMapType();
+  hsize_t createLightTablePointType();
+  hsize_t createLightTableProbType();
+  hsize_t createEventInfoType();
 
   hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
   hid_t createGroup(hid_t file, std::string& groupName);
+  hid_t openTable(hid_t group, std::string& table_name);
+  hid_t openGroup(hid_t file, std::string& groupName);
+  bool truncateTable(hid_t dataset, hsize_t nrows);
 
   void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeRows(const void* data, hsize_t nrows, hid_t dataset, hid_t memtype, hsize_t counter);
+  bool readRows(void* data, hsize_t nrows, hid_t dataset, hid_t memtype, hsize_t first);
   void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStringMap(string_map_t* strmap, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeLtPoint(lt_point_t* ltPoint, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeLtProb(lt_prob_t* ltProb, hid_t dataset, hid_t memtype, hsize_t counter);
 
 
 #endif
@@ -9,6 +9,8 @@
 #ifndef BASE_DRIFT_FIELD_H
 #define BASE_DRIFT_FIELD_H
 
+#include "ElectronBatch.h"
+
 #include <G4VUserRegionInformation.hh>
 #include <G4LorentzVector.hh>
 #include <G4Types.hh>
@@ -35,6 +37,16 @@ namespace nexus {
     /// drifting under the influence of the field. Returns the step length.
     virtual G4double Drift(G4LorentzVector&) = 0;
 
+    /// Same as Drift for a cluster of electrons moving together, whose
+    /// diffusion is that of their centroid. By default, the number of
+    /// electrons is ignored.
+    virtual G4double DriftCluster(G4LorentzVector&, G4double nelectrons);
+
+    /// Drifts every electron of the batch to its final position and
+    /// time, removing those that do not move or get attached.
+    /// By default, DriftCluster is called for each of them.
+    virtual void DriftBatch(ElectronBatch&);
+
     /// Returns a random 4D point (space and time) along a drift line
     virtual G4LorentzVector 
       GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&) = 0;
@@ -52,6 +64,22 @@ namespace nexus {
   
   inline BaseDriftField::~BaseDriftField() {}
 
+  inline G4double BaseDriftField::DriftCluster(G4LorentzVector& xyzt, G4double)
+  {
+    return Drift(xyzt);
+  }
+
+  inline void BaseDriftField::DriftBatch(ElectronBatch& batch)
+  {
+    std::vector<char> alive(batch.Size());
+    for (std::size_t i=0; i<batch.Size(); ++i) {
+      G4LorentzVector xyzt = batch.Get(i);
+      alive[i] = (DriftCluster(xyzt, batch.w[i]) > 0.);
+      batch.Set(i, xyzt, batch.w[i]);
+    }
+    batch.Compact(alive);
+  }
+
   inline G4double BaseDriftField::LightYield() const {return 0.;}
 
   inline G4double BaseDriftField::GetTotalDriftLength() const {return 0.;}
@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// nexus | DetectionPreSampling.cc
+//
+// Pre-sampling of the photon detection efficiency at emission.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "DetectionPreSampling.h"
+
+#include <G4SurfaceProperty.hh>
+#include <G4OpticalSurface.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4ParticleTable.hh>
+#include <G4ProcessManager.hh>
+#include <G4Scintillation.hh>
+#include <G4Cerenkov.hh>
+
+#include <algorithm>
+#include <set>
+
+
+namespace nexus {
+
+  namespace {
+    G4bool   enabled_     = false;
+    G4bool   initialized_ = false;
+    G4double survival_    = 1.;
+
+    /// Stops the job if an active process other than those that
+    /// pre-sample produces optical photons. Wavelength shifting
+    /// is fine: its photons come from photons already sampled.
+    void CheckPhotonSources()
+    {
+      G4ParticleTable::G4PTblDicIterator* particles =
+        G4ParticleTable::GetParticleTable()->GetIterator();
+      particles->reset();
+
+      while ((*particles)()) {
+        G4ProcessManager* pmanager = particles->value()->GetProcessManager();
+        if (!pmanager) continue;
+
+        G4ProcessVector* processes = pmanager->GetProcessList();
+        for (size_t i=0; i<processes->size(); ++i) {
+          G4VProcess* process = (*processes)[i];
+          if (!dynamic_cast<G4Scintillation*>(process) &&
+              !dynamic_cast<G4Cerenkov*>(process)) continue;
+          if (!pmanager->GetProcessActivation(process)) continue;
+
+          G4String msg = "Process " + process->GetProcessName() + " of " +
+            particles->value()->GetParticleName() + " produces optical photons "
+            "without detection pre-sampling. Inactivate it or disable "
+            "/PhysicsList/Nexus/pde_presampling.";
+          G4Exception("[DetectionPreSampling]", "CheckPhotonSources()",
+                      FatalException, msg);
+        }
+      }
+    }
+
+    /// Finds the largest efficiency of the optical surfaces and
+    /// divides all of them by it
+    void RenormalizeEfficiencies()
+    {
+      // Property vectors may be shared by several surfaces
+      std::set<G4MaterialPropertyVector*> efficiencies;
+
+      const G4SurfacePropertyTable* surfaces =
+        G4SurfaceProperty::GetSurfacePropertyTable();
+
+      for (G4SurfaceProperty* property: *surfaces) {
+        G4OpticalSurface* surface = dynamic_cast<G4OpticalSurface*>(property);
+        if (!surface) continue;
+        G4MaterialPropertiesTable* mpt = surface->GetMaterialPropertiesTable();
+        if (!mpt) continue;
+        G4MaterialPropertyVector* efficiency = mpt->GetProperty("EFFICIENCY");
+        if (efficiency) efficiencies.insert(efficiency);
+      }
+
+      G4double max_efficiency = 0.;
+      for (G4MaterialPropertyVector* efficiency: efficiencies)
+        max_efficiency = std::max(max_efficiency, efficiency->GetMaxValue());
+
+      if (max_efficiency <= 0. || max_efficiency >= 1.) return;
+
+      for (G4MaterialPropertyVector* efficiency: efficiencies)
+        efficiency->ScaleVector(1., 1. / max_efficiency);
+
+      survival_ = max_efficiency;
+
+      G4cout << "[DetectionPreSampling] Photons kept at emission with probability "
+             << survival_ << G4endl;
+    }
+  }
+
+
+
+  void EnableDetectionPreSampling(G4bool enable)
+  {
+    if (initialized_ && enable != enabled_) {
+      G4Exception("[DetectionPreSampling]", "EnableDetectionPreSampling()",
+                  JustWarning, "Detection pre-sampling cannot change once in use.");
+      return;
+    }
+    enabled_ = enable;
+  }
+
+
+
+  G4bool DetectionPreSamplingEnabled()
+  {
+    return enabled_;
+  }
+
+
+
+  G4double DetectionSurvivalProbability()
+  {
+    if (!enabled_) return 1.;
+
+    if (!initialized_) {
+      initialized_ = true;
+      CheckPhotonSources();
+      RenormalizeEfficiencies();
+    }
+
+    return survival_;
+  }
+
+} // end namespace nexus
@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+// nexus | DetectionPreSampling.h
+//
+// Pre-sampling of the photon detection efficiency at emission.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DETECTION_PRE_SAMPLING_H
+#define DETECTION_PRE_SAMPLING_H
+
+#include <globals.hh>
+
+
+namespace nexus {
+
+  /// When pre-sampling is enabled, the first call to
+  /// DetectionSurvivalProbability divides the EFFICIENCY of all the
+  /// optical surfaces of the geometry by the largest value found among
+  /// them, and returns that value. The photon sources that pre-sample
+  /// (Electroluminescence and ScintillationGenerator) keep each photon
+  /// with this probability, so that the detected photons follow the
+  /// same statistics with fewer tracked photons. Optical photons from
+  /// any other source would be detected too often: the first call
+  /// raises a FatalException if G4Scintillation or G4Cerenkov is
+  /// active for any particle. It is made by NexusApp before each run.
+
+  void EnableDetectionPreSampling(G4bool);
+  G4bool DetectionPreSamplingEnabled();
+
+  /// Probability of keeping a photon at emission (1 if disabled)
+  G4double DetectionSurvivalProbability();
+
+} // end namespace nexus
+
+#endif
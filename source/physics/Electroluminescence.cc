@@ -10,6 +10,7 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "DetectionPreSampling.h"
 
 #include <G4MaterialPropertiesTable.hh>
 #include <G4ParticleChange.hh>
@@ -27,7 +28,7 @@ using namespace CLHEP;
 
 Electroluminescence::Electroluminescence(const G4String& process_name,
 					                               G4ProcessType type):
-  G4VDiscreteProcess(process_name, type), theFastIntegralTable_(0),
+  G4VDiscreteProcess(process_name, type),
   table_generation_(false), photons_per_point_(0)
 {
   ParticleChange_ = new G4ParticleChange();
@@ -49,7 +50,6 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
 
 Electroluminescence::~Electroluminescence()
 {
-  delete theFastIntegralTable_;
 }
 
 
@@ -84,8 +84,11 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   if (yield <= 0.)
     return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  // Generate a random number of photons around mean 'yield'
-  G4double mean = yield * step_length;
+  // Generate a random number of photons around mean 'yield',
+  // times the number of electrons the track stands for and
+  // the fraction of them kept for detection
+  const G4double survival = DetectionSurvivalProbability();
+  G4double mean = yield * step_length * track.GetWeight() * survival;
 
   G4int num_photons;
 
@@ -98,7 +101,9 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   }
 
   if (table_generation_)
-    num_photons = photons_per_point_;
+    num_photons = (survival < 1.) ?
+      G4int(CLHEP::RandBinomial::shoot(photons_per_point_, survival)) :
+      photons_per_point_;
 
   ParticleChange_->SetNumberOfSecondaries(num_photons);
 
@@ -117,19 +122,16 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   G4double time_end = step.GetPostStepPoint()->GetGlobalTime();
   G4LorentzVector final_position(position_end, time_end);
 
-  // Energy is sampled from integral (like it is
-  // done in G4Scintillation)
+  // Energies are sampled from the EL spectrum of the material,
+  // all at once for the photons of the step
   G4Material* mat = step.GetPostStepPoint()->GetTouchable()->GetVolume()->GetLogicalVolume()->GetMaterial();
-  G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
-  const G4MaterialPropertyVector* spectrum = mpt->GetProperty("ELSPECTRUM");
-
-  if (!spectrum) return G4VDiscreteProcess::PostStepDoIt(track, step);
-
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    (G4PhysicsOrderedFreeVector*)(*theFastIntegralTable_)(mat->GetIndex());
-
+  if (mat->GetIndex() >= spectra_.size() || spectra_[mat->GetIndex()].IsEmpty())
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  if (num_photons > 0) {
+    energies_.resize(num_photons);
+    spectra_[mat->GetIndex()].Shoot(num_photons, energies_.data());
+  }
 
   for (G4int i=0; i<num_photons; i++) {
     // Generate a random direction for the photon
@@ -169,10 +171,7 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
     photon->
       SetPolarization(polarization.x(), polarization.y(), polarization.z());
 
-    // Determine photon energy
-    G4double sc_value = G4UniformRand()*sc_max;
-    G4double sampled_energy = spectrum_integral->GetEnergy(sc_value);
-    photon->SetKineticEnergy(sampled_energy);
+    photon->SetKineticEnergy(energies_[i]);
 
     G4LorentzVector xyzt =
       field->GeneratePointAlongDriftLine(initial_position, final_position);
@@ -191,59 +190,24 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 
 void Electroluminescence::BuildThePhysicsTable()
 {
-  if (theFastIntegralTable_) return;
+  if (!spectra_.empty()) return;
 
   const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
   G4int numOfMaterials = G4Material::GetNumberOfMaterials();
 
-  // create new physics table
-
-  if(!theFastIntegralTable_)
-    theFastIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+  spectra_.resize(numOfMaterials);
 
   for (G4int i=0 ; i<numOfMaterials; i++) {
 
-  	G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-  	  new G4PhysicsOrderedFreeVector();
-
-  	// Retrieve vector of scintillation wavelength intensity for
-  	// the material from the material's optical properties table.
-
-  	G4Material* material = (*theMaterialTable)[i];
+    // Retrieve vector of EL wavelength intensity for
+    // the material from the material's optical properties table.
+    G4Material* material = (*theMaterialTable)[i];
 
     G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    if (!mpt) continue;
 
-    if (mpt) {
-
-  	  G4MaterialPropertyVector* theFastLightVector =
-  	    mpt->GetProperty("ELSPECTRUM");
-
-  	  if (theFastLightVector) {
-        ComputeCumulativeDistribution(*theFastLightVector, *aPhysicsOrderedFreeVector);
-		  }
-  	}
-
-  	// The scintillation integral(s) for a given material
-  	// will be inserted in the table(s) according to the
-  	// position of the material in the material table.
-
-  	theFastIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
-  }
-}
-
-
-
-void Electroluminescence::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
-{
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+    G4MaterialPropertyVector* spectrum = mpt->GetProperty("ELSPECTRUM");
+    if (spectrum) spectra_[i] = SpectrumSampler(*spectrum);
   }
 }
 
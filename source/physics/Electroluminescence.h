@@ -9,8 +9,9 @@
 #ifndef ELECTROLUMINESCENCE_H
 #define ELECTROLUMINESCENCE_H
 
+#include "SpectrumSampler.h"
+
 #include <G4VDiscreteProcess.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
 
 class G4ParticleChange;
 class G4GenericMessenger;
@@ -44,13 +45,13 @@ namespace nexus {
     G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
 
   private:
     G4ParticleChange* ParticleChange_;
 
-    G4PhysicsTable* theFastIntegralTable_;
+    /// EL spectrum of each material, by material index
+    std::vector<SpectrumSampler> spectra_;
+    std::vector<G4double> energies_; ///< Energies of the photons of a step
 
     G4GenericMessenger* msg_;
 
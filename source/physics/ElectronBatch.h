@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+// nexus | ElectronBatch.h
+//
+// Set of ionization electrons stored as a structure of arrays, so that
+// they can be drifted in bulk without creating a track for each of them.
+// Each entry may stand for several electrons, given by its weight.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ELECTRON_BATCH_H
+#define ELECTRON_BATCH_H
+
+#include <G4LorentzVector.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class ElectronBatch
+  {
+  public:
+    std::size_t Size() const;
+
+    void Resize(std::size_t);
+    void Clear();
+
+    /// Sets the space-time position and weight of an electron
+    void Set(std::size_t, const G4LorentzVector&, G4double weight=1.);
+    /// Returns the space-time position of an electron
+    G4LorentzVector Get(std::size_t) const;
+
+    /// Removes the electrons whose flag is false,
+    /// keeping the order of the others
+    void Compact(const std::vector<char>& keep);
+
+  public:
+    std::vector<G4double> x, y, z, t, w;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline std::size_t ElectronBatch::Size() const
+  { return t.size(); }
+
+  inline void ElectronBatch::Resize(std::size_t n)
+  { x.resize(n); y.resize(n); z.resize(n); t.resize(n); w.resize(n); }
+
+  inline void ElectronBatch::Clear()
+  { Resize(0); }
+
+  inline void ElectronBatch::Set(std::size_t i, const G4LorentzVector& p,
+                                 G4double weight)
+  { x[i] = p.x(); y[i] = p.y(); z[i] = p.z(); t[i] = p.t(); w[i] = weight; }
+
+  inline G4LorentzVector ElectronBatch::Get(std::size_t i) const
+  { return G4LorentzVector(x[i], y[i], z[i], t[i]); }
+
+  inline void ElectronBatch::Compact(const std::vector<char>& keep)
+  {
+    std::size_t n = 0;
+    for (std::size_t i=0; i<Size(); ++i) {
+      if (!keep[i]) continue;
+      x[n] = x[i]; y[n] = y[i]; z[n] = z[i]; t[n] = t[i]; w[n] = w[i];
+      ++n;
+    }
+    Resize(n);
+  }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,270 @@
+// ----------------------------------------------------------------------------
+// nexus | FieldMapDriftField.cc
+//
+// Drift field described by a precomputed map of drift velocity,
+// diffusion and end-point distortion, given on a regular 3D (x, y, z)
+// or r-z grid. The map is a binary file (see
+// scripts/create_drift_field_map.py) that is memory-mapped, and thus
+// shared by all the processes reading it.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "FieldMapDriftField.h"
+#include "SegmentPointSampler.h"
+#include "IOUtils.h"
+
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "CLHEP/Units/SystemOfUnits.h"
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+  namespace {
+
+    // Layout of the map file: header followed by n[0]*n[1]*n[2] nodes
+    // of 5 floats each, with the first coordinate running fastest.
+    // Positions and displacements are in mm, velocities in mm/us and
+    // diffusion constants in mm/sqrt(cm).
+    const char     kMapMagic[8] = {'N','X','D','R','I','F','T','\0'};
+    const uint32_t kMapVersion  = 1;
+
+    struct MapHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t ndim;    ///< 3 for x-y-z maps, 2 for r-z maps
+      uint64_t n[3];
+      double   min[3];
+      double   step[3];
+    };
+
+  }
+
+
+
+  FieldMapDriftField::FieldMapDriftField(const G4String& filename,
+                                         G4double anode_position,
+                                         G4double cathode_position):
+    BaseDriftField(),
+    file_(new MappedFile(filename)), nodes_(nullptr), rz_(false),
+    anode_pos_(anode_position), cathode_pos_(cathode_position),
+    lifetime_(1.e9*s)
+  {
+    if (!file_->IsOpen() || file_->Size() < sizeof(MapHeader)) {
+      G4Exception("[FieldMapDriftField]", "FieldMapDriftField()",
+                  FatalException, ("Cannot read drift field map " + filename).c_str());
+    }
+
+    MapHeader header;
+    std::memcpy(&header, file_->Data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kMapMagic, sizeof(kMapMagic)) != 0 ||
+        header.version != kMapVersion ||
+        (header.ndim != 2 && header.ndim != 3)) {
+      G4Exception("[FieldMapDriftField]", "FieldMapDriftField()",
+                  FatalException, ("Invalid drift field map " + filename).c_str());
+    }
+
+    rz_ = (header.ndim == 2);
+    if (rz_) header.n[2] = 1;
+
+    std::size_t nnodes = 1;
+    for (G4int i=0; i<3; ++i) {
+      axis_[i] = GridAxis::Regular(header.min[i] * mm, header.step[i] * mm,
+                                   G4int(header.n[i]));
+      nnodes  *= header.n[i];
+      if (header.n[i] < 1 || (header.n[i] > 1 && header.step[i] <= 0.)) {
+        G4Exception("[FieldMapDriftField]", "FieldMapDriftField()",
+                    FatalException, ("Invalid grid in drift field map " + filename).c_str());
+      }
+    }
+
+    if (file_->Size() != sizeof(MapHeader) + nnodes * kNumFields * sizeof(float)) {
+      G4Exception("[FieldMapDriftField]", "FieldMapDriftField()",
+                  FatalException, ("Truncated drift field map " + filename).c_str());
+    }
+
+    nodes_ = reinterpret_cast<const float*>(file_->Data() + sizeof(MapHeader));
+
+    // initialize random generator with dummy values
+    rnd_ = new SegmentPointSampler(G4LorentzVector(0.,0.,0.,-999.),
+                                   G4LorentzVector(0.,0.,0.,-999.));
+  }
+
+
+
+  FieldMapDriftField::~FieldMapDriftField()
+  {
+    delete rnd_;
+  }
+
+
+
+  void FieldMapDriftField::Interpolate(const G4ThreeVector& pos,
+                                       G4double* values) const
+  {
+    G4double coord[3];
+    if (rz_) {
+      coord[0] = pos.perp();
+      coord[1] = pos.z();
+      coord[2] = 0.;
+    }
+    else {
+      coord[0] = pos.x();
+      coord[1] = pos.y();
+      coord[2] = pos.z();
+    }
+
+    // Cell containing the point and fractional position inside it,
+    // clamped to the boundaries of the map
+    G4int    idx[3];
+    G4double frac[3];
+    for (G4int d=0; d<3; ++d) {
+      if (axis_[d].n == 1) {
+        idx[d]  = 0;
+        frac[d] = 0.;
+        continue;
+      }
+      frac[d] = std::min(std::max(axis_[d].Locate(coord[d], idx[d]), 0.), 1.);
+    }
+
+    for (G4int f=0; f<kNumFields; ++f) values[f] = 0.;
+
+    // Weighted sum over the corners of the cell (the two nodes along
+    // the first coordinate are contiguous). The fields of a node are
+    // interleaved floats in the mapped file, hence the sum is done here
+    // for all of them at once instead of calling Interpolate3D.
+    for (G4int k=0; k<2; ++k) {
+      if (k == 1 && axis_[2].n == 1) break;
+      const G4double wz = k ? frac[2] : 1. - frac[2];
+      for (G4int j=0; j<2; ++j) {
+        if (j == 1 && axis_[1].n == 1) break;
+        const G4double wy = j ? frac[1] : 1. - frac[1];
+        for (G4int i=0; i<2; ++i) {
+          if (i == 1 && axis_[0].n == 1) break;
+          const G4double w = wz * wy * (i ? frac[0] : 1. - frac[0]);
+          const std::size_t node =
+            (idx[0] + i) + axis_[0].n * ((idx[1] + j) + std::size_t(axis_[1].n) * (idx[2] + k));
+          const float* v = nodes_ + node * kNumFields;
+          for (G4int f=0; f<kNumFields; ++f) values[f] += w * v[f];
+        }
+      }
+    }
+
+    values[kVelocity]      *= mm/microsecond;
+    values[kTransvDiff]    *= mm/std::sqrt(cm);
+    values[kLongitDiff]    *= mm/std::sqrt(cm);
+    values[kDisplacement1] *= mm;
+    values[kDisplacement2] *= mm;
+  }
+
+
+
+  G4double FieldMapDriftField::Drift(G4LorentzVector& xyzt)
+  {
+    return DriftCluster(xyzt, 1.);
+  }
+
+
+
+  G4double FieldMapDriftField::DriftCluster(G4LorentzVector& xyzt,
+                                            G4double nelectrons)
+  {
+    // If the origin is not between anode and cathode,
+    // the charge carrier, obviously, doesn't move.
+    if (!CheckCoordinate(xyzt.z()))
+      return 0.;
+
+    G4double values[kNumFields];
+    Interpolate(xyzt.vect(), values);
+
+    if (values[kVelocity] <= 0.) return 0.;
+
+    // Calculate drift time and distance to anode
+    G4double drift_length = std::abs(xyzt.z() - anode_pos_);
+    G4double drift_time = drift_length / values[kVelocity];
+
+    // Calculate longitudinal and transversal deviation due to diffusion
+    // (of the centroid, for a cluster of electrons)
+    G4double cluster_scale = 1. / std::sqrt(nelectrons);
+    G4double transv_sigma =
+      values[kTransvDiff] * std::sqrt(drift_length) * cluster_scale;
+    G4double longit_sigma =
+      values[kLongitDiff] * std::sqrt(drift_length) * cluster_scale;
+    G4double time_sigma = longit_sigma / values[kVelocity];
+
+    // Arrival point on the anode plane, distorted by the field
+    G4double dx = values[kDisplacement1];
+    G4double dy = values[kDisplacement2];
+    if (rz_) {
+      // Radial and azimuthal displacements
+      G4double r = xyzt.perp();
+      G4double cos_phi = r > 0. ? xyzt.x() / r : 1.;
+      G4double sin_phi = r > 0. ? xyzt.y() / r : 0.;
+      dx = values[kDisplacement1] * cos_phi - values[kDisplacement2] * sin_phi;
+      dy = values[kDisplacement1] * sin_phi + values[kDisplacement2] * cos_phi;
+    }
+
+    G4ThreeVector position(G4RandGauss::shoot(xyzt.x() + dx, transv_sigma),
+                           G4RandGauss::shoot(xyzt.y() + dy, transv_sigma),
+                           DriftEnd());
+
+    G4double time = xyzt.t() + drift_time + G4RandGauss::shoot(0, time_sigma);
+    if (time < 0.) time = xyzt.t() + drift_time;
+
+    G4double time_diff = time - xyzt.t();
+
+    // Calculate step length as euclidean distance between initial
+    // and final positions
+    G4double step_length = (position - xyzt.vect()).mag();
+
+    // Set the new time and position of the drifting charge
+    xyzt.set(time, position);
+
+    G4double rnd = -lifetime_ * std::log(G4UniformRand());
+    if (time_diff > rnd) step_length = 0.;
+
+    return step_length;
+  }
+
+
+
+  G4LorentzVector FieldMapDriftField::GeneratePointAlongDriftLine(const G4LorentzVector& origin,
+                                                                  const G4LorentzVector& end)
+  {
+    rnd_->SetPoints(origin, end);
+    return rnd_->Shoot();
+  }
+
+
+
+  G4double FieldMapDriftField::DriftEnd() const
+  {
+    return anode_pos_ + (anode_pos_ > cathode_pos_ ? 1. : -1.) * micrometer;
+  }
+
+
+
+  G4bool FieldMapDriftField::CheckCoordinate(G4double coord) const
+  {
+    G4double max_coord = std::max(anode_pos_, cathode_pos_);
+    G4double min_coord = std::min(anode_pos_, cathode_pos_);
+
+    return !((coord > max_coord) || (coord < min_coord));
+  }
+
+
+
+  G4double FieldMapDriftField::GetTotalDriftLength() const
+  {
+    return std::abs(anode_pos_ - cathode_pos_);
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+// nexus | FieldMapDriftField.h
+//
+// Drift field described by a precomputed map of drift velocity,
+// diffusion and end-point distortion, given on a regular 3D (x, y, z)
+// or r-z grid. The map is a binary file (see
+// scripts/create_drift_field_map.py) that is memory-mapped, and thus
+// shared by all the processes reading it.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef FIELD_MAP_DRIFT_FIELD_H
+#define FIELD_MAP_DRIFT_FIELD_H
+
+#include "BaseDriftField.h"
+#include "Interpolation.h"
+
+#include <G4String.hh>
+
+#include <memory>
+
+
+namespace nexus {
+
+  class MappedFile;
+  class SegmentPointSampler;
+
+  /// Drift field along the z axis from cathode to anode. Each node of the
+  /// map holds, for an electron starting there, the mean drift velocity
+  /// to the anode, the transverse and longitudinal diffusion constants
+  /// and the displacement of its arrival point on the anode plane.
+  /// Values between nodes are obtained by trilinear (bilinear for r-z
+  /// maps) interpolation; points outside the map take the values of
+  /// its closest boundary.
+
+  class FieldMapDriftField: public BaseDriftField
+  {
+  public:
+    /// Constructor providing the map file and the positions
+    /// of anode and cathode along the z axis
+    FieldMapDriftField(const G4String& filename,
+                       G4double anode_position,
+                       G4double cathode_position);
+
+    /// Destructor
+    ~FieldMapDriftField();
+
+    G4double Drift(G4LorentzVector& xyzt);
+
+    G4double DriftCluster(G4LorentzVector& xyzt, G4double nelectrons);
+
+    G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&,
+                                                const G4LorentzVector&);
+
+    void SetLifetime(G4double);
+    G4double GetLifetime() const;
+
+    virtual G4double GetTotalDriftLength() const;
+
+  private:
+    /// Quantities stored for each node of the map
+    enum { kVelocity, kTransvDiff, kLongitDiff, kDisplacement1,
+           kDisplacement2, kNumFields };
+
+    /// Interpolates all the fields of the map at a given position
+    void Interpolate(const G4ThreeVector&, G4double* values) const;
+
+    /// Returns true if z is between anode and cathode
+    G4bool CheckCoordinate(G4double) const;
+
+    /// Longitudinal coordinate where the drift ends: 1 micron past
+    /// the anode, on the side away from the cathode. The electron is
+    /// then located in the EL region beyond the drift region, whose
+    /// field takes over.
+    G4double DriftEnd() const;
+
+  private:
+    std::unique_ptr<MappedFile> file_;
+    const float* nodes_; ///< kNumFields values per node, x (or r) fastest
+
+    G4bool rz_;        ///< r-z map instead of a 3D one
+    GridAxis axis_[3]; ///< Nodes along each coordinate
+
+    G4double anode_pos_;   ///< Anode position in z
+    G4double cathode_pos_; ///< Cathode position in z
+    G4double lifetime_;    ///< Electron lifetime
+
+    SegmentPointSampler* rnd_;
+  };
+
+
+  // inline methods ..................................................
+
+  inline void FieldMapDriftField::SetLifetime(G4double lt)
+  { lifetime_ = lt; }
+
+  inline G4double FieldMapDriftField::GetLifetime() const
+  { return lifetime_; }
+
+} // end namespace nexus
+
+#endif
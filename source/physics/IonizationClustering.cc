@@ -18,6 +18,10 @@
 #include <Randomize.hh>
 #include <G4LorentzVector.hh>
 #include <G4Gamma.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+
+#include <algorithm>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
@@ -29,11 +33,16 @@ namespace nexus {
 
   IonizationClustering::IonizationClustering(const G4String& process_name,
                                              G4ProcessType type):
-    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0)
+    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0),
+    bulk_drift_(false), cluster_size_(1), material_(0),
+    ioni_energy_(22.4 * eV), fano_factor_(.15)
   {
     // Create particle change object
     ParticleChange_ = new G4ParticleChange();
     pParticleChange = ParticleChange_;
+    // The weight of the ionization electrons is set by the process
+    // (otherwise AddSecondary gives them that of the parent track)
+    ParticleChange_->SetSecondaryWeightByProcess(true);
 
     // Create a segment point sample
     rnd_ = new SegmentPointSampler();
@@ -109,34 +118,20 @@ namespace nexus {
     // and N is the average number of charges.
 
     // Fetch the W_i and F from the material properties table
-    //G4MaterialPropertiesTable* mpt =
-    //  track.GetMaterial()->GetMaterialPropertiesTable();
-    //if (!mpt)
-    //  return G4VRestDiscreteProcess::PostStepDoIt(track, step);
-
-    //G4double ioni_energy = mpt->GetConstProperty("IONIZATIONENERGY");
-    //G4double fano_factor = mpt->GetConstProperty("FANOFACTOR");
-    G4double ioni_energy = 22.4 * eV;
-    G4double fano_factor = .15;
+    if (track.GetMaterial() != material_) SetMaterial(track.GetMaterial());
 
-    G4double mean = energy_dep / ioni_energy;
+    G4double mean = energy_dep / ioni_energy_;
 
     G4int num_charges = 0;
 
     if (mean > 10.) {
-      G4double sigma = sqrt(mean*fano_factor);
+      G4double sigma = sqrt(mean*fano_factor_);
       num_charges = G4int(G4RandGauss::shoot(mean, sigma) + 0.5);
     }
     else {
       num_charges = G4int(G4Poisson(mean));
     }
 
-    ParticleChange_->SetNumberOfSecondaries(num_charges);
-
-    // Track secondaries first
-    if ((track.GetTrackStatus() == fAlive) && num_charges > 0)
-      ParticleChange_->ProposeTrackStatus(fSuspend);
-
     //////////////////////////////////////////////////////////////////
 
     G4ThreeVector momentum_direction(0.,0.,1.);
@@ -149,6 +144,38 @@ namespace nexus {
                   			       step.GetPostStepPoint()->GetGlobalTime());
     rnd_->SetPoints(pre_point, post_point);
 
+    // Group the charges in clusters of cluster_size_ electrons,
+    // the last one taking the remainder. Each cluster is simulated
+    // as a single ie- whose weight is its number of electrons.
+    if (num_charges < 0) num_charges = 0;
+    G4int num_clusters = (num_charges + cluster_size_ - 1) / cluster_size_;
+
+    // Calculate position and time. We distribute the ie- along
+    // the step except for the depositions associated to gammas,
+    // where we use the post-step point.
+    batch_.Resize(num_clusters);
+    for (G4int i=0; i<num_clusters; i++) {
+      G4double weight = std::min(cluster_size_, num_charges - i*cluster_size_);
+      if (track.GetDefinition() == G4Gamma::Definition())
+        batch_.Set(i, post_point, weight);
+      else
+        batch_.Set(i, rnd_->Shoot(), weight);
+    }
+    num_charges = num_clusters;
+
+    // In bulk mode, only the electrons surviving the drift
+    // are tracked, starting from the end of their drift
+    G4bool drifted = BulkDrift(*field);
+    if (drifted) {
+      field->DriftBatch(batch_);
+      num_charges = batch_.Size();
+    }
+
+    ParticleChange_->SetNumberOfSecondaries(num_charges);
+
+    // Track secondaries first
+    if ((track.GetTrackStatus() == fAlive) && num_charges > 0)
+      ParticleChange_->ProposeTrackStatus(fSuspend);
 
     for (G4int i=0; i<num_charges; i++) {
 
@@ -156,18 +183,18 @@ namespace nexus {
         new G4DynamicParticle(IonizationElectron::Definition(),
           momentum_direction, kinetic_energy);
 
-      // Calculate position and time. We distribute the ie- along
-      // the step except for the depositions associated to gammas,
-      // where we use the post-step point.
-      G4LorentzVector point;
-      if (track.GetDefinition() == G4Gamma::Definition()) point = post_point;
-      else point = rnd_->Shoot();
+      G4LorentzVector point = batch_.Get(i);
 
       G4Track* aSecondaryTrack =
         new G4Track(ionielectron, point.t(), point.v());
+      aSecondaryTrack->SetWeight(batch_.w[i] * track.GetWeight());
 
-      aSecondaryTrack->
-        SetTouchableHandle(step.GetPreStepPoint()->GetTouchableHandle());
+      // Drifted electrons have left the volume of the step:
+      // the touchable is left unset and Geant4 locates them
+      // when their tracking starts
+      if (!drifted)
+        aSecondaryTrack->
+          SetTouchableHandle(step.GetPreStepPoint()->GetTouchableHandle());
 
       ParticleChange_->AddSecondary(aSecondaryTrack);
     }
@@ -177,6 +204,44 @@ namespace nexus {
 
 
 
+  G4bool IonizationClustering::BulkDrift(const BaseDriftField& field) const
+  {
+    return bulk_drift_ && field.LightYield() <= 0.;
+  }
+
+
+
+  void IonizationClustering::SetClusterSize(G4int n)
+  {
+    if (n < 1) {
+      G4Exception("[IonizationClustering]", "SetClusterSize()",
+                  FatalErrorInArgument, "Cluster size must be at least 1.");
+    }
+    cluster_size_ = n;
+  }
+
+
+
+  void IonizationClustering::SetMaterial(const G4Material* material)
+  {
+    material_ = material;
+
+    // Values for gaseous xenon, used if the
+    // material does not define its own
+    ioni_energy_ = 22.4 * eV;
+    fano_factor_ = .15;
+
+    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    if (!mpt) return;
+
+    if (mpt->ConstPropertyExists("IONIZATIONENERGY"))
+      ioni_energy_ = mpt->GetConstProperty("IONIZATIONENERGY");
+    if (mpt->ConstPropertyExists("FANOFACTOR"))
+      fano_factor_ = mpt->GetConstProperty("FANOFACTOR");
+  }
+
+
+
   G4double IonizationClustering::GetMeanFreePath(const G4Track&,
     G4double, G4ForceCondition* condition)
   {
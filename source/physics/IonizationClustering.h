@@ -9,12 +9,17 @@
 #ifndef IONIZATION_CLUSTERING_H
 #define IONIZATION_CLUSTERING_H
 
+#include "ElectronBatch.h"
+
 #include <G4VRestDiscreteProcess.hh>
 
+class G4Material;
+
 
 namespace nexus {
 
   class SegmentPointSampler;
+  class BaseDriftField;
 
   class IonizationClustering: public G4VRestDiscreteProcess
   {
@@ -43,6 +48,22 @@ namespace nexus {
     /// by particles at rest
     G4VParticleChange* AtRestDoIt(const G4Track&, const G4Step&);
 
+    /// If set, the ionization electrons of each step are drifted
+    /// in bulk by the field of the region, and tracks are created
+    /// only for those reaching its end, where they arrive
+    void SetBulkDrift(G4bool);
+
+    /// Returns true if the ionization electrons deposited in the region
+    /// of the field are drifted in bulk. Electrons deposited in an EL
+    /// region (a field with light yield) are always tracked, so that
+    /// they produce their light
+    G4bool BulkDrift(const BaseDriftField&) const;
+
+    /// Sets the number of electrons simulated together as a single
+    /// ionization electron, whose track weight is that number
+    /// (times the weight of the track depositing the energy)
+    void SetClusterSize(G4int);
+
   private:
 
     /// Returns infinity; i. e. the process does not limit the step,
@@ -55,11 +76,25 @@ namespace nexus {
     /// to be invoked at every step
     G4double GetMeanLifeTime(const G4Track&, G4ForceCondition*);
 
+    /// Reads W_i and Fano factor of a material from its properties table
+    void SetMaterial(const G4Material*);
+
   private:
     G4ParticleChange* ParticleChange_;
     SegmentPointSampler* rnd_;
+
+    G4bool bulk_drift_;
+    G4int cluster_size_;  ///< Electrons per simulated ionization electron
+    ElectronBatch batch_; ///< Ionization electrons of the current step
+
+    const G4Material* material_; ///< Material of the last energy deposit
+    G4double ioni_energy_;       ///< W_i of material_
+    G4double fano_factor_;       ///< Fano factor of material_
   };
 
+  inline void IonizationClustering::SetBulkDrift(G4bool b)
+  { bulk_drift_ = b; }
+
 } // end namespace nexus
 
 #endif
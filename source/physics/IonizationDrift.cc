@@ -23,7 +23,7 @@ namespace nexus {
 
 
   IonizationDrift::IonizationDrift(const G4String& name, G4ProcessType type):
-    G4VContinuousDiscreteProcess(name, type)
+    G4VContinuousDiscreteProcess(name, type), region_(0), field_(0)
   {
     ParticleChange_ = new G4ParticleChangeForTransport();
     pParticleChange = ParticleChange_;
@@ -51,12 +51,8 @@ namespace nexus {
   {
     G4double step_length = 0.;
     
-    // Get current region
-    G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
-    
-    // Get the drift field attached to this region
-    BaseDriftField* field = 
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    // Get the drift field attached to the current region
+    BaseDriftField* field = GetDriftField(track);
 
     // If the region has no field, the particle won't move 
     // and therefore the step length is zero.
@@ -64,13 +60,27 @@ namespace nexus {
 
     // Get displacement from current position due to drift field
     xyzt_.set(track.GetGlobalTime(), track.GetPosition());
-    step_length = field->Drift(xyzt_);
+    step_length = field->DriftCluster(xyzt_, track.GetWeight());
     
     return step_length;
   }
   
   
   
+  BaseDriftField* IonizationDrift::GetDriftField(const G4Track& track)
+  {
+    const G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
+
+    if (region != region_) {
+      region_ = region;
+      field_  = dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    }
+
+    return field_;
+  }
+
+
+
   G4VParticleChange* 
   IonizationDrift::AlongStepDoIt(const G4Track& track, const G4Step& step)
   {
@@ -108,10 +118,18 @@ namespace nexus {
   {
     ParticleChange_->Initialize(track);
 
-    // Update navigator and touchable handle
+    // The whole drift through the region is done in a single step, so
+    // the only thing left is to locate the electron in the region it
+    // enters. Electrons killed along the step (attached, or outside
+    // the field) are not located at all.
+    if (track.GetTrackStatus() == fStopAndKill)
+      return G4VContinuousDiscreteProcess::PostStepDoIt(track, step);
+
+    // Update navigator and touchable handle. The search starts from
+    // the volume the electron leaves, which is adjacent to the new one.
     G4TouchableHandle touchable = track.GetTouchableHandle();
     nav_->LocateGlobalPointAndUpdateTouchableHandle
-      (track.GetPosition(), track.GetMomentumDirection(), touchable, false);
+      (track.GetPosition(), track.GetMomentumDirection(), touchable, true);
     ParticleChange_->SetTouchableHandle(touchable);
     
     // Get the volume where the particle currently lives
@@ -119,7 +137,10 @@ namespace nexus {
 
     // Check whether the particle has left the world volume.
     // If so, we kill it.
-    if (!new_volume) ParticleChange_->ProposeTrackStatus(fStopAndKill);
+    if (!new_volume) {
+      ParticleChange_->ProposeTrackStatus(fStopAndKill);
+      return G4VContinuousDiscreteProcess::PostStepDoIt(track, step);
+    }
 
     // Set the material corresponding to the new volume
     // (we "cast away" the constness of the pointer because the particle 
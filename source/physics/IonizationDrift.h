@@ -15,9 +15,12 @@
 
 class G4Navigator;
 class G4ParticleChangeForTransport;
+class G4Region;
 
 namespace nexus {
 
+  class BaseDriftField;
+
   class IonizationDrift: public G4VContinuousDiscreteProcess
   {
   public:
@@ -46,10 +49,17 @@ namespace nexus {
     G4double GetContinuousStepLimit(const G4Track&, G4double,
 				    G4double, G4double&);
 
+    /// Returns the drift field of the region where the track is,
+    /// remembering it for as long as the track stays in that region
+    BaseDriftField* GetDriftField(const G4Track&);
+
   private:
     G4LorentzVector xyzt_;
     G4ParticleChangeForTransport* ParticleChange_;
     G4Navigator* nav_; ///< Pointer to the G4 navigator for tracking
+
+    const G4Region* region_; ///< Region of the last drift step
+    BaseDriftField* field_;  ///< Drift field of region_
   };
 
 } // end namespace nexus
@@ -0,0 +1,223 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalAbsorber.cc
+//
+// Kills optical photons as soon as they enter volumes that absorb them
+// (configured by volume or material name, or identified from their
+// optical surfaces), optionally counting them for each volume during
+// a run.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalAbsorber.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4LogicalSkinSurface.hh>
+#include <G4LogicalBorderSurface.hh>
+#include <G4OpticalSurface.hh>
+#include <G4StateManager.hh>
+
+#include <utility>
+
+
+namespace nexus {
+
+  OpticalAbsorber::OpticalAbsorber(const G4String& process_name,
+                                   G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), particle_change_(0),
+    automatic_(false), max_reflectivity_(0.01), tally_(false)
+  {
+    particle_change_ = new G4ParticleChange();
+    pParticleChange = particle_change_;
+
+    G4StateManager::GetStateManager()->RegisterDependent(this);
+  }
+
+
+
+  OpticalAbsorber::~OpticalAbsorber()
+  {
+    G4StateManager::GetStateManager()->DeregisterDependent(this);
+    delete particle_change_;
+  }
+
+
+
+  G4bool OpticalAbsorber::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return pdef == *G4OpticalPhoton::Definition();
+  }
+
+
+
+  G4VParticleChange*
+  OpticalAbsorber::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    particle_change_->Initialize(track);
+
+    const G4StepPoint* post = step.GetPostStepPoint();
+    if (post->GetStepStatus() != fGeomBoundary)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    const G4VPhysicalVolume* volume = post->GetPhysicalVolume();
+    if (!volume)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    const G4LogicalVolume* lv = volume->GetLogicalVolume();
+
+    auto it = absorption_.find(lv);
+    if (it == absorption_.end())
+      it = absorption_.emplace(lv, Classify(lv)).first;
+
+    if (it->second == kNone)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    if (it->second != kAlways) {
+      // The optical surface of the boundary, if any, takes precedence
+      // over the properties of the volume entered. A surface between
+      // the two volumes is left to the boundary process, whereas a
+      // skin surface, of either volume, absorbs only if it is black.
+      const G4VPhysicalVolume* pre = step.GetPreStepPoint()->GetPhysicalVolume();
+      if (G4LogicalBorderSurface::GetSurface(pre, volume))
+        return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+      const G4LogicalVolume* owner = lv;
+      Skin skin = BoundarySkin(pre, volume, owner);
+      if (skin == kOtherSkin || (skin == kNoSkin && it->second == kTransparent))
+        return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+      // Photons absorbed by the skin of the volume left are
+      // counted for that volume
+      lv = owner;
+    }
+
+    particle_change_->ProposeTrackStatus(fStopAndKill);
+    if (tally_) ++absorbed_[lv];
+
+    return particle_change_;
+  }
+
+
+
+  OpticalAbsorber::Absorption
+  OpticalAbsorber::Classify(const G4LogicalVolume* lv) const
+  {
+    const G4Material* material = lv->GetMaterial();
+
+    if (volumes_.count(lv->GetName()) || materials_.count(material->GetName()))
+      return kAlways;
+
+    // Photons reaching sensors must be left to the boundary process
+    if (!automatic_ || lv->GetSensitiveDetector())
+      return kNone;
+
+    // Without refractive index, photons are absorbed at the boundary
+    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    if (!mpt || !mpt->GetProperty("RINDEX"))
+      return kOpaque;
+
+    return kTransparent;
+  }
+
+
+
+  OpticalAbsorber::Skin
+  OpticalAbsorber::ClassifySkin(const G4LogicalVolume* lv)
+  {
+    auto it = skins_.find(lv);
+    if (it != skins_.end()) return it->second;
+
+    Skin result = kNoSkin;
+    const G4LogicalSkinSurface* skin = G4LogicalSkinSurface::GetSurface(lv);
+    if (skin) {
+      const G4OpticalSurface* surface =
+        dynamic_cast<const G4OpticalSurface*>(skin->GetSurfaceProperty());
+      result = (surface && IsBlack(surface)) ? kBlackSkin : kOtherSkin;
+    }
+
+    skins_.emplace(lv, result);
+    return result;
+  }
+
+
+
+  OpticalAbsorber::Skin
+  OpticalAbsorber::BoundarySkin(const G4VPhysicalVolume* pre,
+                                const G4VPhysicalVolume* post,
+                                const G4LogicalVolume*& owner)
+  {
+    const G4LogicalVolume* pre_lv  = pre->GetLogicalVolume();
+    const G4LogicalVolume* post_lv = post->GetLogicalVolume();
+
+    // Same order as G4OpBoundaryProcess
+    const G4LogicalVolume* first  = post_lv;
+    const G4LogicalVolume* second = pre_lv;
+    if (post->GetMotherLogical() != pre_lv) std::swap(first, second);
+
+    owner = first;
+    Skin skin = ClassifySkin(first);
+    if (skin != kNoSkin) return skin;
+
+    owner = second;
+    skin = ClassifySkin(second);
+    if (skin == kNoSkin) owner = post_lv;
+    return skin;
+  }
+
+
+
+  G4bool OpticalAbsorber::IsBlack(const G4OpticalSurface* surface) const
+  {
+    G4MaterialPropertiesTable* mpt = surface->GetMaterialPropertiesTable();
+
+    // Without a reflectivity, the boundary process takes it as 1
+    if (!mpt || !mpt->GetProperty("REFLECTIVITY"))
+      return false;
+
+    if (mpt->GetProperty("TRANSMITTANCE") || mpt->GetProperty("EFFICIENCY"))
+      return false;
+
+    return mpt->GetProperty("REFLECTIVITY")->GetMaxValue() <= max_reflectivity_;
+  }
+
+
+
+  std::map<G4String, G4long> OpticalAbsorber::GetAbsorbedPhotons() const
+  {
+    std::map<G4String, G4long> absorbed = resumed_;
+    for (const auto& lv: absorbed_)
+      absorbed[lv.first->GetName()] += lv.second;
+    return absorbed;
+  }
+
+
+
+  G4bool OpticalAbsorber::Notify(G4ApplicationState requested_state)
+  {
+    G4ApplicationState state = G4StateManager::GetStateManager()->GetCurrentState();
+
+    // Beginning of a run
+    if (state == G4State_Idle && requested_state == G4State_GeomClosed)
+      absorbed_.clear();
+
+    // End of a run, once its tally has been stored
+    if (state == G4State_GeomClosed && requested_state == G4State_Idle)
+      resumed_.clear();
+
+    return true;
+  }
+
+
+
+  G4double OpticalAbsorber::GetMeanFreePath(const G4Track&, G4double,
+                                            G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+} // end namespace nexus
@@ -0,0 +1,145 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalAbsorber.h
+//
+// Kills optical photons as soon as they enter volumes that absorb them
+// (configured by volume or material name, or identified from their
+// optical surfaces), optionally counting them for each volume during
+// a run.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_ABSORBER_H
+#define OPTICAL_ABSORBER_H
+
+#include <G4VDiscreteProcess.hh>
+#include <G4VStateDependent.hh>
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4OpticalSurface;
+
+
+namespace nexus {
+
+  class OpticalAbsorber: public G4VDiscreteProcess, public G4VStateDependent
+  {
+  public:
+    /// Constructor
+    OpticalAbsorber(const G4String& process_name="OpticalAbsorber",
+                    G4ProcessType type=fUserDefined);
+    /// Destructor
+    ~OpticalAbsorber();
+
+    /// Only optical photons apply
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Kills the photon if the step ends entering an absorber
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Absorbers given by logical volume name
+    void AddVolume(const G4String&);
+    /// Absorbers given by material name
+    void AddMaterial(const G4String&);
+
+    /// Treat also as absorbers the volumes where photons cannot
+    /// be reflected, transmitted or detected, that is, covered by
+    /// an optical surface of reflectivity below a threshold or
+    /// made of a material without refractive index
+    void SetAutomatic(G4bool);
+    void SetMaxReflectivity(G4double);
+
+    /// Count the photons killed in each volume
+    void SetTally(G4bool);
+    G4bool GetTally() const;
+
+    /// Number of photons killed in each logical volume in the run
+    std::map<G4String, G4long> GetAbsorbedPhotons() const;
+    /// Photons killed in a volume in the run resumed from a checkpoint,
+    /// before the checkpoint
+    void AddAbsorbedPhotons(const G4String& volume, G4long);
+
+    /// Resets the tally at the beginning of each run (when the
+    /// geometry is closed) and drops the resumed counts at its end
+    G4bool Notify(G4ApplicationState requested_state);
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    /// Whether photons entering a volume are absorbed: never, always,
+    /// or depending on the optical surface of the boundary, if any,
+    /// and otherwise on whether its material is opaque (has no
+    /// refractive index)
+    enum Absorption { kNone, kAlways, kOpaque, kTransparent };
+
+    Absorption Classify(const G4LogicalVolume*) const;
+
+    /// Whether a logical volume has a skin surface, black or not
+    enum Skin { kNoSkin, kBlackSkin, kOtherSkin };
+
+    Skin ClassifySkin(const G4LogicalVolume*);
+
+    /// Skin surface applied by the boundary process to a photon
+    /// going from one volume to the other, and volume it covers:
+    /// that of the volume entered if it is a daughter of the one
+    /// left, that of the volume left otherwise, or that of the
+    /// other if missing
+    Skin BoundarySkin(const G4VPhysicalVolume* pre,
+                      const G4VPhysicalVolume* post,
+                      const G4LogicalVolume*& owner);
+
+    /// Whether an optical surface absorbs all photons
+    G4bool IsBlack(const G4OpticalSurface*) const;
+
+  private:
+    G4ParticleChange* particle_change_;
+
+    std::set<G4String> volumes_;
+    std::set<G4String> materials_;
+    G4bool automatic_;
+    G4double max_reflectivity_;
+    G4bool tally_;
+
+    /// Classification of the volumes already entered
+    std::unordered_map<const G4LogicalVolume*, Absorption> absorption_;
+    /// Classification of the skin surfaces already found
+    std::unordered_map<const G4LogicalVolume*, Skin> skins_;
+    /// Photons killed in each volume in the run
+    std::unordered_map<const G4LogicalVolume*, G4long> absorbed_;
+    /// Photons killed before the checkpoint, by volume name
+    std::map<G4String, G4long> resumed_;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline void OpticalAbsorber::AddVolume(const G4String& name)
+  { volumes_.insert(name); absorption_.clear(); }
+
+  inline void OpticalAbsorber::AddMaterial(const G4String& name)
+  { materials_.insert(name); absorption_.clear(); }
+
+  inline void OpticalAbsorber::SetAutomatic(G4bool automatic)
+  { automatic_ = automatic; absorption_.clear(); }
+
+  inline void OpticalAbsorber::SetMaxReflectivity(G4double r)
+  { max_reflectivity_ = r; absorption_.clear(); skins_.clear(); }
+
+  inline void OpticalAbsorber::SetTally(G4bool tally)
+  { tally_ = tally; }
+
+  inline G4bool OpticalAbsorber::GetTally() const
+  { return tally_; }
+
+  inline void OpticalAbsorber::AddAbsorbedPhotons(const G4String& volume, G4long n)
+  { resumed_[volume] += n; }
+
+} // end namespace nexus
+
+#endif
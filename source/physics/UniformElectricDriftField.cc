@@ -43,23 +43,29 @@ namespace nexus {
 
 
   G4double UniformElectricDriftField::Drift(G4LorentzVector& xyzt)
+  {
+    return DriftCluster(xyzt, 1.);
+  }
+
+
+
+  G4double UniformElectricDriftField::DriftCluster(G4LorentzVector& xyzt,
+                                                   G4double nelectrons)
   {
     // If the origin is not between anode and cathode,
     // the charge carrier, obviously, doesn't move.
     if (!CheckCoordinate(xyzt[axis_]))
       return 0.;
 
-    // Set the offset according to relative anode-cathode pos
-    G4double secmargin = -1. * micrometer;
-    if (anode_pos_ > cathode_pos_) secmargin = -secmargin;
-
     // Calculate drift time and distance to anode
     G4double drift_length = fabs(xyzt[axis_] - anode_pos_);
     G4double drift_time = drift_length / drift_velocity_;
 
     // Calculate longitudinal and transversal deviation due to diffusion
-    G4double transv_sigma = transv_diff_ * sqrt(drift_length);
-    G4double longit_sigma = longit_diff_ * sqrt(drift_length);
+    // (of the centroid, for a cluster of electrons)
+    G4double cluster_scale = 1. / sqrt(nelectrons);
+    G4double transv_sigma = transv_diff_ * sqrt(drift_length) * cluster_scale;
+    G4double longit_sigma = longit_diff_ * sqrt(drift_length) * cluster_scale;
     G4double time_sigma = longit_sigma / drift_velocity_;
 
     G4ThreeVector position;
@@ -70,7 +76,7 @@ namespace nexus {
         position[i] = G4RandGauss::shoot(xyzt[i], transv_sigma);
       }
       else { // Longitudinal coordinate
-        position[i] = anode_pos_ + secmargin;
+        position[i] = DriftEnd();
         G4double deltat = G4RandGauss::shoot(0, time_sigma);
         time = xyzt.t() + drift_time + deltat;
         if (time < 0.) time = xyzt.t() + drift_time;
@@ -95,6 +101,54 @@ namespace nexus {
 
 
 
+  void UniformElectricDriftField::DriftBatch(ElectronBatch& batch)
+  {
+    const std::size_t n = batch.Size();
+    if (n == 0) return;
+
+    // Random numbers for the whole batch: three normal deviates
+    // (two transverse coordinates and time) and one uniform
+    // (attachment) per electron
+    gauss_.resize(3*n);
+    flat_.resize(n);
+    G4RandGauss::shootArray(3*n, gauss_.data(), 0., 1.);
+    G4Random::getTheEngine()->flatArray(n, flat_.data());
+    alive_.assign(n, 1);
+
+    std::vector<G4double>* coord[3] = {&batch.x, &batch.y, &batch.z};
+    std::vector<G4double>& longit = *coord[axis_];
+    std::vector<G4double>& transv1 = *coord[(axis_+1)%3];
+    std::vector<G4double>& transv2 = *coord[(axis_+2)%3];
+
+    for (std::size_t i=0; i<n; ++i) {
+
+      if (!CheckCoordinate(longit[i])) {
+        alive_[i] = 0;
+        continue;
+      }
+
+      const G4double drift_length = std::abs(longit[i] - anode_pos_);
+      const G4double drift_time   = drift_length / drift_velocity_;
+      const G4double sqrt_length  = std::sqrt(drift_length / batch.w[i]);
+
+      transv1[i] += transv_diff_ * sqrt_length * gauss_[3*i];
+      transv2[i] += transv_diff_ * sqrt_length * gauss_[3*i+1];
+      longit[i]   = DriftEnd();
+
+      G4double time_diff = drift_time
+        + longit_diff_ * sqrt_length / drift_velocity_ * gauss_[3*i+2];
+      if (batch.t[i] + time_diff < 0.) time_diff = drift_time;
+      batch.t[i] += time_diff;
+
+      // Attachment: the electron survives with probability exp(-t/lifetime)
+      if (flat_[i] > std::exp(-time_diff / lifetime_)) alive_[i] = 0;
+    }
+
+    batch.Compact(alive_);
+  }
+
+
+
   G4LorentzVector UniformElectricDriftField::GeneratePointAlongDriftLine(const G4LorentzVector& origin,
                                                                          const G4LorentzVector& end)
   {
@@ -104,6 +158,13 @@ namespace nexus {
 
 
 
+  G4double UniformElectricDriftField::DriftEnd() const
+  {
+    return anode_pos_ + (anode_pos_ > cathode_pos_ ? 1. : -1.) * micrometer;
+  }
+
+
+
   G4bool UniformElectricDriftField::CheckCoordinate(G4double coord)
   {
     G4double max_coord = std::max(anode_pos_, cathode_pos_);
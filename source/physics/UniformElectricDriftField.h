@@ -36,6 +36,14 @@ namespace nexus {
     /// of an ionization electron
     G4double Drift(G4LorentzVector& xyzt);
 
+    /// Same as Drift for a cluster of electrons, with the
+    /// diffusion reduced by the square root of their number
+    G4double DriftCluster(G4LorentzVector& xyzt, G4double nelectrons);
+
+    /// Same as Drift for a whole batch of electrons, sampling
+    /// diffusion and attachment for all of them at once
+    void DriftBatch(ElectronBatch&);
+
     G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
 
     // Setters/getters
@@ -67,6 +75,12 @@ namespace nexus {
     /// Returns true if coordinate is between anode and cathode
     G4bool CheckCoordinate(G4double);
 
+    /// Longitudinal coordinate where the drift ends: 1 micron past
+    /// the anode, on the side away from the cathode. The electron is
+    /// then located in the EL region beyond the drift region, whose
+    /// field takes over.
+    G4double DriftEnd() const;
+
 
 
   private:
@@ -84,6 +98,10 @@ namespace nexus {
 
     SegmentPointSampler* rnd_;
 
+    std::vector<G4double> gauss_; ///< Buffer of normal random numbers for DriftBatch
+    std::vector<G4double> flat_;  ///< Buffer of uniform random numbers for DriftBatch
+    std::vector<char> alive_;
+
   };
 
 
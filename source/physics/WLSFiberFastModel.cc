@@ -0,0 +1,313 @@
+// ----------------------------------------------------------------------------
+// nexus | WLSFiberFastModel.cc
+//
+// Fast simulation of the light transport along wavelength shifting
+// fibers. The photons re-emitted in a fiber core that are trapped by
+// total internal reflection are moved directly to the fiber end they
+// head to, instead of being tracked through all the reflections.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "WLSFiberFastModel.h"
+
+#include "Interpolation.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4OpticalParameters.hh>
+#include <G4FastSimulationManagerProcess.hh>
+#include <G4DynamicParticle.hh>
+#include <G4RandomDirection.hh>
+#include <G4Poisson.hh>
+#include <G4VProcess.hh>
+#include <G4Region.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Tubs.hh>
+#include <Randomize.hh>
+
+#include <cmath>
+#include "CLHEP/Units/PhysicalConstants.h"
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+  namespace {
+
+    G4MaterialPropertyVector* GetProperty(const G4Material* mat,
+                                          const G4String& name)
+    {
+      G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+      return mpt ? mpt->GetProperty(name) : nullptr;
+    }
+
+    G4double GetConstProperty(const G4Material* mat, const G4String& name)
+    {
+      G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+      return (mpt && mpt->ConstPropertyExists(name)) ?
+        mpt->GetConstProperty(name) : 0.;
+    }
+
+  }
+
+
+
+  WLSFiberFastModel::WLSFiberFastModel(G4Region* region,
+                                       const G4Material* core,
+                                       const G4Material* cladding,
+                                       G4double length):
+    G4VFastSimulationModel("WLSFiberFastModel", region),
+    half_length_(length/2.), barrel_(false), wls_mean_photons_(0.),
+    wls_time_(0.)
+  {
+    // The trapping condition holds for round cores only
+    auto root = region->GetRootLogicalVolumeIterator();
+    for (std::size_t i=0; i<region->GetNumberOfRootVolumes(); ++i, ++root) {
+      if (!dynamic_cast<const G4Tubs*>((*root)->GetSolid())) {
+        G4Exception("[WLSFiberFastModel]", "WLSFiberFastModel()", FatalException,
+                    "The fiber cores must be round (G4Tubs).");
+      }
+    }
+
+    G4MaterialPropertyVector* core_rindex = GetProperty(core,     "RINDEX");
+    G4MaterialPropertyVector* clad_rindex = GetProperty(cladding, "RINDEX");
+
+    if (!core_rindex || !clad_rindex || core_rindex->GetVectorLength() < 2) {
+      G4Exception("[WLSFiberFastModel]", "WLSFiberFastModel()", FatalException,
+                  "Refractive index of the fiber core or cladding not defined.");
+    }
+
+    G4MaterialPropertyVector* abslength     = GetProperty(core, "ABSLENGTH");
+    G4MaterialPropertyVector* wls_abslength = GetProperty(core, "WLSABSLENGTH");
+    G4MaterialPropertyVector* groupvel      = GetProperty(core, "GROUPVEL");
+
+    for (std::size_t i=0; i<core_rindex->GetVectorLength(); ++i) {
+      G4double energy = core_rindex->Energy(i);
+      G4double n_core = (*core_rindex)[i];
+
+      // Photons are trapped if n_core * sin(angle to the normal of
+      // the cladding) > n_clad, that is, cos(angle to the axis) > n_clad/n_core
+      G4double cos_trapping = clad_rindex->Value(energy) / n_core;
+
+      G4double absorption = abslength ? 1. / abslength->Value(energy) : 0.;
+      G4double wls_absorption =
+        wls_abslength ? 1. / wls_abslength->Value(energy) : 0.;
+
+      G4double velocity = groupvel ? groupvel->Value(energy) : c_light / n_core;
+
+      energies_.push_back(energy);
+      table_[kCosTrapping]     .push_back(cos_trapping);
+      table_[kAbsorption]      .push_back(absorption);
+      table_[kWLSAbsorption]   .push_back(wls_absorption);
+      table_[kInvGroupVelocity].push_back(1. / velocity);
+    }
+
+    // Re-emission spectrum
+    G4MaterialPropertyVector* wls_component = GetProperty(core, "WLSCOMPONENT");
+    if (wls_abslength && wls_component) {
+      wls_spectrum_ = SpectrumSampler(*wls_component);
+      wls_mean_photons_ = GetConstProperty(core, "WLSMEANNUMBERPHOTONS");
+      wls_time_         = GetConstProperty(core, "WLSTIMECONSTANT");
+    }
+  }
+
+
+
+  WLSFiberFastModel::~WLSFiberFastModel()
+  {
+  }
+
+
+
+  G4bool WLSFiberFastModel::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return pdef == *G4OpticalPhoton::Definition();
+  }
+
+
+
+  G4double WLSFiberFastModel::Lookup(G4int quantity, G4double energy) const
+  {
+    G4double value;
+    Interpolate1D(GridAxis::Irregular(energies_.data(), energies_.size()),
+                  table_[quantity].data(), 1, &energy, &value);
+    return value;
+  }
+
+
+
+  G4bool WLSFiberFastModel::Trapped(G4double energy,
+                                    const G4ThreeVector& position,
+                                    const G4ThreeVector& direction) const
+  {
+    G4double cos_trapping = Lookup(kCosTrapping, energy);
+
+    if (!barrel_)
+      return std::abs(direction.z()) > cos_trapping;
+
+    // In a shell, the normal of the claddings is the radial direction
+    G4ThreeVector radial(position.x(), position.y(), 0.);
+    G4double cos_normal = std::abs(direction.dot(radial.unit()));
+    return direction.z() != 0. &&
+      1. - cos_normal * cos_normal > cos_trapping * cos_trapping;
+  }
+
+
+
+  G4double WLSFiberFastModel::PathToEnd(const G4ThreeVector& position,
+                                        const G4ThreeVector& direction) const
+  {
+    G4double end_z = direction.z() > 0. ? half_length_ : -half_length_;
+    return std::abs(end_z - position.z()) / std::abs(direction.z());
+  }
+
+
+
+  std::pair<G4double, G4double>
+  WLSFiberFastModel::Attenuation(G4double energy) const
+  {
+    return {Lookup(kAbsorption, energy), Lookup(kWLSAbsorption, energy)};
+  }
+
+
+
+  void WLSFiberFastModel::Advance(G4double path, G4ThreeVector& position,
+                                  G4ThreeVector& direction) const
+  {
+    G4double dz = direction.z();
+
+    if (!barrel_) {
+      // Reflections preserve the angle with the fiber axis,
+      // but randomize the azimuth of the direction
+      G4double sin_theta = std::sqrt(1. - dz * dz);
+      G4double phi = twopi * G4UniformRand();
+      direction.set(sin_theta * std::cos(phi), sin_theta * std::sin(phi), dz);
+      position.setZ(position.z() + path * dz);
+      return;
+    }
+
+    // In a shell, reflections flip the radial component of the
+    // direction, while the photon moves around the axis with
+    // the tangential one
+    G4double radius = position.perp();
+    G4double phi    = position.phi();
+    G4ThreeVector radial (std::cos(phi), std::sin(phi), 0.);
+    G4ThreeVector tangent(-std::sin(phi), std::cos(phi), 0.);
+    G4double dr = std::abs(direction.dot(radial));
+    G4double dt = direction.dot(tangent);
+
+    phi += path * dt / radius;
+    if (G4UniformRand() < 0.5) dr = -dr;
+
+    radial .set(std::cos(phi), std::sin(phi), 0.);
+    tangent.set(-std::sin(phi), std::cos(phi), 0.);
+    position  = radius * radial + G4ThreeVector(0., 0., position.z() + path * dz);
+    direction = (dr * radial + dt * tangent + G4ThreeVector(0., 0., dz)).unit();
+  }
+
+
+
+  G4bool WLSFiberFastModel::ModelTrigger(const G4FastTrack& ftrack)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+
+    if (track->GetCurrentStepNumber() != 1) return false;
+
+    // Photons from the WLS processes, or re-emitted by this model
+    const G4VProcess* creator = track->GetCreatorProcess();
+    if (!creator || (creator->GetProcessName() != "OpWLS" &&
+                     creator->GetProcessName() != "WavelengthShifting" &&
+                     !dynamic_cast<const G4FastSimulationManagerProcess*>(creator)))
+      return false;
+
+    return Trapped(track->GetKineticEnergy(),
+                   ftrack.GetPrimaryTrackLocalPosition(),
+                   ftrack.GetPrimaryTrackLocalDirection());
+  }
+
+
+
+  void WLSFiberFastModel::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+    G4double energy = track->GetKineticEnergy();
+
+    G4ThreeVector position  = ftrack.GetPrimaryTrackLocalPosition();
+    G4ThreeVector direction = ftrack.GetPrimaryTrackLocalDirection();
+
+    G4double path = PathToEnd(position, direction);
+    G4double inv_velocity = Lookup(kInvGroupVelocity, energy);
+
+    // Distance to the first absorption, of either kind
+    std::pair<G4double, G4double> attenuation = Attenuation(energy);
+    G4double total = attenuation.first + attenuation.second;
+    G4double distance = total > 0. ? G4RandExponential::shoot(1. / total) : DBL_MAX;
+
+    if (distance < path) {
+      if (G4UniformRand() * total < attenuation.second) {
+        Advance(distance, position, direction);
+        Reemit(fstep, energy, position,
+               track->GetGlobalTime() + distance * inv_velocity);
+      }
+      fstep.KillPrimaryTrack();
+      return;
+    }
+
+    if (!std::isfinite(path)) {
+      fstep.KillPrimaryTrack();
+      return;
+    }
+
+    // The photon is left just before the end face, so that the
+    // boundary process deals with its way out of the fiber
+    Advance(path, position, direction);
+    G4double end_offset = 1. * nm;
+    position.setZ(position.z() - std::copysign(end_offset, direction.z()));
+
+    G4ThreeVector polarization = direction.orthogonal().unit();
+    polarization.rotate(twopi * G4UniformRand(), direction);
+
+    fstep.ProposePrimaryTrackFinalPosition(position, true);
+    fstep.ProposePrimaryTrackFinalMomentumDirection(direction, true);
+    fstep.ProposePrimaryTrackFinalPolarization(polarization, true);
+    fstep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + path * inv_velocity);
+    fstep.ProposePrimaryTrackPathLength(path);
+  }
+
+
+
+  void WLSFiberFastModel::Reemit(G4FastStep& fstep, G4double energy,
+                                 const G4ThreeVector& position,
+                                 G4double time) const
+  {
+    if (wls_spectrum_.IsEmpty()) return;
+
+    // Only energies below that of the absorbed photon are re-emitted
+    G4double cdf_max = wls_spectrum_.Cumulative(energy);
+    if (cdf_max <= 0.) return;
+
+    G4int num_photons =
+      wls_mean_photons_ > 0. ? G4int(G4Poisson(wls_mean_photons_)) : 1;
+    fstep.SetNumberOfSecondaryTracks(num_photons);
+
+    G4bool exponential =
+      G4OpticalParameters::Instance()->GetWLSTimeProfile() == "exponential";
+
+    for (G4int i=0; i<num_photons; ++i) {
+      G4double new_energy = wls_spectrum_.Sample(G4UniformRand() * cdf_max);
+
+      G4ThreeVector direction = G4RandomDirection();
+      G4ThreeVector polarization = direction.orthogonal().unit();
+      polarization.rotate(twopi * G4UniformRand(), direction);
+
+      G4double delay = exponential ? G4RandExponential::shoot(wls_time_) : wls_time_;
+
+      G4DynamicParticle photon(G4OpticalPhoton::Definition(), direction, new_energy);
+      fstep.CreateSecondaryTrack(photon, polarization, position, time + delay, true);
+    }
+  }
+
+} // end namespace nexus
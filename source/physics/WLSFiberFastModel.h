@@ -0,0 +1,120 @@
+// ----------------------------------------------------------------------------
+// nexus | WLSFiberFastModel.h
+//
+// Fast simulation of the light transport along wavelength shifting
+// fibers. The photons re-emitted in a fiber core that are trapped by
+// total internal reflection are moved directly to the fiber end they
+// head to, instead of being tracked through all the reflections.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef WLS_FIBER_FAST_MODEL_H
+#define WLS_FIBER_FAST_MODEL_H
+
+#include "SpectrumSampler.h"
+
+#include <G4VFastSimulationModel.hh>
+
+#include <vector>
+
+class G4Material;
+
+
+namespace nexus {
+
+  /// Model for the round cores of straight fibers along the z axis of
+  /// their envelope, from -length/2 to +length/2. A photon created by
+  /// a WLS process is trapped if the angle of its direction with the
+  /// fiber axis is below the critical angle of the core and outermost
+  /// cladding interface (meridional rays), which does not hold for
+  /// square cores: the constructor rejects solids other than G4Tubs.
+  /// Trapped photons are attenuated in the core; those surviving are
+  /// placed at the end of the fiber with the arrival time given by the
+  /// group velocity, and tracked from there as usual into the end
+  /// sensor. Untrapped photons are not affected.
+  ///
+  /// The core may also be a thin cylindrical shell around the z axis,
+  /// as the fiber barrel of NextFlex. Photons are then trapped by the
+  /// angle of their direction with the radial direction, and move
+  /// around the barrel as they travel along it (the reflections are
+  /// those of a flat slab).
+  ///
+  /// On the way, the photon may be absorbed by the core (ABSLENGTH),
+  /// and lost, or by the shifter itself (WLSABSLENGTH). In the latter
+  /// case it is re-emitted at that point as G4OpWLS would do, and the
+  /// new photons are handled by the model in turn.
+
+  class WLSFiberFastModel: public G4VFastSimulationModel
+  {
+  public:
+    /// Constructor providing the region of the fiber cores, the
+    /// materials of the core and of the outermost cladding and the
+    /// length of the fibers
+    WLSFiberFastModel(G4Region* region, const G4Material* core,
+                      const G4Material* cladding, G4double length);
+    /// Destructor
+    ~WLSFiberFastModel();
+
+    /// The core is a cylindrical shell around the z axis
+    void SetBarrel(G4bool);
+
+    /// The model is only valid for optical photons
+    G4bool IsApplicable(const G4ParticleDefinition&) override;
+
+    /// True for the first step of trapped photons created by
+    /// wavelength shifting in the fiber core
+    G4bool ModelTrigger(const G4FastTrack&) override;
+
+    /// Attenuation and transport of the photon to the fiber end
+    void DoIt(const G4FastTrack&, G4FastStep&) override;
+
+    /// Whether a photon at a position of the core, in its local
+    /// frame, is trapped
+    G4bool Trapped(G4double energy, const G4ThreeVector& position,
+                   const G4ThreeVector& direction) const;
+
+    /// Length of the path of a trapped photon to the fiber end
+    G4double PathToEnd(const G4ThreeVector& position,
+                       const G4ThreeVector& direction) const;
+
+    /// Inverse of the absorption length of the core, for
+    /// absorption (first) and for wavelength shifting (second)
+    std::pair<G4double, G4double> Attenuation(G4double energy) const;
+
+  private:
+    /// Quantities tabulated as a function of the photon energy
+    enum { kCosTrapping, kAbsorption, kWLSAbsorption, kInvGroupVelocity,
+           kNumQuantities };
+
+    G4double Lookup(G4int quantity, G4double energy) const;
+
+    /// Position and direction of a trapped photon after
+    /// travelling a path along the fiber
+    void Advance(G4double path, G4ThreeVector& position,
+                 G4ThreeVector& direction) const;
+
+    /// Photons re-emitted by the shifter after absorbing
+    /// a photon of the given energy at the given place
+    void Reemit(G4FastStep&, G4double energy, const G4ThreeVector& position,
+                G4double time) const;
+
+  private:
+    G4double half_length_;
+    G4bool barrel_;
+
+    /// Photon energies of the table (those of the core refractive index)
+    std::vector<G4double> energies_;
+    std::vector<G4double> table_[kNumQuantities];
+
+    SpectrumSampler wls_spectrum_; ///< Re-emission spectrum of the shifter
+    G4double wls_mean_photons_; ///< Mean number of re-emitted photons (0: one)
+    G4double wls_time_;         ///< Re-emission time constant
+  };
+
+  inline void WLSFiberFastModel::SetBarrel(G4bool barrel)
+  { barrel_ = barrel; }
+
+} // end namespace nexus
+
+#endif
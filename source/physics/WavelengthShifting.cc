@@ -26,7 +26,7 @@ namespace nexus {
   using namespace CLHEP;
 
   WavelengthShifting::WavelengthShifting(const G4String& name, G4ProcessType type):
-    G4VDiscreteProcess(name, type), wlsIntegralTable_(0)
+    G4VDiscreteProcess(name, type)
   {
     ParticleChange_ = new G4ParticleChange();
     pParticleChange = ParticleChange_;
@@ -40,10 +40,6 @@ namespace nexus {
   WavelengthShifting::~WavelengthShifting()
   {
     delete ParticleChange_;
-    if (wlsIntegralTable_ != 0) {
-      wlsIntegralTable_->clearAndDestroy();
-      delete wlsIntegralTable_;
-    }
     delete WLSTimeGeneratorProfile_;
   }
 
@@ -83,16 +79,15 @@ namespace nexus {
    if (rndm > conversion_efficiency) {
      return G4VDiscreteProcess::PostStepDoIt(track, step);
    }
-   ParticleChange_->SetNumberOfSecondaries(1);
-
    G4int materialIndex = material->GetIndex();
-   G4PhysicsOrderedFreeVector* WLSIntegral  =
-     (G4PhysicsOrderedFreeVector*)((*wlsIntegralTable_)(materialIndex));
+   if (materialIndex >= G4int(wlsSpectra_.size()) ||
+       wlsSpectra_[materialIndex].IsEmpty())
+     return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+   ParticleChange_->SetNumberOfSecondaries(1);
 
    // Sample the energy randomly
-   G4double wls_max = WLSIntegral->GetMaxValue();
-   G4double wls_value = G4UniformRand()*wls_max;
-   G4double sampledEnergy = WLSIntegral->GetEnergy(wls_value);
+   G4double sampledEnergy = wlsSpectra_[materialIndex].Shoot();
 
    // Generate random photon direction
    G4double costheta = 1. - 2.*G4UniformRand();
@@ -152,22 +147,17 @@ namespace nexus {
 
   void WavelengthShifting::BuildThePhysicsTable()
   {
-    if (wlsIntegralTable_) return;
+    if (!wlsSpectra_.empty()) return;
 
     const G4MaterialTable* theMaterialTable =
       G4Material::GetMaterialTable();
     G4int numOfMaterials = G4Material::GetNumberOfMaterials();
 
-    // create new physics table
-    if(!wlsIntegralTable_)
-      wlsIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+    wlsSpectra_.resize(numOfMaterials);
 
     // loop for materials
 
     for (G4int i=0 ; i < numOfMaterials; i++) {
-      G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-	new G4PhysicsOrderedFreeVector();
-
       // Retrieve vector of WLS wavelength intensity for
       // the material from the material's optical properties table.
       G4Material* aMaterial = (*theMaterialTable)[i];
@@ -179,13 +169,9 @@ namespace nexus {
 	G4MaterialPropertyVector* theWLSVector =
 	  aMaterialPropertiesTable->GetProperty("WLSCOMPONENT");
 	if (theWLSVector) {
-	  ComputeCumulativeDistribution(*theWLSVector, *aPhysicsOrderedFreeVector);
+	  wlsSpectra_[i] = SpectrumSampler(*theWLSVector);
 	}
       }
-      // The WLS integral for a given material
-      // will be inserted in the table according to the
-      // position of the material in the material table.
-      wlsIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
     }
   }
 
@@ -217,21 +203,4 @@ namespace nexus {
      return AttenuationLength;
   }
 
-  void WavelengthShifting::ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf,
-							 G4PhysicsOrderedFreeVector& cdf)
-  {
-    if (pdf[0] >= 0.0) {
-      // The first entry of the cumulative distribution function is zero.
-      cdf.InsertValues(pdf.Energy(0), 0.0);
-
-      G4double area_sum = 0.;
-      // loop over all (photon energy, intensity) pairs stored for this material
-      // and add the areas calculated with the trapezoidal rule
-      for (size_t j = 1; j < pdf.GetVectorLength(); j++) {
-	area_sum = cdf[j-1] + (pdf[j-1] + pdf[j]) * (pdf.Energy(j) - pdf.Energy(j-1)) * 0.5 ;
-	cdf.InsertValues(pdf.Energy(j), area_sum);
-      }
-    }
-  }
-
 }
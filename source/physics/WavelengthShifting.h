@@ -16,8 +16,9 @@
 #ifndef WLS_H
 #define WLS_H
 
+#include "SpectrumSampler.h"
+
 #include <G4VDiscreteProcess.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
 
 class G4ParticleChange;
 class G4VWLSTimeGeneratorProfile;
@@ -38,11 +39,10 @@ namespace nexus {
 
   private:
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf, G4PhysicsOrderedFreeVector& cdf);
 
   private:
     G4ParticleChange* ParticleChange_;
-    G4PhysicsTable* wlsIntegralTable_;
+    std::vector<SpectrumSampler> wlsSpectra_; ///< WLS emission spectrum by material index
     G4VWLSTimeGeneratorProfile*  WLSTimeGeneratorProfile_;
 
   };
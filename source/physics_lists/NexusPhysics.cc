@@ -13,6 +13,8 @@
 #include "IonizationDrift.h"
 #include "Electroluminescence.h"
 #include "OpPhotoelectricEffect.h"
+#include "OpticalAbsorber.h"
+#include "DetectionPreSampling.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4OpticalPhoton.hh>
@@ -33,7 +35,10 @@ namespace nexus {
 
   NexusPhysics::NexusPhysics():
     G4VPhysicsConstructor("NexusPhysics"),
-    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false)
+    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false),
+    bulk_drift_(false), cluster_size_(1),
+    auto_absorbers_(false), absorber_reflectivity_(0.01), absorber_tally_(false),
+    pde_presampling_(false), fast_simulation_(false)
   {
     msg_ = new G4GenericMessenger(this, "/PhysicsList/Nexus/",
       "Control commands of the nexus physics list.");
@@ -50,6 +55,41 @@ namespace nexus {
     msg_->DeclareProperty("photoelectric", photoelectric_,
       "Switch on/off the photoelectric effect.");
 
+    msg_->DeclareProperty("bulk_drift", bulk_drift_,
+      "Drift the ionization electrons of each step in bulk, "
+      "tracking them only from the end of the drift region.");
+
+    G4GenericMessenger::Command& cluster_cmd =
+      msg_->DeclareProperty("cluster_size", cluster_size_,
+        "Number of electrons simulated as a single ionization electron.");
+    cluster_cmd.SetParameterName("cluster_size", false);
+    cluster_cmd.SetRange("cluster_size >= 1");
+
+    msg_->DeclareMethod("absorber_volume", &NexusPhysics::AddAbsorberVolume,
+      "Logical volume where optical photons are killed on entry.");
+
+    msg_->DeclareMethod("absorber_material", &NexusPhysics::AddAbsorberMaterial,
+      "Material where optical photons are killed on entry.");
+
+    msg_->DeclareProperty("auto_absorbers", auto_absorbers_,
+      "Kill optical photons on entry to volumes that absorb them all.");
+
+    G4GenericMessenger::Command& refl_cmd =
+      msg_->DeclareProperty("absorber_reflectivity", absorber_reflectivity_,
+        "Maximum reflectivity of the surface of an automatic absorber.");
+    refl_cmd.SetParameterName("absorber_reflectivity", false);
+    refl_cmd.SetRange("absorber_reflectivity >= 0. && absorber_reflectivity <= 1.");
+
+    msg_->DeclareProperty("absorber_tally", absorber_tally_,
+      "Count the optical photons killed in each absorber.");
+
+    msg_->DeclareProperty("pde_presampling", pde_presampling_,
+      "Keep the EL and scintillation-generator photons with the maximum "
+      "sensor efficiency at emission, renormalizing the sensor efficiencies.");
+
+    msg_->DeclareProperty("fast_simulation", fast_simulation_,
+      "Apply the fast simulation models (e.g. of WLS fibers) to optical photons.");
+
   }
 
 
@@ -61,6 +101,20 @@ namespace nexus {
 
 
 
+  void NexusPhysics::AddAbsorberVolume(const G4String& name)
+  {
+    absorber_volumes_.push_back(name);
+  }
+
+
+
+  void NexusPhysics::AddAbsorberMaterial(const G4String& name)
+  {
+    absorber_materials_.push_back(name);
+  }
+
+
+
   void NexusPhysics::ConstructParticle()
   {
     IonizationElectron::Definition();
@@ -72,6 +126,8 @@ namespace nexus {
 
   void NexusPhysics::ConstructProcess()
   {
+    EnableDetectionPreSampling(pde_presampling_);
+
     G4ProcessManager* pmanager = 0;
 
     pmanager = IonizationElectron::Definition()->GetProcessManager();
@@ -105,6 +161,8 @@ namespace nexus {
     if (clustering_) {
 
       IonizationClustering* clust = new IonizationClustering();
+      clust->SetBulkDrift(bulk_drift_);
+      clust->SetClusterSize(cluster_size_);
 
       auto aParticleIterator = GetParticleIterator();
       aParticleIterator->reset();
@@ -135,6 +193,33 @@ namespace nexus {
         }
       }
     }
+
+    // Kill optical photons entering absorbers, before
+    // any other optical process is invoked at the boundary
+
+    if (auto_absorbers_ || !absorber_volumes_.empty() ||
+        !absorber_materials_.empty()) {
+      OpticalAbsorber* absorber = new OpticalAbsorber();
+      for (const auto& name: absorber_volumes_)   absorber->AddVolume(name);
+      for (const auto& name: absorber_materials_) absorber->AddMaterial(name);
+      absorber->SetAutomatic(auto_absorbers_);
+      absorber->SetMaxReflectivity(absorber_reflectivity_);
+      absorber->SetTally(absorber_tally_);
+
+      pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(absorber);
+      pmanager->SetProcessOrdering(absorber, idxPostStep, 1);
+    }
+
+    // Let the fast simulation models defined in the geometry
+    // (see WLSFiberFastModel) take over optical photons
+
+    if (fast_simulation_) {
+      G4FastSimulationManagerProcess* fastsim =
+        new G4FastSimulationManagerProcess("fast_sim_man");
+      pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(fastsim);
+    }
   }
 
 } // end namespace nexus
@@ -11,6 +11,8 @@
 
 #include <G4VPhysicsConstructor.hh>
 
+#include <vector>
+
 class G4GenericMessenger;
 
 
@@ -29,11 +31,26 @@ namespace nexus {
     /// Construct all required physics processes (Geant4 mandatory method)
     virtual void ConstructProcess();
 
+  private:
+    /// Add an optical absorber given by volume or material name
+    void AddAbsorberVolume(const G4String&);
+    void AddAbsorberMaterial(const G4String&);
+
   private:
     G4bool clustering_;          ///< Switch on/of the ionization clustering
     G4bool drift_;               ///< Switch on/of the ionization drift
     G4bool electroluminescence_; ///< Switch on/off the electroluminescence
     G4bool photoelectric_;       ///< Switch on/off the photoelectric effect
+    G4bool bulk_drift_;          ///< Drift the ionization electrons in bulk
+    G4int cluster_size_;         ///< Electrons per simulated ionization electron
+
+    std::vector<G4String> absorber_volumes_;   ///< Absorbers by volume name
+    std::vector<G4String> absorber_materials_; ///< Absorbers by material name
+    G4bool auto_absorbers_;          ///< Find absorbers from their optical surfaces
+    G4double absorber_reflectivity_; ///< Max. reflectivity of automatic absorbers
+    G4bool absorber_tally_;          ///< Count the photons killed in each absorber
+    G4bool pde_presampling_;         ///< Apply the detection efficiency at emission
+    G4bool fast_simulation_;         ///< Fast simulation models for optical photons
 
     G4GenericMessenger* msg_;
   };
@@ -0,0 +1,171 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDigitization.cc
+//
+// Digitization options of the waveforms recorded by each type of
+// photosensor, applied by SensorSD at the end of every event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorDigitization.h"
+
+#include <G4GenericMessenger.hh>
+
+
+namespace nexus {
+
+
+  SensorDigitization& SensorDigitization::Instance()
+  {
+    static SensorDigitization instance;
+    return instance;
+  }
+
+
+
+  SensorDigitization::SensorDigitization(): selected_("")
+  {
+    msg_ = std::make_unique<G4GenericMessenger>(this, "/nexus/digitization/",
+      "Digitization of the sensor waveforms.");
+
+    msg_->DeclareMethod("sensor", &SensorDigitization::SelectSensor,
+      "Select the type of sensor (sensitive detector name) configured "
+      "by the following commands.");
+
+    G4GenericMessenger::Command& rebin_cmd =
+      msg_->DeclareMethod("rebin", &SensorDigitization::SetRebin,
+                          "Number of time bins merged into one.");
+    rebin_cmd.SetParameterName("rebin", false);
+    rebin_cmd.SetRange("rebin>=1");
+
+    G4GenericMessenger::Command& window_cmd =
+      msg_->DeclareMethodWithUnit("time_window", "ns",
+                                  &SensorDigitization::SetTimeWindow,
+                                  "Time kept after the first photon (0 for all).");
+    window_cmd.SetParameterName("time_window", false);
+    window_cmd.SetRange("time_window>=0.");
+
+    G4GenericMessenger::Command& sns_thr_cmd =
+      msg_->DeclareMethod("sensor_threshold", &SensorDigitization::SetSensorThreshold,
+                          "Minimum number of photons in a sensor.");
+    sns_thr_cmd.SetParameterName("sensor_threshold", false);
+    sns_thr_cmd.SetRange("sensor_threshold>=0");
+
+    G4GenericMessenger::Command& bin_thr_cmd =
+      msg_->DeclareMethod("bin_threshold", &SensorDigitization::SetBinThreshold,
+                          "Minimum number of photons in a time bin.");
+    bin_thr_cmd.SetParameterName("bin_threshold", false);
+    bin_thr_cmd.SetRange("bin_threshold>=0");
+
+    msg_->DeclareMethod("integrated_charge", &SensorDigitization::SetIntegrated,
+      "Store only the total charge of each sensor.");
+  }
+
+
+
+  SensorDigitization::~SensorDigitization()
+  {
+  }
+
+
+
+  const DigitizationParameters&
+  SensorDigitization::GetParameters(const G4String& sdname) const
+  {
+    auto it = parameters_.find(sdname);
+    return (it == parameters_.end()) ? defaults_ : it->second;
+  }
+
+
+
+  void SensorDigitization::SelectSensor(const G4String& sdname)
+  {
+    selected_ = sdname;
+    parameters_[selected_];
+  }
+
+
+
+  DigitizationParameters& SensorDigitization::Selected()
+  {
+    if (selected_ == "") {
+      G4Exception("[SensorDigitization]", "Selected()", FatalException,
+                  "No sensor type selected with /nexus/digitization/sensor.");
+    }
+    return parameters_[selected_];
+  }
+
+
+
+  void SensorDigitization::SetRebin(G4int rebin)
+  {
+    Selected().rebin = rebin;
+  }
+
+
+
+  void SensorDigitization::SetTimeWindow(G4double window)
+  {
+    Selected().time_window = window;
+  }
+
+
+
+  void SensorDigitization::SetSensorThreshold(G4int threshold)
+  {
+    Selected().sensor_threshold = threshold;
+  }
+
+
+
+  void SensorDigitization::SetBinThreshold(G4int threshold)
+  {
+    Selected().bin_threshold = threshold;
+  }
+
+
+
+  void SensorDigitization::SetIntegrated(G4bool integrated)
+  {
+    Selected().integrated = integrated;
+  }
+
+
+
+  G4bool SensorDigitization::Digitize(const DigitizationParameters& params,
+                                      std::map<G4double, G4int>& histogram,
+                                      G4double first_time)
+  {
+    if (histogram.empty()) return false;
+
+    if (params.time_window > 0.) {
+      G4double end = first_time + params.time_window;
+      histogram.erase(histogram.lower_bound(end), histogram.end());
+    }
+
+    G4int charge = 0;
+    for (const auto& bin: histogram) charge += bin.second;
+
+    if (charge == 0 || charge < params.sensor_threshold) {
+      histogram.clear();
+      return false;
+    }
+
+    if (params.integrated) {
+      G4double first_bin = histogram.begin()->first;
+      histogram.clear();
+      histogram[first_bin] = charge;
+      return true;
+    }
+
+    if (params.bin_threshold > 0) {
+      for (auto it = histogram.begin(); it != histogram.end(); ) {
+        if (it->second < params.bin_threshold) it = histogram.erase(it);
+        else ++it;
+      }
+    }
+
+    return !histogram.empty();
+  }
+
+} // end namespace nexus
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorDigitization.h
+//
+// Digitization options of the waveforms recorded by each type of
+// photosensor, applied by SensorSD at the end of every event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_DIGITIZATION_H
+#define SENSOR_DIGITIZATION_H
+
+#include <G4String.hh>
+
+#include <map>
+#include <memory>
+
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  /// Digitization parameters of a type of sensor. The default values
+  /// leave the waveforms untouched.
+  struct DigitizationParameters
+  {
+    G4int    rebin            = 1;     ///< Time bins merged into one
+    G4double time_window      = 0.;    ///< Kept time after the first photon (0: all)
+    G4int    sensor_threshold = 0;     ///< Min. photons in the sensor
+    G4int    bin_threshold    = 0;     ///< Min. photons in a time bin
+    G4bool   integrated       = false; ///< Keep only the total charge
+  };
+
+  /// Digitization parameters of all types of sensors, identified by the
+  /// name of their sensitive detector (e.g. SiPM, PmtR11410), set through
+  /// the /nexus/digitization/ commands. The instance is created when the
+  /// application starts, so the commands can be used in configuration
+  /// macros.
+
+  class SensorDigitization
+  {
+  public:
+    static SensorDigitization& Instance();
+
+    /// Destructor
+    ~SensorDigitization();
+
+    /// Returns the parameters of a type of sensor
+    const DigitizationParameters& GetParameters(const G4String& sdname) const;
+
+    /// Applies the digitization to the sparse histogram of a sensor
+    /// (photons per time bin, already rebinned), whose first photon
+    /// arrived at first_time. The bins starting at or after the end of
+    /// the time window, which opens with that photon, are dropped first
+    /// (the last bin kept may extend beyond it), then the sensor threshold is
+    /// applied to the remaining charge, and finally the bins below the
+    /// bin threshold are dropped, or all the charge is stored in the
+    /// first bin in integrated mode. Returns false if the sensor has
+    /// no charge left.
+    static G4bool Digitize(const DigitizationParameters&,
+                           std::map<G4double, G4int>& histogram,
+                           G4double first_time);
+
+  private:
+    SensorDigitization();
+
+    void SelectSensor(const G4String&);
+    /// Parameters of the selected type of sensor
+    DigitizationParameters& Selected();
+    void SetRebin(G4int);
+    void SetTimeWindow(G4double);
+    void SetSensorThreshold(G4int);
+    void SetBinThreshold(G4int);
+    void SetIntegrated(G4bool);
+
+  private:
+    std::unique_ptr<G4GenericMessenger> msg_;
+
+    DigitizationParameters defaults_;
+    std::map<G4String, DigitizationParameters> parameters_;
+    G4String selected_; ///< Sensor type configured by the commands
+  };
+
+} // end namespace nexus
+
+#endif
@@ -8,6 +8,8 @@
 
 #include "SensorHit.h"
 
+#include <algorithm>
+
 
 using namespace nexus;
 
@@ -17,14 +19,15 @@ G4Allocator<SensorHit> SensorHitAllocator;
 
 
 SensorHit::SensorHit():
-  G4VHit(), sns_id_(-1.), bin_size_(0.)
+  G4VHit(), sns_id_(-1.), bin_size_(0.), first_time_(DBL_MAX)
 {
 }
 
 
 
 SensorHit::SensorHit(G4int id, const G4ThreeVector& position, G4double bin_size):
-  G4VHit(), sns_id_(id),  bin_size_(bin_size), position_(position)
+  G4VHit(), sns_id_(id),  bin_size_(bin_size), position_(position),
+  first_time_(DBL_MAX)
 {
 }
 
@@ -48,6 +51,7 @@ const SensorHit& SensorHit::operator=(const SensorHit& other)
   sns_id_    = other.sns_id_;
   bin_size_  = other.bin_size_;
   position_  = other.position_;
+  first_time_ = other.first_time_;
   histogram_ = other.histogram_;
 
   return *this;
@@ -79,4 +83,5 @@ void SensorHit::Fill(G4double time, G4int counts)
 {
   G4double time_bin = floor(time/bin_size_) * bin_size_;
   histogram_[time_bin] += counts;
+  first_time_ = std::min(first_time_, time);
 }
@@ -58,12 +58,17 @@ namespace nexus {
     /// Adds counts to a given time bin
     void Fill(G4double time, G4int counts=1);
 
+    /// Time of the first photon filled (DBL_MAX if none)
+    G4double GetFirstTime() const;
+
     const std::map<G4double, G4int>& GetHistogram() const;
+    std::map<G4double, G4int>& GetHistogram();
 
   private:
     G4int sns_id_;           ///< Detector ID number
     G4double bin_size_;      ///< Size of time bin
     G4ThreeVector position_; ///< Detector position
+    G4double first_time_;    ///< Time of the first photon
 
     /// Sparse histogram with number of photons detected per time bin
     std::map<G4double, G4int> histogram_;
@@ -91,12 +96,17 @@ namespace nexus {
 
   inline G4double SensorHit::GetBinSize() const { return bin_size_; }
 
+  inline G4double SensorHit::GetFirstTime() const { return first_time_; }
+
   inline G4ThreeVector SensorHit::GetPosition() const { return position_; }
   inline void SensorHit::SetPosition(const G4ThreeVector& p) { position_ = p; }
 
   inline const std::map<G4double, G4int>& SensorHit::GetHistogram() const
   { return histogram_; }
 
+  inline std::map<G4double, G4int>& SensorHit::GetHistogram()
+  { return histogram_; }
+
 } // namespace nexus
 
 #endif
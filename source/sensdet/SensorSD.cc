@@ -22,7 +22,7 @@ namespace nexus {
 
   SensorSD::SensorSD(G4String sdname):
     G4VSensitiveDetector(sdname),
-    naming_order_(0), sensor_depth_(0), mother_depth_(0)
+    naming_order_(0), sensor_depth_(0), mother_depth_(0), digi_(nullptr)
   {
     // Register the name of the collection of hits
     collectionName.insert(GetCollectionUniqueName());
@@ -52,6 +52,8 @@ namespace nexus {
       GetCollectionID(this->GetName()+"/"+this->GetCollectionName(0));
 
     HCE->AddHitsCollection(HCID, HC_);
+
+    digi_ = &SensorDigitization::Instance().GetParameters(this->GetName());
   }
 
 
@@ -80,7 +82,7 @@ namespace nexus {
     if (!hit) {
       hit = new SensorHit();
       hit->SetSensorID(pmt_id);
-      hit->SetBinSize(timebinning_);
+      hit->SetBinSize(timebinning_ * digi_->rebin);
       hit->SetPosition(touchable->GetTranslation());
       HC_->insert(hit);
     }
@@ -106,12 +108,17 @@ namespace nexus {
 
   void SensorSD::EndOfEvent(G4HCofThisEvent* /*HCE*/)
   {
-    //  int HCID = G4SDManager::GetSDMpointer()->
-    //    GetCollectionID(this->GetCollectionName(0));
-    //  // }
-    // HCE->AddHitsCollection(HCID, HC_);
-
-
+    // Drop the sensors left without charge by the digitization
+    std::vector<SensorHit*>& hits = *HC_->GetVector();
+    std::size_t nkept = 0;
+    for (SensorHit* hit: hits) {
+      if (SensorDigitization::Digitize(*digi_, hit->GetHistogram(),
+                                       hit->GetFirstTime()))
+        hits[nkept++] = hit;
+      else
+        delete hit;
+    }
+    hits.resize(nkept);
   }
 
 
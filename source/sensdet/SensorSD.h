@@ -12,6 +12,7 @@
 
 #include <G4VSensitiveDetector.hh>
 #include "SensorHit.h"
+#include "SensorDigitization.h"
 
 class G4Step;
 class G4HCofThisEvent;
@@ -35,7 +36,8 @@ namespace nexus {
     /// in the event (so that it can be retrieved thru the G4HCofThisEvent object).
     void Initialize(G4HCofThisEvent*);
 
-    /// Method invoked at the end of every event
+    /// Method invoked at the end of every event. The digitization
+    /// options of this type of sensor are applied here.
     void EndOfEvent(G4HCofThisEvent*);
 
     /// Set the depth of the sensitive detector in the geometry hierarchy
@@ -74,6 +76,8 @@ namespace nexus {
     G4double timebinning_; ///< Time bin width
 
     SensorHitsCollection* HC_; ///< Pointer to the collection of hits
+
+    const DigitizationParameters* digi_; ///< Digitization of this type of sensor
   };
 
   // INLINE METHODS //////////////////////////////////////////////////
@@ -0,0 +1,77 @@
+#include "TrackHistory.h"
+
+#include <G4Track.hh>
+#include <G4Step.hh>
+#include <G4DynamicParticle.hh>
+#include <G4Electron.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4VDiscreteProcess.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+#include <cfloat>
+
+
+namespace {
+
+  // Process with only a name
+  class TestProcess: public G4VDiscreteProcess {
+  public:
+    TestProcess(const G4String& name): G4VDiscreteProcess(name) {}
+
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) override
+    { return DBL_MAX; }
+  };
+
+}
+
+
+TEST_CASE("TrackHistory") {
+  // These tests record tracks as the tracking actions do at the end
+  // of their tracking, and look for their particles and processes
+
+  TestProcess scint("Scintillation"), absorption("OpAbsorption");
+
+  // Optical photon created by scintillation and absorbed
+  G4Track photon(new G4DynamicParticle(G4OpticalPhoton::Definition(),
+                                       G4ThreeVector(0., 0., 1.), 3. * eV),
+                 0., G4ThreeVector());
+  photon.SetCreatorProcess(&scint);
+  G4Step step;
+  step.GetPostStepPoint()->SetProcessDefinedStep(&absorption);
+  photon.SetStep(&step);
+
+  nexus::TrackHistory::Clear();
+
+  SECTION ("Disabled") {
+    nexus::TrackHistory::Enable(false);
+    nexus::TrackHistory::Record(&photon);
+    REQUIRE_FALSE (nexus::TrackHistory::HasParticle("opticalphoton"));
+  }
+
+  SECTION ("Particles and processes") {
+    nexus::TrackHistory::Enable(true);
+    nexus::TrackHistory::Record(&photon);
+
+    REQUIRE (nexus::TrackHistory::HasParticle("opticalphoton"));
+    REQUIRE (nexus::TrackHistory::HasProcess("Scintillation"));
+    REQUIRE (nexus::TrackHistory::HasProcess("OpAbsorption"));
+    REQUIRE_FALSE (nexus::TrackHistory::HasParticle("e-"));
+    REQUIRE_FALSE (nexus::TrackHistory::HasProcess("eIoni"));
+
+    // A primary without step yet
+    G4Track electron(new G4DynamicParticle(G4Electron::Definition(),
+                                           G4ThreeVector(0., 0., 1.), 1. * MeV),
+                     0., G4ThreeVector());
+    nexus::TrackHistory::Record(&electron);
+    REQUIRE (nexus::TrackHistory::HasParticle("e-"));
+
+    nexus::TrackHistory::Clear();
+    REQUIRE_FALSE (nexus::TrackHistory::HasParticle("e-"));
+    REQUIRE_FALSE (nexus::TrackHistory::HasProcess("Scintillation"));
+  }
+
+  nexus::TrackHistory::Enable(false);
+  nexus::TrackHistory::Clear();
+}
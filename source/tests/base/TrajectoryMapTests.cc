@@ -0,0 +1,63 @@
+#include "TrajectoryMap.h"
+
+#include <G4VTrajectory.hh>
+
+#include <catch.hpp>
+
+
+namespace {
+
+  // Trajectory with only a track ID
+  class TestTrajectory: public G4VTrajectory {
+  public:
+    TestTrajectory(G4int id, G4int parent): id_(id), parent_(parent) {}
+
+    G4int GetTrackID() const override { return id_; }
+    G4int GetParentID() const override { return parent_; }
+    G4String GetParticleName() const override { return "e-"; }
+    G4double GetCharge() const override { return -1.; }
+    G4int GetPDGEncoding() const override { return 11; }
+    G4ThreeVector GetInitialMomentum() const override { return G4ThreeVector(); }
+    G4int GetPointEntries() const override { return 0; }
+    G4VTrajectoryPoint* GetPoint(G4int) const override { return nullptr; }
+    void AppendStep(const G4Step*) override {}
+    void MergeTrajectory(G4VTrajectory*) override {}
+
+  private:
+    G4int id_, parent_;
+  };
+
+}
+
+
+TEST_CASE("TrajectoryMap stored ancestors") {
+  // These tests build the map as the tracking action does when
+  // it drops some tracks, and check the IDs that the hits and
+  // the particles of dropped tracks are assigned to
+
+  nexus::TrajectoryMap::Clear();
+
+  // Primary 1 and its secondary 4 are stored; secondary 2 of
+  // the primary and its own secondary 3 are dropped
+  TestTrajectory primary(1, 0), stored(4, 1);
+  nexus::TrajectoryMap::Add(&primary);
+  nexus::TrajectoryMap::Link(2, nexus::TrajectoryMap::Get(1));
+  nexus::TrajectoryMap::Link(3, nexus::TrajectoryMap::Get(2));
+  nexus::TrajectoryMap::Add(&stored);
+
+  SECTION ("Stored tracks keep their ID") {
+    REQUIRE (nexus::TrajectoryMap::StoredAncestor(1) == 1);
+    REQUIRE (nexus::TrajectoryMap::StoredAncestor(4) == 4);
+  }
+
+  SECTION ("Hits of dropped secondaries go to the stored ancestor") {
+    REQUIRE (nexus::TrajectoryMap::StoredAncestor(2) == 1);
+    REQUIRE (nexus::TrajectoryMap::StoredAncestor(3) == 1);
+  }
+
+  SECTION ("Tracks unknown to the map keep their ID") {
+    REQUIRE (nexus::TrajectoryMap::StoredAncestor(7) == 7);
+  }
+
+  nexus::TrajectoryMap::Clear();
+}
@@ -40,4 +40,15 @@ TEST_CASE("XenonProperties::Density") {
                     "Unknown xenon density for this temperature");
   }
 
+  SECTION ("Limits of the table"){
+    // The edges of the table (0-30 bar, 273-314 K) are valid
+    // and give the tabulated densities
+    REQUIRE (GetGasDensity(30 * bar, 273 * kelvin)/(kg/m3) == Approx(232.44));
+    REQUIRE (GetGasDensity(30 * bar, 314 * kelvin)/(kg/m3) == Approx(177.21));
+    REQUIRE (GetGasDensity( 0 * bar, 314 * kelvin)/(kg/m3) == Approx(0.).margin(1.e-9));
+    REQUIRE_THROWS (GetGasDensity(30.01 * bar, 295 * kelvin));
+    REQUIRE_THROWS (GetGasDensity(15 * bar, 314.01 * kelvin));
+    REQUIRE_THROWS (GetGasDensity(15 * bar, 272.99 * kelvin));
+  }
+
 }
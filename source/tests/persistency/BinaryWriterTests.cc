@@ -0,0 +1,154 @@
+#include "BinaryWriter.h"
+#include "BinaryReader.h"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+
+
+namespace {
+
+  // Writer keeping a text log of the calls it receives
+  class RecordingWriter: public nexus::WriterBase {
+  public:
+    std::string GetExtension() const override { return ".log"; }
+
+    void Open(std::string, bool debug, bool save_str, bool light_table,
+              bool sparse_sns, bool event_info) override
+    { log << "Open " << debug << save_str << light_table << sparse_sns << event_info << "\n"; }
+    void Close() override { log << "Close\n"; }
+    std::string Checkpoint() override { return ""; }
+    void Resume(std::string, bool, bool, bool, bool, bool,
+                const std::string&) override {}
+
+    void WriteRunInfo(const char* key, const char* value) override
+    { log << "RunInfo " << key << " " << value << "\n"; }
+    void WriteSensorDataInfo(int64_t evt, unsigned int sensor, unsigned int bin, unsigned int charge) override
+    { log << "SensorData " << evt << " " << sensor << " " << bin << " " << charge << "\n"; }
+    void WriteSensorWaveform(unsigned int sensor, const std::vector<std::pair<unsigned int, float>>& data) override
+    {
+      log << "SensorWaveform " << sensor;
+      for (const auto& bin: data) log << " " << bin.first << ":" << bin.second;
+      log << "\n";
+    }
+    void WriteSensorEvent(int64_t evt) override
+    { log << "SensorEvent " << evt << "\n"; }
+    void WriteHitInfo(bool str, int64_t evt, int particle, int hit, float x, float y, float z, float time, float energy, const char* label_str, int label) override
+    {
+      log << "HitInfo " << evt << " " << particle << " " << hit << " " << x << " " << y << " "
+          << z << " " << time << " " << energy << " ";
+      if (str) log << label_str << "\n";
+      else     log << label << "\n";
+    }
+    void WriteParticleInfo(bool str, int64_t evt, int particle, const char* name_str, int name, char primary, int mother, float x0, float y0, float z0, float t0, float x1, float y1, float z1, float t1, const char* ini_vol_str, const char* fin_vol_str, int ini_vol, int fin_vol, float px0, float py0, float pz0, float px1, float py1, float pz1, float energy, float length, const char* creator_str, const char* final_str, int creator, int final) override
+    {
+      log << "ParticleInfo " << evt << " " << particle << " " << (int)primary << " " << mother << " "
+          << x0 << " " << y0 << " " << z0 << " " << t0 << " " << x1 << " " << y1 << " " << z1 << " " << t1 << " "
+          << px0 << " " << py0 << " " << pz0 << " " << px1 << " " << py1 << " " << pz1 << " "
+          << energy << " " << length << " ";
+      if (str) log << name_str << " " << ini_vol_str << " " << fin_vol_str << " " << creator_str << " " << final_str << "\n";
+      else     log << name << " " << ini_vol << " " << fin_vol << " " << creator << " " << final << "\n";
+    }
+    void WriteSensorPosInfo(unsigned int sensor, const char* name, float x, float y, float z) override
+    { log << "SensorPos " << sensor << " " << name << " " << x << " " << y << " " << z << "\n"; }
+    void WriteStep(int64_t evt, int particle, const char* name, int step, const char* ini_vol, const char* fin_vol, const char* proc, float x0, float y0, float z0, float x1, float y1, float z1, float time) override
+    {
+      log << "Step " << evt << " " << particle << " " << name << " " << step << " " << ini_vol << " "
+          << fin_vol << " " << proc << " " << x0 << " " << y0 << " " << z0 << " " << x1 << " "
+          << y1 << " " << z1 << " " << time << "\n";
+    }
+    void WriteStringMapInfo(const char* name, int id) override
+    { log << "StringMap " << name << " " << id << "\n"; }
+    void WriteLightTablePoint(unsigned int point, float x, float y, float z, uint64_t nphotons) override
+    { log << "LightTablePoint " << point << " " << x << " " << y << " " << z << " " << nphotons << "\n"; }
+    void WriteLightTableProb(unsigned int point, unsigned int sensor, uint64_t charge, float prob) override
+    { log << "LightTableProb " << point << " " << sensor << " " << charge << " " << prob << "\n"; }
+    void WriteEventInfo(int64_t evt, char selected, uint64_t seed) override
+    { log << "EventInfo " << evt << " " << (int)selected << " " << seed << "\n"; }
+
+    std::ostringstream log;
+  };
+
+  // One call of each kind
+  void WriteSample(nexus::WriterBase& writer, bool str)
+  {
+    typedef std::vector<std::pair<unsigned int, float>> Waveform;
+
+    writer.WriteRunInfo("num_events", "10");
+    writer.WriteSensorDataInfo(3, 1000, 25, 4);
+    writer.WriteSensorWaveform(7, Waveform{{10, 1.}, {11, 2.}, {15, 4.}});
+    writer.WriteSensorEvent(3);
+    writer.WriteHitInfo(str, 3, 1, 0, 1.5, -2.5, 300., 12.5, 0.25, "ACTIVE", 4);
+    writer.WriteParticleInfo(str, 3, 1, "e-", 2, 1, 0,
+                             1., 2., 3., 4., 5., 6., 7., 8.,
+                             "ACTIVE", "BUFFER", 4, 5,
+                             0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 2.458, 150.,
+                             "none", "eIoni", 0, 6);
+    writer.WriteSensorPosInfo(1000, "PmtR11410", 10., -20., -500.);
+    writer.WriteStep(3, 1, "e-", 2, "ACTIVE", "ACTIVE", "msc",
+                     1., 2., 3., 1.5, 2.5, 3.5, 0.125);
+    writer.WriteStringMapInfo("ACTIVE", 4);
+    writer.WriteLightTablePoint(11, 0.5, 1.5, 2.5, 100000);
+    writer.WriteLightTableProb(11, 1000, 512, 0.00512);
+    writer.WriteEventInfo(3, 1, 123456789012345);
+  }
+
+}
+
+
+TEST_CASE("BinaryWriter round trip") {
+  // These tests write one record of each kind to a binary file and
+  // check that it is converted into the same calls that produced it
+
+  std::string filename = std::string(P_tmpdir) + "/nexus_binarywriter_test.bin";
+
+  for (bool str: {false, true}) {
+    nexus::BinaryWriter writer;
+    writer.Open(filename, true, str, false, true, true);
+    WriteSample(writer, str);
+    writer.Close();
+
+    RecordingWriter expected;
+    expected.Open("", true, str, false, true, true);
+    WriteSample(expected, str);
+    expected.Close();
+
+    nexus::BinaryReader reader;
+    REQUIRE (reader.Open(filename));
+    REQUIRE (reader.GetDebug());
+    REQUIRE (reader.GetSaveStr() == str);
+    REQUIRE_FALSE (reader.GetLightTable());
+    REQUIRE (reader.GetSparseSns());
+    REQUIRE (reader.GetEventInfo());
+
+    RecordingWriter converted;
+    REQUIRE (reader.Convert(converted, ""));
+    REQUIRE (converted.log.str() == expected.log.str());
+  }
+
+  SECTION ("Truncated file") {
+    auto size = std::filesystem::file_size(filename);
+    std::filesystem::resize_file(filename, size - 3);
+
+    nexus::BinaryReader reader;
+    REQUIRE (reader.Open(filename));
+    RecordingWriter converted;
+    REQUIRE_FALSE (reader.Convert(converted, ""));
+    // The records before the last one are converted
+    REQUIRE (converted.log.str().find("LightTableProb") != std::string::npos);
+    REQUIRE (converted.log.str().find("EventInfo") == std::string::npos);
+  }
+
+  SECTION ("Not a binary output file") {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    std::fputs("NEXUSTXT and more", file);
+    std::fclose(file);
+
+    nexus::BinaryReader reader;
+    REQUIRE_FALSE (reader.Open(filename));
+  }
+
+  std::remove(filename.c_str());
+}
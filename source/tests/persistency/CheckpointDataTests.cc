@@ -0,0 +1,88 @@
+#include "CheckpointData.h"
+
+#include <catch.hpp>
+
+#include <sstream>
+
+
+TEST_CASE("Checkpoint round trip") {
+  // These tests write the state of a job to a checkpoint,
+  // read it back and compare the bookkeeping
+
+  nexus::CheckpointData data;
+  data.events           = 2000;
+  data.store_steps      = false;
+  data.save_str         = true;
+  data.light_table      = true;
+  data.sparse_sns       = true;
+  data.start_id         = 5000;
+  data.output_format    = "binary";
+  data.save_rejected    = true;
+  data.event_seeding    = true;
+  data.run_seed         = 12345678901;
+  data.writer_position  = "12 0 345 1 6789 ";
+  data.nevt             = 7000;
+  data.first_evt        = false;
+  data.saved_evts       = 1500;
+  data.interacting_evts = 1200;
+  data.str_counter      = 3;
+  data.str_map          = {{"ACTIVE", 0}, {"FIELD CAGE", 1}, {"eIoni", 2}};
+  data.sensors          = {1000, 1001, 25000};
+  data.sensdet_bin      = {{"PmtR11410", 0.025}, {"SiPM Board", 1. / 3.}};
+  data.lt_points        = {G4ThreeVector(0.1, -2.5, 300.),
+                           G4ThreeVector(1. / 7., 0., -1e-9)};
+  data.lt_nphotons      = {100000, 250000};
+  data.lt_charge        = {{{1000, 512}, {1001, 3}}, {}};
+  data.absorbed         = {{"BUFFER", 42}, {"TEFLON PANEL", 7}};
+  data.engine_state     = "MixMaxRng-begin\n1\n2\n3\nMixMaxRng-end\n";
+
+  std::stringstream file;
+  data.Write(file);
+
+  nexus::CheckpointData read;
+  REQUIRE (read.Read(file));
+
+  SECTION ("Options") {
+    REQUIRE (read.store_steps   == data.store_steps);
+    REQUIRE (read.save_str      == data.save_str);
+    REQUIRE (read.light_table   == data.light_table);
+    REQUIRE (read.sparse_sns    == data.sparse_sns);
+    REQUIRE (read.start_id      == data.start_id);
+    REQUIRE (read.output_format == data.output_format);
+    REQUIRE (read.save_rejected == data.save_rejected);
+    REQUIRE (read.event_seeding == data.event_seeding);
+    REQUIRE (read.run_seed      == data.run_seed);
+  }
+
+  SECTION ("Bookkeeping") {
+    REQUIRE (read.events           == data.events);
+    REQUIRE (read.writer_position  == data.writer_position);
+    REQUIRE (read.nevt             == data.nevt);
+    REQUIRE (read.first_evt        == data.first_evt);
+    REQUIRE (read.saved_evts       == data.saved_evts);
+    REQUIRE (read.interacting_evts == data.interacting_evts);
+    REQUIRE (read.str_counter      == data.str_counter);
+    REQUIRE (read.str_map          == data.str_map);
+    REQUIRE (read.sensors          == data.sensors);
+    REQUIRE (read.sensdet_bin      == data.sensdet_bin);
+    REQUIRE (read.absorbed         == data.absorbed);
+    REQUIRE (read.engine_state     == data.engine_state);
+  }
+
+  SECTION ("Light table") {
+    // The coordinates are exact, as they index the points
+    REQUIRE (read.lt_points.size() == 2);
+    REQUIRE (read.lt_points[1].x() == data.lt_points[1].x());
+    REQUIRE (read.lt_points[1].z() == data.lt_points[1].z());
+    REQUIRE (read.lt_nphotons      == data.lt_nphotons);
+    REQUIRE (read.lt_charge        == data.lt_charge);
+  }
+
+  SECTION ("Incomplete checkpoint") {
+    // A file cut before the random engine is rejected
+    std::string text = file.str();
+    std::istringstream cut(text.substr(0, text.find("engine")));
+    nexus::CheckpointData incomplete;
+    REQUIRE_FALSE (incomplete.Read(cut));
+  }
+}
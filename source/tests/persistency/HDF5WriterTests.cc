@@ -0,0 +1,143 @@
+#include "HDF5Writer.h"
+#include "SensorDataReader.h"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <vector>
+
+
+TEST_CASE("HDF5Writer sparse sensor response") {
+  // These tests write the sensor response of a few events with the
+  // sparse layout (sns_events, sns_sensors, sns_runs and sns_charges)
+  // and read it back
+
+  std::string filename = std::string(P_tmpdir) + "/nexus_hdf5writer_test.h5";
+
+  typedef std::vector<std::pair<unsigned int, float>> Waveform;
+
+  SECTION ("Round trip") {
+    nexus::HDF5Writer writer;
+    writer.Open(filename, false, false, false, true);
+
+    // Event 3: two sensors, the first with two runs of time bins
+    writer.WriteSensorWaveform(7,  Waveform{{10, 1.}, {11, 2.}, {15, 4.}});
+    writer.WriteSensorWaveform(12, Waveform{{0, 3.}});
+    writer.WriteSensorEvent(3);
+    // Event 4: no charge
+    writer.WriteSensorEvent(4);
+    // Event 8: a sensor without charge is skipped
+    writer.WriteSensorWaveform(2, Waveform{});
+    writer.WriteSensorWaveform(5, Waveform{{100, 6.}, {101, 5.}});
+    writer.WriteSensorEvent(8);
+    writer.Close();
+
+    nexus::SensorDataReader reader;
+    REQUIRE (reader.Open(filename));
+    REQUIRE (reader.GetNumberOfEvents() == 3);
+
+    int64_t event_id;
+    std::vector<nexus::SensorDataReader::Sample> samples;
+
+    REQUIRE (reader.ReadEvent(0, event_id, samples));
+    REQUIRE (event_id == 3);
+    REQUIRE (samples.size() == 4);
+    REQUIRE (samples[1].sensor_id == 7);
+    REQUIRE (samples[1].time_bin  == 11);
+    REQUIRE (samples[1].charge    == 2);
+    REQUIRE (samples[2].time_bin  == 15);
+    REQUIRE (samples[2].charge    == 4);
+    REQUIRE (samples[3].sensor_id == 12);
+    REQUIRE (samples[3].time_bin  == 0);
+    REQUIRE (samples[3].charge    == 3);
+
+    REQUIRE (reader.ReadEvent(1, event_id, samples));
+    REQUIRE (event_id == 4);
+    REQUIRE (samples.empty());
+
+    uint64_t index;
+    REQUIRE (reader.FindEvent(8, index));
+    REQUIRE (index == 2);
+    REQUIRE (reader.ReadEvent(index, event_id, samples));
+    REQUIRE (samples.size() == 2);
+    REQUIRE (samples[0].sensor_id == 5);
+    REQUIRE (samples[1].time_bin  == 101);
+    REQUIRE (samples[1].charge    == 5);
+
+    REQUIRE_FALSE (reader.FindEvent(5, index));
+    REQUIRE_FALSE (reader.ReadEvent(3, event_id, samples));
+  }
+
+  SECTION ("Unordered event IDs") {
+    // Files of several runs, or of replayed events, may repeat
+    // IDs or store them out of order
+    nexus::HDF5Writer writer;
+    writer.Open(filename, false, false, false, true);
+    writer.WriteSensorWaveform(1, Waveform{{0, 1.}});
+    writer.WriteSensorEvent(7);
+    writer.WriteSensorWaveform(2, Waveform{{0, 1.}});
+    writer.WriteSensorEvent(2);
+    writer.WriteSensorWaveform(3, Waveform{{0, 1.}});
+    writer.WriteSensorEvent(7);
+    writer.WriteSensorWaveform(4, Waveform{{0, 1.}});
+    writer.WriteSensorEvent(0);
+    writer.Close();
+
+    nexus::SensorDataReader reader;
+    REQUIRE (reader.Open(filename));
+
+    uint64_t index;
+    REQUIRE (reader.FindEvent(2, index));
+    REQUIRE (index == 1);
+    REQUIRE (reader.FindEvent(0, index));
+    REQUIRE (index == 3);
+    REQUIRE (reader.FindEvent(7, index));
+    REQUIRE (index == 0);
+    REQUIRE_FALSE (reader.FindEvent(5, index));
+  }
+
+  SECTION ("Resume from a checkpoint") {
+    // The events written after the checkpoint are dropped
+    nexus::HDF5Writer writer;
+    writer.Open(filename, false, false, false, true, true);
+    writer.WriteSensorWaveform(7, Waveform{{10, 1.}});
+    writer.WriteSensorEvent(3);
+    writer.WriteEventInfo(3, 1, 0);
+    std::string position = writer.Checkpoint();
+    writer.WriteSensorWaveform(9, Waveform{{20, 2.}});
+    writer.WriteSensorEvent(4);
+    writer.WriteEventInfo(4, 1, 0);
+    writer.Close();
+
+    nexus::HDF5Writer resumed;
+    resumed.Resume(filename, false, false, false, true, true, position);
+    resumed.WriteSensorWaveform(5, Waveform{{100, 6.}});
+    resumed.WriteSensorEvent(8);
+    resumed.WriteEventInfo(8, 1, 0);
+    resumed.Close();
+
+    nexus::SensorDataReader reader;
+    REQUIRE (reader.Open(filename));
+    REQUIRE (reader.GetNumberOfEvents() == 2);
+
+    int64_t event_id;
+    std::vector<nexus::SensorDataReader::Sample> samples;
+    REQUIRE (reader.ReadEvent(1, event_id, samples));
+    REQUIRE (event_id == 8);
+    REQUIRE (samples.size() == 1);
+    REQUIRE (samples[0].sensor_id == 5);
+    REQUIRE (samples[0].charge    == 6);
+  }
+
+  SECTION ("Light table") {
+    // The light table replaces the sensor response
+    nexus::HDF5Writer writer;
+    writer.Open(filename, false, false, true, true);
+    writer.Close();
+
+    nexus::SensorDataReader reader;
+    REQUIRE_FALSE (reader.Open(filename));
+  }
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,158 @@
+#include "FieldMapDriftField.h"
+
+#include <G4SystemOfUnits.hh>
+#include <G4LorentzVector.hh>
+#include <G4StateManager.hh>
+#include <G4VExceptionHandler.hh>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+  // Turns the fatal exceptions of Geant4 into C++ ones
+  class ThrowingHandler: public G4VExceptionHandler {
+  public:
+    ~ThrowingHandler()
+    { G4StateManager::GetStateManager()->SetExceptionHandler(nullptr); }
+
+    G4bool Notify(const char*, const char*, G4ExceptionSeverity,
+                  const char* description) override
+    { throw std::runtime_error(description); }
+  };
+
+  // Writes a map in the format of scripts/create_drift_field_map.py,
+  // with the fields of each node given by a function of its position
+  template <typename F>
+  void WriteMap(const std::string& filename, uint32_t ndim,
+                std::vector<uint64_t> n, std::vector<double> min,
+                std::vector<double> step, F fields)
+  {
+    std::ofstream out(filename, std::ios::binary);
+    const uint32_t version = 1;
+    out.write("NXDRIFT", 8);
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&ndim), sizeof(ndim));
+    out.write(reinterpret_cast<const char*>(n.data()),    3 * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(min.data()),  3 * sizeof(double));
+    out.write(reinterpret_cast<const char*>(step.data()), 3 * sizeof(double));
+
+    for (uint64_t k=0; k<n[2]; ++k)
+      for (uint64_t j=0; j<n[1]; ++j)
+        for (uint64_t i=0; i<n[0]; ++i) {
+          std::vector<float> v = fields(min[0] + i * step[0],
+                                        min[1] + j * step[1],
+                                        min[2] + k * step[2]);
+          out.write(reinterpret_cast<const char*>(v.data()), 5 * sizeof(float));
+        }
+  }
+
+}
+
+
+TEST_CASE("FieldMapDriftField") {
+  // These tests drift electrons through small maps without diffusion,
+  // so that the arrival point and time are those interpolated
+
+  std::string filename = std::string(P_tmpdir) + "/nexus_driftfieldmap_test.bin";
+
+  // Anode at z = 0 and cathode at z = 100 mm
+  const G4double anode = 0., cathode = 100. * mm;
+  const G4double end = -1. * micrometer;
+
+  SECTION ("3D map") {
+    // Fields linear in the coordinates, which the trilinear
+    // interpolation reproduces exactly (mm, mm/us)
+    auto velocity = [](double x, double y, double z)
+      { return 1. + 0.01 * x - 0.02 * y + 0.005 * z; };
+    WriteMap(filename, 3, {2, 2, 3}, {-10., -10., 0.}, {20., 20., 50.},
+             [&](double x, double y, double z) -> std::vector<float>
+             { return {float(velocity(x, y, z)), 0.f, 0.f,
+                       float(0.5 + 0.1 * x), float(-0.2 * z)}; });
+
+    nexus::FieldMapDriftField field(filename, anode, cathode);
+
+    // Inside the grid
+    G4LorentzVector xyzt(3. * mm, -4. * mm, 30. * mm, 10. * ns);
+    field.Drift(xyzt);
+    REQUIRE (xyzt.x() == Approx(3.  + 0.5 + 0.3));
+    REQUIRE (xyzt.y() == Approx(-4. - 6.));
+    REQUIRE (xyzt.z() == Approx(end));
+    REQUIRE (xyzt.t() ==
+             Approx(10. * ns + 30. * mm / (velocity(3., -4., 30.) * mm/microsecond)));
+
+    // Outside the grid along x and y, the values of the boundary
+    xyzt.set(10. * ns, G4ThreeVector(25. * mm, -40. * mm, 30. * mm));
+    field.Drift(xyzt);
+    REQUIRE (xyzt.x() == Approx(25. + 0.5 + 1.));
+    REQUIRE (xyzt.y() == Approx(-40. - 6.));
+    REQUIRE (xyzt.t() ==
+             Approx(10. * ns + 30. * mm / (velocity(10., -10., 30.) * mm/microsecond)));
+
+    // Outside the drift region the electron doesn't move
+    xyzt.set(10. * ns, G4ThreeVector(0., 0., 120. * mm));
+    REQUIRE (field.Drift(xyzt) == 0.);
+    REQUIRE (xyzt.z() == 120. * mm);
+  }
+
+  SECTION ("r-z map") {
+    // The displacements are radial and azimuthal, and turn
+    // with the position of the electron
+    WriteMap(filename, 2, {3, 2, 1}, {0., 0., 0.}, {10., 100., 0.},
+             [](double r, double, double) -> std::vector<float>
+             { return {1.f, 0.f, 0.f, float(0.1 * r), 0.5f}; });
+
+    nexus::FieldMapDriftField field(filename, anode, cathode);
+
+    G4LorentzVector xyzt(0., 5. * mm, 50. * mm, 0.);
+    field.Drift(xyzt);
+    REQUIRE (xyzt.x() == Approx(-0.5));
+    REQUIRE (xyzt.y() == Approx(5.5));
+    REQUIRE (xyzt.t() == Approx(50. * microsecond));
+
+    xyzt.set(0., G4ThreeVector(-3. * mm, 0., 50. * mm));
+    field.Drift(xyzt);
+    REQUIRE (xyzt.x() == Approx(-3.3));
+    REQUIRE (xyzt.y() == Approx(-0.5));
+
+    // Beyond the largest radius of the map
+    xyzt.set(0., G4ThreeVector(30. * mm, 0., 50. * mm));
+    field.Drift(xyzt);
+    REQUIRE (xyzt.x() == Approx(32.));
+    REQUIRE (xyzt.y() == Approx(0.5));
+  }
+
+  SECTION ("Invalid maps") {
+    ThrowingHandler handler;
+    G4StateManager::GetStateManager()->SetExceptionHandler(&handler);
+
+    auto uniform = [](double, double, double) -> std::vector<float>
+      { return {1.f, 0.f, 0.f, 0.f, 0.f}; };
+
+    // Unknown number of dimensions
+    WriteMap(filename, 4, {2, 2, 2}, {0., 0., 0.}, {1., 1., 1.}, uniform);
+    REQUIRE_THROWS (nexus::FieldMapDriftField(filename, anode, cathode));
+
+    // Nodes on top of each other
+    WriteMap(filename, 3, {2, 2, 2}, {0., 0., 0.}, {1., 0., 1.}, uniform);
+    REQUIRE_THROWS (nexus::FieldMapDriftField(filename, anode, cathode));
+
+    // Fewer nodes than the header says
+    WriteMap(filename, 3, {2, 2, 2}, {0., 0., 0.}, {1., 1., 1.}, uniform);
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 4);
+    REQUIRE_THROWS (nexus::FieldMapDriftField(filename, anode, cathode));
+
+    // Missing file
+    std::remove(filename.c_str());
+    REQUIRE_THROWS (nexus::FieldMapDriftField(filename, anode, cathode));
+  }
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,117 @@
+#include "IonizationClustering.h"
+#include "UniformElectricDriftField.h"
+
+#include <G4SystemOfUnits.hh>
+#include <G4Material.hh>
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4Region.hh>
+#include <G4Navigator.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4Electron.hh>
+#include <G4DynamicParticle.hh>
+#include <G4VParticleChange.hh>
+
+#include <catch.hpp>
+
+#include <cmath>
+
+
+TEST_CASE("IonizationClustering::BulkDrift") {
+  // These tests check that the ionization electrons deposited
+  // inside the EL gap are tracked, so that they produce EL light,
+  // even when the bulk drift is enabled
+
+  nexus::UniformElectricDriftField drift(0., 50. * cm);
+  nexus::UniformElectricDriftField el(-5. * mm, 0.);
+  el.SetLightYield(1000. / cm);
+
+  nexus::IonizationClustering clustering;
+
+  SECTION ("Bulk drift enabled") {
+    clustering.SetBulkDrift(true);
+    REQUIRE(clustering.BulkDrift(drift));
+    REQUIRE_FALSE(clustering.BulkDrift(el));
+  }
+
+  SECTION ("Bulk drift disabled") {
+    clustering.SetBulkDrift(false);
+    REQUIRE_FALSE(clustering.BulkDrift(drift));
+    REQUIRE_FALSE(clustering.BulkDrift(el));
+  }
+}
+
+
+TEST_CASE("IonizationClustering::PostStepDoIt") {
+  // These tests deposit energy in a region with a drift field and
+  // check that the weights of the ionization electrons add up to
+  // the charge, whatever the size of the clusters
+
+  G4Material* gas = new G4Material("IonizationClusteringTestGas", 54.,
+                                   131.29 * g/mole, 5. * kg/m3, kStateGas);
+  G4Box* box = new G4Box("CLUSTERING_TEST", 1. * m, 1. * m, 1. * m);
+  G4LogicalVolume* logic = new G4LogicalVolume(box, gas, "CLUSTERING_TEST");
+  G4VPhysicalVolume* world =
+    new G4PVPlacement(0, G4ThreeVector(), logic, "CLUSTERING_TEST", 0, false, 0);
+
+  nexus::UniformElectricDriftField* field =
+    new nexus::UniformElectricDriftField(-50. * cm, 50. * cm);
+  G4Region* region = new G4Region("CLUSTERING_TEST");
+  region->AddRootLogicalVolume(logic);
+  region->SetUserInformation(field);
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+  navigator.LocateGlobalPointAndSetup(G4ThreeVector());
+  G4TouchableHandle touchable(navigator.CreateTouchableHistory());
+
+  // 100 keV deposited along 1 cm, with the default W_i and Fano factor
+  const G4double energy = 100. * keV;
+  const G4double mean   = energy / (22.4 * eV);
+  const G4double sigma  = std::sqrt(mean * .15);
+
+  G4Step step;
+  for (G4StepPoint* point: {step.GetPreStepPoint(), step.GetPostStepPoint()}) {
+    point->SetMaterial(gas);
+    point->SetTouchableHandle(touchable);
+  }
+  step.GetPostStepPoint()->SetPosition(G4ThreeVector(0., 0., 1. * cm));
+  step.GetPostStepPoint()->SetGlobalTime(1. * ns);
+  step.SetTotalEnergyDeposit(energy);
+
+  G4Track track(new G4DynamicParticle(G4Electron::Definition(),
+                                      G4ThreeVector(0., 0., 1.), 1. * MeV),
+                0., G4ThreeVector());
+  track.SetTouchableHandle(touchable);
+  track.SetStep(&step);
+
+  nexus::IonizationClustering clustering;
+
+  for (G4int cluster_size: {1, 10}) {
+    for (G4double parent_weight: {1., 2.}) {
+      clustering.SetClusterSize(cluster_size);
+      track.SetWeight(parent_weight);
+
+      G4VParticleChange* change = clustering.PostStepDoIt(track, step);
+
+      G4double charge = 0.;
+      G4int partial = 0;
+      for (G4int i=0; i<change->GetNumberOfSecondaries(); ++i) {
+        G4double weight = change->GetSecondary(i)->GetWeight() / parent_weight;
+        REQUIRE (weight <= cluster_size);
+        if (weight < cluster_size) partial++;
+        charge += weight;
+        delete change->GetSecondary(i);
+      }
+
+      // Only the last cluster may be smaller
+      REQUIRE (partial <= 1);
+      REQUIRE (std::abs(charge - mean) < 5. * sigma);
+    }
+  }
+
+  region->SetUserInformation(0);
+  delete field;
+}
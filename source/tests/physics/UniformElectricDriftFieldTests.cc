@@ -0,0 +1,36 @@
+#include "UniformElectricDriftField.h"
+#include "ElectronBatch.h"
+
+#include <G4SystemOfUnits.hh>
+#include <G4LorentzVector.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("UniformElectricDriftField drift end") {
+  // These tests check that the drifted electrons are left just past
+  // the anode, away from the cathode, where the EL region begins
+
+  for (G4double cathode: {50. * cm, -50. * cm}) {
+    nexus::UniformElectricDriftField field(0., cathode);
+    field.SetDriftVelocity(1. * mm/microsecond);
+    field.SetTransverseDiffusion(1. * mm/sqrt(cm));
+    field.SetLongitudinalDiffusion(0.3 * mm/sqrt(cm));
+
+    const G4double end = cathode > 0. ? -1. * micrometer : 1. * micrometer;
+
+    G4LorentzVector xyzt(1. * cm, 2. * cm, cathode / 2., 0.);
+    field.Drift(xyzt);
+    REQUIRE (xyzt.z() == Approx(end));
+
+    nexus::ElectronBatch batch;
+    batch.Resize(100);
+    for (std::size_t i=0; i<batch.Size(); ++i)
+      batch.Set(i, G4LorentzVector(0., 0., cathode * (i+0.5) / 100., 0.));
+    field.DriftBatch(batch);
+
+    REQUIRE (batch.Size() == 100);
+    for (std::size_t i=0; i<batch.Size(); ++i)
+      REQUIRE (batch.z[i] == Approx(end));
+  }
+}
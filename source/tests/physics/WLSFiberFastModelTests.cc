@@ -0,0 +1,130 @@
+#include "WLSFiberFastModel.h"
+
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4Region.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+#include <cmath>
+#include <random>
+
+
+namespace {
+
+  G4Material* OpticalMaterial(const G4String& name, G4double rindex,
+                              G4double abslength)
+  {
+    G4Material* mat = new G4Material(name, 1., 1.008*g/mole, 1.*g/cm3);
+    G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
+    mpt->AddProperty("RINDEX", {2.*eV, 4.*eV}, {rindex, rindex});
+    if (abslength > 0.)
+      mpt->AddProperty("ABSLENGTH", {2.*eV, 4.*eV}, {abslength, abslength});
+    mat->SetMaterialPropertiesTable(mpt);
+    return mat;
+  }
+
+}
+
+
+TEST_CASE("WLSFiberFastModel") {
+  // These tests compare the light collected at the ends of a fiber
+  // barrel (a cylindrical shell) with the model and by following
+  // the photons through all their reflections
+
+  const G4double r1     = 494. * mm;
+  const G4double r2     = 496. * mm;
+  const G4double length = 1.2 * m;
+  const G4double n_core = 1.59;
+  const G4double n_clad = 1.42;
+  const G4double abslength = 3. * m;
+  const G4double energy = 3. * eV;
+
+  static G4Material* core = OpticalMaterial("WLSFiberFastModelTests_CORE",
+                                            n_core, abslength);
+  static G4Material* clad = OpticalMaterial("WLSFiberFastModelTests_CLAD",
+                                            n_clad, 0.);
+  static G4Region* region = new G4Region("WLSFiberFastModelTests_CORE");
+
+  nexus::WLSFiberFastModel model(region, core, clad, length);
+
+  SECTION ("Fiber trapping") {
+    const G4ThreeVector position(0., 0., 0.);
+    REQUIRE (model.Trapped(energy, position, G4ThreeVector(0., 0., 1.)));
+    REQUIRE_FALSE (model.Trapped(energy, position, G4ThreeVector(1., 0., 0.)));
+    REQUIRE (model.Attenuation(energy).first == Approx(1. / abslength));
+    REQUIRE (model.Attenuation(energy).second == 0.);
+  }
+
+  SECTION ("Barrel yield") {
+    model.SetBarrel(true);
+
+    const G4double mu = 1. / abslength;
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<G4double> uniform(0., 1.);
+
+    G4double yield_model = 0.;
+    G4double yield_full  = 0.;
+    const G4int num_photons = 20000;
+
+    for (G4int i=0; i<num_photons; ++i) {
+      // Isotropic emission at a random depth of the shell
+      G4double r = std::sqrt(r1*r1 + uniform(rng) * (r2*r2 - r1*r1));
+      G4ThreeVector position(r, 0., -length/4.);
+      G4double cos_theta = 1. - 2. * uniform(rng);
+      G4double sin_theta = std::sqrt(1. - cos_theta * cos_theta);
+      G4double phi = twopi * uniform(rng);
+      G4ThreeVector direction(sin_theta * std::cos(phi),
+                              sin_theta * std::sin(phi), cos_theta);
+
+      if (model.Trapped(energy, position, direction))
+        yield_model += std::exp(-mu * model.PathToEnd(position, direction));
+
+      // Straight segments between the walls of the shell, where the
+      // photon is reflected if beyond the critical angle and lost
+      // otherwise, until it reaches an end
+      G4ThreeVector p = position;
+      G4ThreeVector d = direction;
+      G4double path = 0.;
+      while (mu * path < 50.) {
+        G4double a = d.perp2();
+        G4double b = p.x() * d.x() + p.y() * d.y();
+        G4double c = p.perp2();
+
+        G4double t_wall = DBL_MAX;
+        if (a > 0.) {
+          t_wall = (-b + std::sqrt(b*b - a * (c - r2*r2))) / a;
+          G4double disc = b*b - a * (c - r1*r1);
+          if (disc >= 0.) {
+            G4double t_inner = (-b - std::sqrt(disc)) / a;
+            if (t_inner > 1.e-9 && t_inner < t_wall) t_wall = t_inner;
+          }
+        }
+
+        G4double t_end = DBL_MAX;
+        if (d.z() != 0.)
+          t_end = ((d.z() > 0. ? length/2. : -length/2.) - p.z()) / d.z();
+
+        if (t_end <= t_wall) {
+          yield_full += std::exp(-mu * (path + t_end));
+          break;
+        }
+
+        path += t_wall;
+        p += t_wall * d;
+        G4ThreeVector normal = G4ThreeVector(p.x(), p.y(), 0.).unit();
+        G4double cos_normal = d.dot(normal);
+        if (1. - cos_normal * cos_normal <= (n_clad/n_core) * (n_clad/n_core))
+          break;
+        d -= 2. * cos_normal * normal;
+      }
+    }
+
+    yield_model /= num_photons;
+    yield_full  /= num_photons;
+
+    REQUIRE (yield_full > 0.2);
+    REQUIRE (yield_model == Approx(yield_full).epsilon(0.02));
+  }
+}
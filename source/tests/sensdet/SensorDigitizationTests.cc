@@ -0,0 +1,79 @@
+#include "SensorDigitization.h"
+
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("SensorDigitization::Digitize") {
+  // These tests check the digitization of the sparse histogram
+  // of a sensor with 1-us time bins, whose first photon arrived
+  // at 1.8 us
+
+  const std::map<G4double, G4int> waveform = {
+    {1. * microsecond, 1}, {2. * microsecond, 3},
+    {3. * microsecond, 1}, {5. * microsecond, 2}};
+  const G4double first_time = 1.8 * microsecond;
+
+  nexus::DigitizationParameters params;
+  std::map<G4double, G4int> histogram = waveform;
+
+  SECTION ("Default parameters") {
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram == waveform);
+  }
+
+  SECTION ("Time window") {
+    // The window opens with the first photon, not with its bin:
+    // [1.8, 3.8) us keeps the bin starting at 3 us
+    params.time_window = 2. * microsecond;
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram.size() == 3);
+    REQUIRE (histogram.rbegin()->first == Approx(3. * microsecond));
+
+    histogram = waveform;
+    params.time_window = 1. * microsecond;
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram.size() == 2);
+  }
+
+  SECTION ("Sensor threshold") {
+    params.sensor_threshold = 7;
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+
+    params.sensor_threshold = 8;
+    REQUIRE_FALSE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram.empty());
+  }
+
+  SECTION ("Threshold after the time window") {
+    params.time_window = 1. * microsecond;
+    params.sensor_threshold = 5;
+    REQUIRE_FALSE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+  }
+
+  SECTION ("Bin threshold") {
+    params.bin_threshold = 2;
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram.size() == 2);
+    REQUIRE (histogram.count(2. * microsecond));
+    REQUIRE (histogram.count(5. * microsecond));
+
+    histogram = waveform;
+    params.bin_threshold = 4;
+    REQUIRE_FALSE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+  }
+
+  SECTION ("Integrated charge") {
+    params.integrated = true;
+    REQUIRE (nexus::SensorDigitization::Digitize(params, histogram, first_time));
+    REQUIRE (histogram.size() == 1);
+    REQUIRE (histogram.begin()->first == Approx(1. * microsecond));
+    REQUIRE (histogram.begin()->second == 7);
+  }
+
+  SECTION ("Empty histogram") {
+    histogram.clear();
+    REQUIRE_FALSE (nexus::SensorDigitization::Digitize(params, histogram, 0.));
+  }
+}
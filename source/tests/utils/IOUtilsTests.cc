@@ -0,0 +1,108 @@
+#include <IOUtils.h>
+
+#include <catch.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+
+TEST_CASE("Histogram csv loading") {
+  // These tests check that IOUtils reads the same histogram
+  // from the csv file and from its binary sidecar
+
+  std::string filename = std::string(P_tmpdir) + "/nexus_ioutils_test.csv";
+  std::string cachename = filename + ".bin";
+  std::remove(cachename.c_str());
+
+  std::ofstream out(filename);
+  out << "value,1.5,0.1,0.2,0.01,0.02\n"
+      << "value,2.5,0.3,0.4,0.03,0.04\n"
+      << "energy,10\n"
+      << "energy,0.5\n"
+      << "energy,100\n";
+  out.close();
+
+  std::vector<G4double> value, x, y, x_smear, y_smear;
+  nexus::LoadHistData2D(filename, value, x, y, x_smear, y_smear);
+
+  REQUIRE(value.size() == 2);
+  REQUIRE(value[1] == 2.5);
+  REQUIRE(x[0] == 0.1);
+  REQUIRE(y[1] == 0.4);
+  REQUIRE(y_smear[0] == 0.02);
+
+  // The sidecar is written on the first load
+  std::ifstream cache(cachename);
+  REQUIRE(cache.good());
+
+  // Bounds are computed in the same pass
+  const nexus::HistFileData& hist = nexus::LoadHistFile(filename);
+  REQUIRE(hist.bounds.at("energy").first  == 0.5);
+  REQUIRE(hist.bounds.at("energy").second == 100);
+  REQUIRE_NOTHROW(nexus::CheckVarBounds(filename, 1., 50., "energy"));
+
+  // The sidecar holds the same contents as the csv
+  nexus::HistFileData sidecar;
+  REQUIRE(nexus::ReadHistSidecar(filename, sidecar));
+  REQUIRE(sidecar.columns == hist.columns);
+  REQUIRE(sidecar.bounds  == hist.bounds);
+
+  // and it is ignored once the csv changes
+  out.open(filename, std::ios::app);
+  out << "value,3.5,0.5,0.6,0.05,0.06\n";
+  out.close();
+  nexus::HistFileData stale;
+  REQUIRE_FALSE(nexus::ReadHistSidecar(filename, stale));
+
+  std::remove(filename.c_str());
+  std::remove(cachename.c_str());
+}
+
+
+TEST_CASE("Number parsing") {
+  // These tests check that the locale-independent parsers
+  // read the formats found in the generator input files
+
+  std::string text = "   12  -3\n 0.411172E-03 -1.53577 2.5d2 .5 1e400 x";
+  const char* ptr = text.data();
+  const char* end = text.data() + text.size();
+
+  G4long i;
+  REQUIRE(nexus::ParseInteger(ptr, end, i));
+  REQUIRE(i == 12);
+  REQUIRE(nexus::ParseInteger(ptr, end, i));
+  REQUIRE(i == -3);
+
+  G4double x;
+  REQUIRE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(x == 0.411172E-03);
+  REQUIRE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(x == -1.53577);
+  REQUIRE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(x == 250.);
+  REQUIRE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(x == 0.5);
+  REQUIRE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(std::isinf(x));
+
+  const char* before = ptr;
+  REQUIRE_FALSE(nexus::ParseReal(ptr, end, x));
+  REQUIRE(ptr == before);
+}
+
+
+TEST_CASE("Number parsing rounding") {
+  // Numbers outside the exact fast path must be
+  // rounded to the nearest double, as strtod does
+
+  for (std::string text: {"9007199254740993", "123456789012345678901234",
+                          "0.30000000000000004441", "2.2250738585072014e-308",
+                          "1.7976931348623157e308", "4.9e-324", "1e23",
+                          "8.98846567431158e307", "3.14159265358979323846264"}) {
+    const char* ptr = text.data();
+    G4double x;
+    REQUIRE(nexus::ParseReal(ptr, text.data() + text.size(), x));
+    REQUIRE(x == std::strtod(text.c_str(), nullptr));
+  }
+}
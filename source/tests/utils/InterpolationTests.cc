@@ -1,5 +1,8 @@
 #include <Interpolation.h>
 
+#include <cmath>
+#include <vector>
+
 #include <catch.hpp>
 using Catch::Matchers::Contains;
 
@@ -157,3 +160,91 @@ TEST_CASE("Bilinear Interpolation"){
                     "x or y is not in the given interval");
   }
 }
+
+TEST_CASE("Batched Interpolation"){
+  // These tests check the batched interpolation functions on
+  // tables of linear functions, which they reproduce exactly
+
+  const G4double xq[] = {-1.0, 0.0, 0.25, 1.3, 2.0, 3.0};
+  const std::size_t n = sizeof(xq) / sizeof(xq[0]);
+  G4double result[n];
+
+  // f(x) = 2x + 1 on x = 0, .5, ... 2
+  const G4double f[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+  const nexus::GridAxis regular = nexus::GridAxis::Regular(0.0, 0.5, 5);
+  const G4double nodes[] = {0.0, 0.2, 1.0, 1.5, 2.0};
+  const G4double g[] = {1.0, 1.4, 3.0, 4.0, 5.0};
+  const nexus::GridAxis irregular = nexus::GridAxis::Irregular(nodes, 5);
+
+  SECTION ("1D clamp"){
+    REQUIRE (nexus::Interpolate1D(regular, f, n, xq, result) == 2);
+    REQUIRE (result[0] == Approx(1.0));
+    REQUIRE (result[2] == Approx(1.5));
+    REQUIRE (result[3] == Approx(3.6));
+    REQUIRE (result[4] == Approx(5.0));
+    REQUIRE (result[5] == Approx(5.0));
+  }
+
+  SECTION ("1D irregular grid"){
+    nexus::Interpolate1D(irregular, g, n, xq, result,
+                         nexus::OutOfRange::Extrapolate);
+    for (std::size_t q=0; q<n; ++q)
+      REQUIRE (result[q] == Approx(2.0 * xq[q] + 1.0));
+  }
+
+  SECTION ("1D error flag"){
+    REQUIRE (nexus::Interpolate1D(regular, f, n, xq, result,
+                                  nexus::OutOfRange::Flag) == 2);
+    REQUIRE (std::isnan(result[0]));
+    REQUIRE (result[1] == Approx(1.0));
+    REQUIRE (result[4] == Approx(5.0));
+    REQUIRE (std::isnan(result[5]));
+  }
+
+  SECTION ("1D cubic"){
+    // Quadratic function, exact at the nodes
+    const G4double h[] = {0.0, 0.25, 1.0, 2.25, 4.0};
+    nexus::InterpolateCubic1D(regular, h, n, xq, result,
+                              nexus::OutOfRange::Extrapolate);
+    REQUIRE (result[1] == Approx(0.0).margin(1.e-12));
+    REQUIRE (result[4] == Approx(4.0));
+    REQUIRE (result[3] == Approx(1.69).epsilon(0.02));
+    REQUIRE (result[5] > 4.0);
+
+    nexus::InterpolateCubic1D(irregular, g, n, xq, result);
+    REQUIRE (result[2] > 1.4);
+    REQUIRE (result[2] < 3.0);
+  }
+
+  SECTION ("2D and 3D"){
+    // f(x, y, z) = x + 2y + 3z on a 3x4x2 grid
+    const nexus::GridAxis ax = nexus::GridAxis::Regular(0.0, 1.0, 3);
+    const nexus::GridAxis ay = nexus::GridAxis::Irregular(nodes, 4);
+    const nexus::GridAxis az = nexus::GridAxis::Regular(-1.0, 2.0, 2);
+
+    std::vector<G4double> f2, f3;
+    for (G4int i=0; i<ax.n; ++i)
+      for (G4int j=0; j<ay.n; ++j) {
+        f2.push_back(ax.Node(i) + 2.0 * ay.Node(j));
+        for (G4int k=0; k<az.n; ++k)
+          f3.push_back(ax.Node(i) + 2.0 * ay.Node(j) + 3.0 * az.Node(k));
+      }
+
+    const G4double x[] = {0.5, 1.7, 2.0};
+    const G4double y[] = {0.1, 1.2, 1.5};
+    const G4double z[] = {-0.5, 0.0, 1.0};
+
+    REQUIRE (nexus::Interpolate2D(ax, ay, f2.data(), 3, x, y, result) == 0);
+    for (std::size_t q=0; q<3; ++q)
+      REQUIRE (result[q] == Approx(x[q] + 2.0 * y[q]));
+
+    REQUIRE (nexus::Interpolate3D(ax, ay, az, f3.data(), 3, x, y, z, result) == 0);
+    for (std::size_t q=0; q<3; ++q)
+      REQUIRE (result[q] == Approx(x[q] + 2.0 * y[q] + 3.0 * z[q]));
+
+    const G4double zout[] = {-2.0, 0.0, 2.0};
+    REQUIRE (nexus::Interpolate3D(ax, ay, az, f3.data(), 3, x, y, zout, result,
+                                  nexus::OutOfRange::Extrapolate) == 2);
+    REQUIRE (result[0] == Approx(x[0] + 2.0 * y[0] - 6.0));
+  }
+}
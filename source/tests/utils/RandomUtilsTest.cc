@@ -5,6 +5,7 @@
 #include <catch.hpp>
 #include <iostream>
 #include <cmath>
+#include <vector>
 using namespace std;
 
 TEST_CASE("Direction Function") {
@@ -41,3 +42,29 @@ TEST_CASE("Direction Function") {
   }
 
 }
+
+
+TEST_CASE("Event seeds") {
+
+  // The seed of an event depends on the run seed and on
+  // the event ID in the whole production only
+
+  REQUIRE(nexus::EventSeed(1234, 10, 0) == nexus::EventSeed(1234, 10, 0));
+  REQUIRE(nexus::EventSeed(1234, 10, 0) == nexus::EventSeed(1234, 0, 10));
+  REQUIRE(nexus::EventSeed(1234, 10, 0) != nexus::EventSeed(1234, 11, 0));
+  REQUIRE(nexus::EventSeed(1234, 10, 0) != nexus::EventSeed(1235, 10, 0));
+
+  // Reseeding with the seed of an event gives the same random numbers
+
+  nexus::SetEventSeed(nexus::EventSeed(1234, 10, 0));
+  std::vector<G4double> first;
+  for (G4int i=0; i<10; i++) first.push_back(G4UniformRand());
+
+  nexus::SetEventSeed(nexus::EventSeed(1234, 11, 0));
+  G4double other = G4UniformRand();
+
+  nexus::SetEventSeed(nexus::EventSeed(1234, 10, 0));
+  for (G4int i=0; i<10; i++) REQUIRE(G4UniformRand() == first[i]);
+
+  REQUIRE(other != first[0]);
+}
@@ -0,0 +1,60 @@
+#include <SpectrumSampler.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+
+TEST_CASE("Spectrum sampler") {
+  // These tests check that SpectrumSampler inverts exactly the
+  // cumulative distribution of a piecewise linear spectrum
+
+  // Spectrum with no intensity above 3: the cumulative distribution,
+  // taken as linear between nodes, is 0, 2/3, 1 and 1 at the nodes
+  const std::vector<G4double> energies    = {1.0, 2.0, 3.0, 4.0};
+  const std::vector<G4double> intensities = {1.0, 1.0, 0.0, 0.0};
+  nexus::SpectrumSampler sampler(energies, intensities);
+
+  SECTION ("Empty spectrum"){
+    REQUIRE (nexus::SpectrumSampler().IsEmpty());
+    REQUIRE (nexus::SpectrumSampler({1.0, 2.0}, {0.0, 0.0}).IsEmpty());
+    REQUIRE_FALSE (sampler.IsEmpty());
+  }
+
+  SECTION ("Quantiles"){
+    for (G4int i=0; i<=100; ++i) {
+      G4double u = i / 100.;
+      G4double e = (u < 2./3.) ? 1.0 + 1.5 * u : 2.0 + 3.0 * (u - 2./3.);
+      REQUIRE (sampler.Sample(u) == Approx(e));
+    }
+  }
+
+  SECTION ("Grid and exact inversion agree"){
+    // A flat spectrum has a linear inverse
+    nexus::SpectrumSampler flat({2.0, 4.0, 6.0}, {1.0, 1.0, 1.0});
+    for (G4int i=0; i<=100; ++i) {
+      G4double u = i / 100.;
+      REQUIRE (flat.Sample(u) == Approx(2.0 + 4.0 * u));
+    }
+  }
+
+  SECTION ("Cumulative distribution"){
+    REQUIRE (sampler.Cumulative(0.5) == 0.);
+    REQUIRE (sampler.Cumulative(1.5) == Approx(1./3.));
+    REQUIRE (sampler.Cumulative(3.5) == 1.);
+    REQUIRE (nexus::SpectrumSampler().Cumulative(2.0) == 0.);
+    for (G4int i=1; i<100; ++i) {
+      G4double u = i / 150.;
+      REQUIRE (sampler.Cumulative(sampler.Sample(u)) == Approx(u));
+    }
+  }
+
+  SECTION ("Monotonic"){
+    G4double previous = 0.;
+    for (G4int i=0; i<=1000; ++i) {
+      G4double e = sampler.Sample(i / 1000.);
+      REQUIRE (e >= previous);
+      previous = e;
+    }
+  }
+}
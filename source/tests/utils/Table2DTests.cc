@@ -0,0 +1,66 @@
+#include <Table2D.h>
+
+#include <catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+
+TEST_CASE("Table2D") {
+  // f(x, y) = 2x + 3y + 1 on x = 0, .5, 1, ... 2 and y = -1, 0, 1,
+  // which bilinear interpolation reproduces exactly
+  const G4int nx = 5;
+  const G4int ny = 3;
+  std::vector<G4double> values;
+  for (G4int i=0; i<nx; ++i)
+    for (G4int j=0; j<ny; ++j)
+      values.push_back(2. * (.5*i) + 3. * (-1. + j) + 1.);
+
+  nexus::Table2D table(0., 2., nx, -1., 1., ny, values);
+
+  SECTION ("Range"){
+    REQUIRE (table.GetXMax() == 2.);
+    REQUIRE (table.GetYMax() == 1.);
+    REQUIRE (table.InRangeX(2.));
+    REQUIRE_FALSE (table.InRangeX(2.1));
+    REQUIRE_FALSE (table.InRangeY(-1.1));
+  }
+
+  SECTION ("Nodes and edges"){
+    REQUIRE (table.Interpolate(0., -1.) == Approx(-2.));
+    REQUIRE (table.Interpolate(2., 1.) == Approx(8.));
+    REQUIRE (table.Interpolate(1., 0.) == Approx(3.));
+  }
+
+  SECTION ("Inside cells"){
+    REQUIRE (table.Interpolate(.3, .4)   == Approx(2.8));
+    REQUIRE (table.Interpolate(1.7, -.9) == Approx(1.7));
+  }
+
+  SECTION ("Outside the grid"){
+    REQUIRE (table.Interpolate(-1., 0.) == Approx(table.Interpolate(0., 0.)));
+    REQUIRE (table.Interpolate(1., 5.)  == Approx(table.Interpolate(1., 1.)));
+  }
+
+  SECTION ("Single points and batches agree"){
+    const std::vector<G4double> x = {-.2, 0., .3, 1.25, 1.7, 2., 2.6};
+    const std::vector<G4double> y = {.4, -1., -.9, 0., 1., 1.3, -4.};
+    std::vector<G4double> result(x.size());
+    table.Interpolate(x.size(), x.data(), y.data(), result.data());
+    for (std::size_t q=0; q<x.size(); ++q)
+      REQUIRE (table.Interpolate(x[q], y[q]) == Approx(result[q]));
+  }
+
+  SECTION ("NaN coordinates"){
+    const G4double nan = std::nan("");
+    REQUIRE (std::isnan(table.Interpolate(nan, 0.)));
+    REQUIRE (std::isnan(table.Interpolate(1., nan)));
+
+    const G4double x[2] = {nan, 1.};
+    const G4double y[2] = {0., 0.};
+    G4double result[2];
+    table.Interpolate(2, x, y, result);
+    REQUIRE (std::isnan(result[0]));
+    REQUIRE (result[1] == Approx(3.));
+  }
+}
@@ -7,201 +7,488 @@
 // ----------------------------------------------------------------------------
 #include "IOUtils.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace nexus {
 
   // --------
 
-  // Input file format:
-  // value,<intensity in bin>,<histogram x bin i centre>,<histogram x bin i width>
-  void LoadHistData1D(std::string filename, std::vector<G4double> &value,
-                                    std::vector<G4double> &x, std::vector<G4double> &x_smear){
-    
-    // Open the file
-    std::ifstream FileIn_(filename);
+  MappedFile::MappedFile(const std::string& filename):
+    open_(false), data_(nullptr), size_(0)
+  {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      open_ = true;
+      size_ = st.st_size;
+      if (size_ > 0) {
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+          open_ = false;
+          size_ = 0;
+        }
+        else {
+          data_ = static_cast<const char*>(addr);
+        }
+      }
+    }
 
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData1D()",
-                FatalException, " could not read in the CSV file ");
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+  }
+
+
+  MappedFile::~MappedFile()
+  {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+  }
+
+  // --------
+
+  std::uint64_t HashBytes(const char* data, std::size_t size, std::uint64_t seed)
+  {
+    std::uint64_t hash = seed;
+    for (std::size_t i=0; i<size; ++i) {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
     }
+    return hash;
+  }
 
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x;
-    std::string s_x_smear;
+  // --------
+
+  namespace {
+
+    inline G4bool IsBlank(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    inline G4bool IsDigit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    inline G4bool ParseSign(const char*& ptr, const char* end)
+    {
+      G4bool negative = false;
+      if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+        negative = (*ptr == '-');
+        ++ptr;
+      }
+      return negative;
+    }
 
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
+  }
 
-      std::getline(FileIn_, s_header, ',');
 
-      if (s_header == "value"){
+  G4bool ParseInteger(const char*& ptr, const char* end, G4long& value)
+  {
+    const char* p = ptr;
+    while (p < end && IsBlank(*p)) ++p;
 
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_x_smear, '\n');
+    G4bool negative = ParseSign(p, end);
+    if (p == end || !IsDigit(*p)) return false;
+
+    G4long result = 0;
+    while (p < end && IsDigit(*p)) {
+      result = 10 * result + (*p - '0');
+      ++p;
+    }
 
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        x_smear.push_back(stod(s_x_smear));
+    value = negative ? -result : result;
+    ptr = p;
+    return true;
+  }
+
+
+  G4bool ParseReal(const char*& ptr, const char* end, G4double& value)
+  {
+    // Powers of ten exactly representable as doubles: scaling an integer
+    // mantissa of up to 2^53 by one of them is a single correctly rounded
+    // operation. Any other number is handed over to std::from_chars.
+    static const G4double pow10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    static const std::uint64_t max_exact = 1ULL << 53;
+
+    const char* p = ptr;
+    while (p < end && IsBlank(*p)) ++p;
+
+    G4bool negative = ParseSign(p, end);
+    const char* number = p;
+
+    std::uint64_t mantissa = 0;
+    G4int ndigits  = 0;
+    G4int exponent = 0;
+    G4bool any_digit = false;
+    G4bool truncated = false;
+
+    for (; p < end && IsDigit(*p); ++p) {
+      any_digit = true;
+      if (ndigits < 19) {
+        mantissa = 10 * mantissa + (*p - '0');
+        if (mantissa > 0) ++ndigits;
       }
+      else {
+        ++exponent;
+        truncated = truncated || *p != '0';
+      }
+    }
 
-    } // END While
+    if (p < end && *p == '.') {
+      for (++p; p < end && IsDigit(*p); ++p) {
+        any_digit = true;
+        if (ndigits < 19) {
+          mantissa = 10 * mantissa + (*p - '0');
+          if (mantissa > 0) ++ndigits;
+          --exponent;
+        }
+        else truncated = truncated || *p != '0';
+      }
+    }
 
-    FileIn_.close();
-  
-  } // END LoadHistData1D
+    if (!any_digit) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+      const char* q = p + 1;
+      G4bool negative_exp = ParseSign(q, end);
+      if (q < end && IsDigit(*q)) {
+        G4int exp_value = 0;
+        for (; q < end && IsDigit(*q); ++q)
+          if (exp_value < 10000) exp_value = 10 * exp_value + (*q - '0');
+        exponent += negative_exp ? -exp_value : exp_value;
+        p = q;
+      }
+    }
+
+    G4double result = static_cast<G4double>(mantissa);
+    if (mantissa == 0) {
+      result = 0.;
+    }
+    else if (!truncated && mantissa <= max_exact &&
+             exponent >= -22 && exponent <= 22) {
+      if (exponent >= 0) result *= pow10[exponent];
+      else               result /= pow10[-exponent];
+    }
+    else {
+      // Fortran exponent marks are not understood by from_chars
+      std::string text(number, p);
+      std::replace(text.begin(), text.end(), 'd', 'e');
+      std::replace(text.begin(), text.end(), 'D', 'e');
+      auto res = std::from_chars(text.data(), text.data() + text.size(), result);
+      if (res.ec == std::errc::result_out_of_range)
+        result = (exponent > 0) ? HUGE_VAL : 0.;
+    }
+
+    value = negative ? -result : result;
+    ptr = p;
+    return true;
+  }
 
   // --------
 
-  // Input file format:
-  // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram x bin i width>,<histogram y bin j width>
-  void LoadHistData2D(std::string filename, std::vector<G4double> &value,
-                                     std::vector<G4double> &x, std::vector<G4double> &y,
-                                     std::vector<G4double> &x_smear,
-                                     std::vector<G4double> &y_smear){
-    
-    // Open the file
-    std::ifstream FileIn_(filename);
-    
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData2D()",
-                FatalException, " could not read in the CSV file ");
+  namespace {
+
+    // Layout of the binary sidecar of a histogram csv file:
+    // header, nlabels label records, then ncols*nrows doubles
+    // stored column after column.
+    const char     kHistCacheMagic[8] = {'N','X','H','I','S','T','\0','\0'};
+    const uint32_t kHistCacheVersion  = 1;
+
+    struct HistCacheHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t ncols;
+      uint64_t hash;
+      uint64_t nrows;
+      uint32_t nlabels;
+      uint32_t padding;
+    };
+
+    struct HistCacheLabel {
+      char   name[48];
+      double min;
+      double max;
+    };
+
+
+    G4bool ReadHistCache(const std::string& cachename, std::uint64_t hash,
+                         HistFileData& hist)
+    {
+      MappedFile cache(cachename);
+      if (!cache.IsOpen() || cache.Size() < sizeof(HistCacheHeader))
+        return false;
+
+      HistCacheHeader header;
+      std::memcpy(&header, cache.Data(), sizeof(header));
+
+      if (std::memcmp(header.magic, kHistCacheMagic, sizeof(kHistCacheMagic)) != 0 ||
+          header.version != kHistCacheVersion || header.hash != hash)
+        return false;
+
+      std::size_t expected = sizeof(HistCacheHeader)
+        + header.nlabels * sizeof(HistCacheLabel)
+        + header.ncols * header.nrows * sizeof(double);
+      if (cache.Size() != expected) return false;
+
+      const char* ptr = cache.Data() + sizeof(HistCacheHeader);
+
+      for (uint32_t i=0; i<header.nlabels; ++i) {
+        HistCacheLabel label;
+        std::memcpy(&label, ptr, sizeof(label));
+        label.name[sizeof(label.name)-1] = '\0';
+        hist.bounds[label.name] = std::make_pair(label.min, label.max);
+        ptr += sizeof(HistCacheLabel);
+      }
+
+      hist.columns.resize(header.ncols);
+      for (auto& column: hist.columns) {
+        column.resize(header.nrows);
+        std::memcpy(column.data(), ptr, header.nrows * sizeof(double));
+        ptr += header.nrows * sizeof(double);
+      }
+
+      return true;
     }
 
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x, s_y;
-    std::string s_x_smear, s_y_smear;
 
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
+    void WriteHistCache(const std::string& cachename, std::uint64_t hash,
+                        const HistFileData& hist)
+    {
+      HistCacheHeader header = {};
+      std::memcpy(header.magic, kHistCacheMagic, sizeof(kHistCacheMagic));
+      header.version = kHistCacheVersion;
+      header.ncols   = hist.columns.size();
+      header.hash    = hash;
+      header.nrows   = hist.columns.empty() ? 0 : hist.columns[0].size();
+      header.nlabels = hist.bounds.size();
+
+      // Write to a temporary file and rename it, so that concurrent
+      // jobs never map a partially written sidecar
+      std::string tmpname = cachename + ".tmp" + std::to_string(getpid());
+      std::ofstream out(tmpname, std::ios::binary);
+      if (!out) return; // read-only data directory: keep going without cache
+
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      for (const auto& bound: hist.bounds) {
+        HistCacheLabel label = {};
+        bound.first.copy(label.name, sizeof(label.name)-1);
+        label.min = bound.second.first;
+        label.max = bound.second.second;
+        out.write(reinterpret_cast<const char*>(&label), sizeof(label));
+      }
+
+      for (const auto& column: hist.columns)
+        out.write(reinterpret_cast<const char*>(column.data()),
+                  column.size() * sizeof(double));
 
-      std::getline(FileIn_, s_header, ',');
-      
-      if (s_header == "value"){
+      out.close();
 
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_y, ',');
-        std::getline(FileIn_, s_x_smear, ',');
-        std::getline(FileIn_, s_y_smear, '\n');
+      if (!out || std::rename(tmpname.c_str(), cachename.c_str()) != 0)
+        std::remove(tmpname.c_str());
+    }
 
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        y.push_back(stod(s_y));
-        x_smear.push_back(stod(s_x_smear));
-        y_smear.push_back(stod(s_y_smear));
 
+    // Parse the csv text in one pass. Rows labelled "value" fill the
+    // columns; the first number of any other row updates the bounds
+    // of its label.
+    void ParseHistCsv(const std::string& filename, const char* begin,
+                      const char* end, HistFileData& hist)
+    {
+      // Copy into a null-terminated buffer so that strtod cannot run past it
+      std::string text(begin, end);
+      const char* ptr = text.c_str();
+      const char* stop = ptr + text.size();
+
+      while (ptr < stop) {
+        const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', stop - ptr));
+        if (!eol) eol = stop;
+
+        const char* comma = static_cast<const char*>(std::memchr(ptr, ',', eol - ptr));
+        if (!comma) {
+          ptr = eol + 1;
+          continue;
+        }
+
+        std::string label(ptr, comma);
+
+        std::vector<G4double> fields;
+        const char* field = comma + 1;
+        while (field < eol) {
+          char* next;
+          G4double val = std::strtod(field, &next);
+          if (next == field) break;
+          fields.push_back(val);
+          field = next;
+          if (field < eol && *field == ',') ++field;
+        }
+
+        if (label == "value") {
+          if (hist.columns.empty())
+            hist.columns.resize(fields.size());
+
+          if (fields.size() != hist.columns.size())
+            G4Exception("[IOUtils]", "LoadHistFile()", FatalException,
+                        ("inconsistent number of columns in " + filename).c_str());
+
+          for (size_t i=0; i<fields.size(); ++i)
+            hist.columns[i].push_back(fields[i]);
+        }
+        else if (!fields.empty()) {
+          auto it = hist.bounds.find(label);
+          if (it == hist.bounds.end())
+            it = hist.bounds.emplace(label, std::make_pair(1.0e20, 0.)).first;
+          it->second.first  = std::min(it->second.first,  fields[0]);
+          it->second.second = std::max(it->second.second, fields[0]);
+        }
+
+        ptr = eol + 1;
       }
-    
-    } // END While
+    }
 
-    FileIn_.close();
-  
-  } // END LoadHistData2D
-  
+  } // end anonymous namespace
 
-  // --------
 
-  // Input file format:
-  // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram z bin k centre>,<histogram x bin i width>,<histogram y bin j width>,<histogram z bin k width>
-  void LoadHistData3D(std::string filename, std::vector<G4double> &value,
-                        std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
-                        std::vector<G4double> &x_smear, std::vector<G4double> &y_smear, std::vector<G4double> &z_smear){
-    
-    std::ifstream FileIn_(filename);
+  const HistFileData& LoadHistFile(const std::string& filename)
+  {
+    // Files already loaded in this process
+    static std::map<std::string, HistFileData> loaded;
+
+    auto it = loaded.find(filename);
+    if (it != loaded.end()) return it->second;
+
+    MappedFile csv(filename);
 
     // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData3D()",
+    if (!csv.IsOpen()){
+      G4Exception("[IOUtils]", "LoadHistFile()",
                 FatalException, " could not read in the CSV file ");
     }
 
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x, s_y, s_z;
-    std::string s_x_smear, s_y_smear, s_z_smear;
-
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
-
-      std::getline(FileIn_, s_header, ',');
-
-      if (s_header == "value"){
-      
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_y, ',');
-        std::getline(FileIn_, s_z, ',');
-        std::getline(FileIn_, s_x_smear, ',');
-        std::getline(FileIn_, s_y_smear, ',');
-        std::getline(FileIn_, s_z_smear, '\n');
-
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        y.push_back(stod(s_y));
-        z.push_back(stod(s_z));
-        x_smear.push_back(stod(s_x_smear));
-        y_smear.push_back(stod(s_y_smear));
-        z_smear.push_back(stod(s_z_smear));
-      }
+    std::uint64_t hash = HashBytes(csv.Data(), csv.Size());
+    std::string cachename = filename + ".bin";
 
-    } // END While
+    HistFileData& hist = loaded[filename];
 
-    FileIn_.close();
-  
-  }  // END LoadHistData3D
+    if (!ReadHistCache(cachename, hash, hist)) {
+      hist = HistFileData();
+      ParseHistCsv(filename, csv.Data(), csv.Data() + csv.Size(), hist);
+      WriteHistCache(cachename, hash, hist);
+    }
+
+    return hist;
+  }
+
+  G4bool ReadHistSidecar(const std::string& filename, HistFileData& hist)
+  {
+    MappedFile csv(filename);
+    if (!csv.IsOpen()) return false;
+
+    std::uint64_t hash = HashBytes(csv.Data(), csv.Size());
+    return ReadHistCache(filename + ".bin", hash, hist);
+  }
 
   // --------
 
-  void CheckVarBounds(std::string filename, G4double var_min, G4double var_max, std::string HeaderName){
-    
-    std::ifstream FileIn_(filename);
+  namespace {
 
-    // Max and min energies in sampled file
-    G4double file_VarMin = 1.0e20;
-    G4double file_VarMax = 0.;
+    // Fetch the columns of a histogram file checking their number
+    const HistFileData& LoadHistColumns(const std::string& filename,
+                                        size_t ncols, const char* caller)
+    {
+      const HistFileData& hist = LoadHistFile(filename);
 
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "CheckVarBounds()",
-                FatalException, " could not read in the CSV file ");
+      if (hist.columns.size() != ncols)
+        G4Exception("[IOUtils]", caller, FatalException,
+                    (filename + " does not have the expected number of columns").c_str());
+
+      return hist;
     }
 
-    // Read the Data from the file as strings
-    std::string s_line, s_var;
+  } // end anonymous namespace
 
-    // Loop over the lines in the file
-    while (std::getline(FileIn_, s_line)) {
 
-      std::stringstream s(s_line);
+  // Input file format:
+  // value,<intensity in bin>,<histogram x bin i centre>,<histogram x bin i width>
+  void LoadHistData1D(std::string filename, std::vector<G4double> &value,
+                                    std::vector<G4double> &x, std::vector<G4double> &x_smear){
 
-      G4bool match = false; 
+    const HistFileData& hist = LoadHistColumns(filename, 3, "LoadHistData1D()");
 
-      // Loop over the columns in the file
-      while (std::getline(s, s_var, ',' )) {
+    value.insert  (value.end(),   hist.columns[0].begin(), hist.columns[0].end());
+    x.insert      (x.end(),       hist.columns[1].begin(), hist.columns[1].end());
+    x_smear.insert(x_smear.end(), hist.columns[2].begin(), hist.columns[2].end());
 
-          // Check if the column matches the header
-          if (s_var == HeaderName){
-            match = true;
-            continue;
-          }
+  } // END LoadHistData1D
 
-          // Read the value
-          if (match){
+  // --------
 
-            G4double var = stod(s_var);
-        
-            // Get the max and min values from the file
-            if (var < file_VarMin) file_VarMin = var;
-            if (var > file_VarMax) file_VarMax = var;
+  // Input file format:
+  // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram x bin i width>,<histogram y bin j width>
+  void LoadHistData2D(std::string filename, std::vector<G4double> &value,
+                                     std::vector<G4double> &x, std::vector<G4double> &y,
+                                     std::vector<G4double> &x_smear,
+                                     std::vector<G4double> &y_smear){
 
-            match = false;
+    const HistFileData& hist = LoadHistColumns(filename, 5, "LoadHistData2D()");
 
-          }
+    value.insert  (value.end(),   hist.columns[0].begin(), hist.columns[0].end());
+    x.insert      (x.end(),       hist.columns[1].begin(), hist.columns[1].end());
+    y.insert      (y.end(),       hist.columns[2].begin(), hist.columns[2].end());
+    x_smear.insert(x_smear.end(), hist.columns[3].begin(), hist.columns[3].end());
+    y_smear.insert(y_smear.end(), hist.columns[4].begin(), hist.columns[4].end());
+
+  } // END LoadHistData2D
 
-      }
 
-    } // END While
+  // --------
+
+  // Input file format:
+  // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram z bin k centre>,<histogram x bin i width>,<histogram y bin j width>,<histogram z bin k width>
+  void LoadHistData3D(std::string filename, std::vector<G4double> &value,
+                        std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
+                        std::vector<G4double> &x_smear, std::vector<G4double> &y_smear, std::vector<G4double> &z_smear){
+
+    const HistFileData& hist = LoadHistColumns(filename, 7, "LoadHistData3D()");
+
+    value.insert  (value.end(),   hist.columns[0].begin(), hist.columns[0].end());
+    x.insert      (x.end(),       hist.columns[1].begin(), hist.columns[1].end());
+    y.insert      (y.end(),       hist.columns[2].begin(), hist.columns[2].end());
+    z.insert      (z.end(),       hist.columns[3].begin(), hist.columns[3].end());
+    x_smear.insert(x_smear.end(), hist.columns[4].begin(), hist.columns[4].end());
+    y_smear.insert(y_smear.end(), hist.columns[5].begin(), hist.columns[5].end());
+    z_smear.insert(z_smear.end(), hist.columns[6].begin(), hist.columns[6].end());
+
+  }  // END LoadHistData3D
+
+  // --------
+
+  void CheckVarBounds(std::string filename, G4double var_min, G4double var_max, std::string HeaderName){
+
+    // Max and min values in sampled file, computed when the file was parsed
+    G4double file_VarMin = 1.0e20;
+    G4double file_VarMax = 0.;
+
+    const HistFileData& hist = LoadHistFile(filename);
+    auto bound = hist.bounds.find(HeaderName);
+    if (bound != hist.bounds.end()) {
+      file_VarMin = bound->second.first;
+      file_VarMax = bound->second.second;
+    }
 
      // Check if the specified variable range has been set to a suitable value
     if ((var_min < file_VarMin || var_max > file_VarMax )){
@@ -211,8 +498,6 @@ namespace nexus {
                 FatalException, " Specified range for sampling is outside permitted range or the min/max of the variable has not been set");
     }
 
-    FileIn_.close();
-  
   }  // END CheckVarBounds
 
 
@@ -10,23 +10,78 @@
 
 #include <Randomize.hh>
 
+#include <cstdint>
+#include <map>
+
 
 #ifndef IOUTILS_H
 #define IOUTILS_H
 
 namespace nexus {
 
+    /// Read-only memory mapping of a whole file. The mapping is shared
+    /// with any other process that maps the same file.
+    class MappedFile
+    {
+    public:
+      MappedFile(const std::string& filename);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      G4bool IsOpen() const { return open_; }
+      const char* Data() const { return data_; }
+      std::size_t Size() const { return size_; }
+
+    private:
+      G4bool open_;
+      const char* data_;
+      std::size_t size_;
+    };
+
+    /// 64-bit FNV-1a hash of a block of memory
+    std::uint64_t HashBytes(const char* data, std::size_t size,
+                            std::uint64_t seed=14695981039346656037ULL);
+
+    /// Locale-independent parsing of a number from a character buffer.
+    /// Leading blanks and line breaks are skipped; on success ptr is left
+    /// just past the number. Reals may use e, E, d or D as exponent mark,
+    /// and are correctly rounded.
+    G4bool ParseInteger(const char*& ptr, const char* end, G4long& value);
+    G4bool ParseReal(const char*& ptr, const char* end, G4double& value);
+
+    /// Contents of a histogram csv file, parsed in a single pass.
+    /// Columns hold the numeric fields of the "value" rows in file order,
+    /// whereas bounds hold the minimum and maximum of the first numeric
+    /// field of every other labelled row (e.g. the energy bin edges).
+    struct HistFileData {
+      std::vector<std::vector<G4double>> columns;
+      std::map<std::string, std::pair<G4double, G4double>> bounds;
+    };
+
+    /// Return the parsed contents of a histogram csv file. The text is
+    /// parsed only once: the result is stored in a binary sidecar
+    /// (<filename>.bin) keyed by a hash of the csv contents, which
+    /// later runs memory-map instead of parsing the file again.
+    const HistFileData& LoadHistFile(const std::string& filename);
+
+    /// Read the binary sidecar of a histogram csv file, bypassing the
+    /// files already loaded in this process. Returns false if there is
+    /// no sidecar or it does not match the current contents of the file.
+    G4bool ReadHistSidecar(const std::string& filename, HistFileData& hist);
+
     /// Read in the 1d histogram stored in a csv file
     void LoadHistData1D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x,
                         std::vector<G4double> &x_smear);
-    
+
     /// Read in the 2d histogram stored in a csv file
     void LoadHistData2D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x, std::vector<G4double> &y,
                         std::vector<G4double> &x_smear,
                         std::vector<G4double> &y_smear);
-    
+
     /// Read in the 3d histogram stored in a csv file
     void LoadHistData3D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
@@ -1,7 +1,8 @@
 // -----------------------------------------------------------------------------
 //  nexus | Interpolation.h
 //
-//  Functions for linear and bilinear interpolation.
+//  Functions for linear and bilinear interpolation, and batched
+//  interpolation of tables given on 1D, 2D and 3D grids.
 //
 //  The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -11,6 +12,10 @@
 
 #include <G4ThreeVector.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace nexus {
 
   inline G4double LinearInterpolation(G4double x, G4double xmin, G4double xmax,
@@ -57,6 +62,255 @@ namespace nexus {
     return result;
   }
 
+
+  // BATCHED INTERPOLATION /////////////////////////////////////////////////////
+
+  /// Treatment of query points outside an interpolation grid: take the
+  /// value at the closest boundary, extend the edge cell linearly, or
+  /// return NaN. The batched functions below return in all cases the
+  /// number of points found outside the grid.
+  enum class OutOfRange { Clamp, Extrapolate, Flag };
+
+  /// Nodes of a grid along one axis, either regular (first node and
+  /// spacing) or irregular (array of increasing positions, not owned)
+  struct GridAxis
+  {
+    G4int n;
+    G4double min, step;
+    const G4double* nodes;
+
+    static GridAxis Regular(G4double min, G4double step, G4int n);
+    static GridAxis Irregular(const G4double* nodes, G4int n);
+
+    /// Position of a node
+    G4double Node(G4int i) const;
+
+    /// Index i of the cell (between nodes i and i+1) containing u and
+    /// position of u inside it, in units of the cell width. Outside the
+    /// grid, i is the edge cell and the position is below 0 or above 1.
+    /// For a NaN u, i is a valid cell and the position is NaN.
+    G4double Locate(G4double u, G4int& i) const;
+  };
+
+  inline GridAxis GridAxis::Regular(G4double min, G4double step, G4int n)
+  { return GridAxis{n, min, step, nullptr}; }
+
+  inline GridAxis GridAxis::Irregular(const G4double* nodes, G4int n)
+  { return GridAxis{n, nodes[0], 0., nodes}; }
+
+  inline G4double GridAxis::Node(G4int i) const
+  { return nodes ? nodes[i] : min + i * step; }
+
+  inline G4double GridAxis::Locate(G4double u, G4int& i) const
+  {
+    if (!nodes) {
+      const G4double s = (u - min) / step;
+      // std::max(0., s) is 0 for a NaN s, so that the cast is defined
+      i = std::min(G4int(std::min(std::max(0., s), n - 1.)), n - 2);
+      return s - i;
+    }
+    i = std::upper_bound(nodes, nodes + n, u) - nodes - 1;
+    i = std::min(std::max(i, 0), n - 2);
+    return (u - nodes[i]) / (nodes[i+1] - nodes[i]);
+  }
+
+  namespace detail {
+
+    /// Query points are processed in chunks: first they are located
+    /// along each axis, then the table is interpolated into a local
+    /// buffer. These loops are free of branches (except for the binary
+    /// search on irregular axes) and of aliasing, so that the compiler
+    /// can vectorize them.
+    const std::size_t kChunkSize = 64;
+
+    /// Locates m points along an axis and applies the out-of-range
+    /// policy to their position inside the cell; flags the points
+    /// outside the grid in outside, and the NaN ones, whose result
+    /// is NaN whatever the policy
+    inline void LocateChunk(const GridAxis& axis, std::size_t m,
+                            const G4double* u, OutOfRange policy,
+                            G4int* idx, G4double* t, G4int* outside)
+    {
+      if (!axis.nodes) {
+        const G4double last = axis.n - 1.;
+        for (std::size_t q=0; q<m; ++q) {
+          const G4double s = (u[q] - axis.min) / axis.step;
+          idx[q] = std::min(G4int(std::min(std::max(0., s), last)), axis.n - 2);
+          t[q] = s - idx[q];
+        }
+      }
+      else {
+        for (std::size_t q=0; q<m; ++q)
+          t[q] = axis.Locate(u[q], idx[q]);
+      }
+
+      for (std::size_t q=0; q<m; ++q) {
+        outside[q] |= !((t[q] >= 0.) & (t[q] <= 1.));
+        if (policy == OutOfRange::Clamp) t[q] = std::min(std::max(t[q], 0.), 1.);
+      }
+    }
+
+    /// Copies m interpolated values to the result, replacing by NaN
+    /// those outside the grid if the policy asks for it, and returns
+    /// the number of the latter
+    inline std::size_t Store(std::size_t m, const G4double* value,
+                             const G4int* outside, OutOfRange policy,
+                             G4double* result)
+    {
+      const G4double nan = std::numeric_limits<G4double>::quiet_NaN();
+      const G4bool flag = (policy == OutOfRange::Flag);
+      std::size_t noutside = 0;
+      for (std::size_t q=0; q<m; ++q) {
+        noutside += outside[q];
+        result[q] = (flag && outside[q]) ? nan : value[q];
+      }
+      return noutside;
+    }
+
+  }
+
+  /// Linear interpolation of the values f[i] at the nodes of a grid
+  /// for n query points xq, stored in result
+  inline std::size_t Interpolate1D(const GridAxis& x, const G4double* f,
+                                   std::size_t n, const G4double* xq,
+                                   G4double* result,
+                                   OutOfRange policy=OutOfRange::Clamp)
+  {
+    G4int i[detail::kChunkSize];
+    G4double tx[detail::kChunkSize];
+    G4int outside[detail::kChunkSize];
+    G4double value[detail::kChunkSize];
+
+    std::size_t noutside = 0;
+    for (std::size_t first=0; first<n; first+=detail::kChunkSize) {
+      const std::size_t m = std::min(detail::kChunkSize, n - first);
+      std::fill(outside, outside + m, 0);
+      detail::LocateChunk(x, m, xq + first, policy, i, tx, outside);
+
+      for (std::size_t q=0; q<m; ++q)
+        value[q] = f[i[q]] + tx[q] * (f[i[q]+1] - f[i[q]]);
+
+      noutside += detail::Store(m, value, outside, policy, result + first);
+    }
+    return noutside;
+  }
+
+  /// Cubic Hermite interpolation of the values f[i] at the nodes of a
+  /// grid for n query points xq, with the slope at each node estimated
+  /// from its neighbours. Extrapolation continues the edge slope.
+  inline std::size_t InterpolateCubic1D(const GridAxis& x, const G4double* f,
+                                        std::size_t n, const G4double* xq,
+                                        G4double* result,
+                                        OutOfRange policy=OutOfRange::Clamp)
+  {
+    G4int i[detail::kChunkSize];
+    G4double tx[detail::kChunkSize];
+    G4int outside[detail::kChunkSize];
+    G4double value[detail::kChunkSize];
+
+    const G4int last = x.n - 1;
+    std::size_t noutside = 0;
+    for (std::size_t first=0; first<n; first+=detail::kChunkSize) {
+      const std::size_t m = std::min(detail::kChunkSize, n - first);
+      std::fill(outside, outside + m, 0);
+      detail::LocateChunk(x, m, xq + first, policy, i, tx, outside);
+
+      for (std::size_t q=0; q<m; ++q) {
+        // Slopes at both ends of the cell, in units of the cell width
+        const G4int k  = i[q];
+        const G4int k0 = std::max(k-1, 0);
+        const G4int k3 = std::min(k+2, last);
+        const G4double h  = x.Node(k+1) - x.Node(k);
+        const G4double m1 = h * (f[k+1] - f[k0]) / (x.Node(k+1) - x.Node(k0));
+        const G4double m2 = h * (f[k3] - f[k]) / (x.Node(k3) - x.Node(k));
+
+        const G4double t  = tx[q];
+        const G4double tc = std::min(std::max(t, 0.), 1.);
+        const G4double tc2 = tc * tc;
+        const G4double tc3 = tc2 * tc;
+        value[q] = (2.*tc3 - 3.*tc2 + 1.) * f[k] + (tc3 - 2.*tc2 + tc) * m1
+          + (-2.*tc3 + 3.*tc2) * f[k+1] + (tc3 - tc2) * m2
+          + (t - tc) * (t < 0. ? m1 : m2);
+      }
+
+      noutside += detail::Store(m, value, outside, policy, result + first);
+    }
+    return noutside;
+  }
+
+  /// Bilinear interpolation of the values f[i*ny + j] at the nodes of
+  /// a grid for n query points (xq, yq), stored in result
+  inline std::size_t Interpolate2D(const GridAxis& x, const GridAxis& y,
+                                   const G4double* f, std::size_t n,
+                                   const G4double* xq, const G4double* yq,
+                                   G4double* result,
+                                   OutOfRange policy=OutOfRange::Clamp)
+  {
+    G4int i[detail::kChunkSize], j[detail::kChunkSize];
+    G4double tx[detail::kChunkSize], ty[detail::kChunkSize];
+    G4int outside[detail::kChunkSize];
+    G4double value[detail::kChunkSize];
+
+    const G4int sx = y.n;
+    std::size_t noutside = 0;
+    for (std::size_t first=0; first<n; first+=detail::kChunkSize) {
+      const std::size_t m = std::min(detail::kChunkSize, n - first);
+      std::fill(outside, outside + m, 0);
+      detail::LocateChunk(x, m, xq + first, policy, i, tx, outside);
+      detail::LocateChunk(y, m, yq + first, policy, j, ty, outside);
+
+      for (std::size_t q=0; q<m; ++q) {
+        const G4int c = i[q] * sx + j[q];
+        const G4double f0 = f[c]    + ty[q] * (f[c+1]    - f[c]);
+        const G4double f1 = f[c+sx] + ty[q] * (f[c+sx+1] - f[c+sx]);
+        value[q] = f0 + tx[q] * (f1 - f0);
+      }
+
+      noutside += detail::Store(m, value, outside, policy, result + first);
+    }
+    return noutside;
+  }
+
+  /// Trilinear interpolation of the values f[(i*ny + j)*nz + k] at the
+  /// nodes of a grid for n query points (xq, yq, zq), stored in result
+  inline std::size_t Interpolate3D(const GridAxis& x, const GridAxis& y,
+                                   const GridAxis& z, const G4double* f,
+                                   std::size_t n, const G4double* xq,
+                                   const G4double* yq, const G4double* zq,
+                                   G4double* result,
+                                   OutOfRange policy=OutOfRange::Clamp)
+  {
+    G4int i[detail::kChunkSize], j[detail::kChunkSize], k[detail::kChunkSize];
+    G4double tx[detail::kChunkSize], ty[detail::kChunkSize], tz[detail::kChunkSize];
+    G4int outside[detail::kChunkSize];
+    G4double value[detail::kChunkSize];
+
+    const G4int sy = z.n;
+    const G4int sx = y.n * z.n;
+    std::size_t noutside = 0;
+    for (std::size_t first=0; first<n; first+=detail::kChunkSize) {
+      const std::size_t m = std::min(detail::kChunkSize, n - first);
+      std::fill(outside, outside + m, 0);
+      detail::LocateChunk(x, m, xq + first, policy, i, tx, outside);
+      detail::LocateChunk(y, m, yq + first, policy, j, ty, outside);
+      detail::LocateChunk(z, m, zq + first, policy, k, tz, outside);
+
+      for (std::size_t q=0; q<m; ++q) {
+        const G4int c = i[q] * sx + j[q] * sy + k[q];
+        const G4double f00 = f[c]       + tz[q] * (f[c+1]       - f[c]);
+        const G4double f01 = f[c+sy]    + tz[q] * (f[c+sy+1]    - f[c+sy]);
+        const G4double f10 = f[c+sx]    + tz[q] * (f[c+sx+1]    - f[c+sx]);
+        const G4double f11 = f[c+sx+sy] + tz[q] * (f[c+sx+sy+1] - f[c+sx+sy]);
+        const G4double f0 = f00 + ty[q] * (f01 - f00);
+        const G4double f1 = f10 + ty[q] * (f11 - f10);
+        value[q] = f0 + tx[q] * (f1 - f0);
+      }
+
+      noutside += detail::Store(m, value, outside, policy, result + first);
+    }
+    return noutside;
+  }
+
 }  // end namespace nexus
 
 #endif
@@ -85,4 +85,32 @@ namespace nexus {
 
   }
 
+  namespace {
+    // Finalizer of the splitmix64 generator, which
+    // spreads any change of the input over all the bits
+    uint64_t Mix(uint64_t x)
+    {
+      x += 0x9E3779B97F4A7C15ULL;
+      x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+      return x ^ (x >> 31);
+    }
+  }
+
+  uint64_t EventSeed(G4long run_seed, int64_t event_id, int64_t start_id){
+
+    return Mix(Mix((uint64_t)run_seed) ^ (uint64_t)(start_id + event_id));
+
+  }
+
+  void SetEventSeed(uint64_t seed){
+
+    // The engines take an array of positive, non-zero seeds ended
+    // by a zero. Two 31-bit seeds hold the 62 lower bits of the seed.
+    long seeds[3] = {(long)((seed >> 31) & 0x7FFFFFFF) + 1,
+                     (long)(seed & 0x7FFFFFFF) + 1, 0};
+    CLHEP::HepRandom::setTheSeeds(seeds);
+
+  }
+
 }
@@ -36,6 +36,15 @@ namespace nexus {
     /// Check if the sampled value is out of bounds, max check only
     G4bool CheckOutOfBoundMax(G4double max, G4double val);
 
+    /// Seed of an event, hashed from the seed of the run and the event
+    /// ID in the job plus the first ID of the job. It only depends on
+    /// their sum, so an event is the same however the production is
+    /// split in jobs, and it can be generated again in isolation.
+    uint64_t EventSeed(G4long run_seed, int64_t event_id, int64_t start_id);
+
+    /// Seed the random engine with the seed of an event
+    void SetEventSeed(uint64_t seed);
+
   enum vtx_region {VOLUME, INSIDE, INNER_SURF, OUTER_SURF, CENTER};
 
 
@@ -0,0 +1,141 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.cc
+//
+// Sampler of photon energies following an emission spectrum, given as
+// intensities at a set of energies (e.g., a material property vector).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SpectrumSampler.h"
+
+#include <G4PhysicsVector.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+
+
+namespace nexus {
+
+  namespace {
+    // Minimum number of cells of the probability grid
+    const std::size_t kMinCells = 1024;
+  }
+
+
+  SpectrumSampler::SpectrumSampler()
+  {
+  }
+
+
+
+  SpectrumSampler::SpectrumSampler(const G4PhysicsVector& spectrum)
+  {
+    std::vector<G4double> intensities(spectrum.GetVectorLength());
+    energy_.resize(intensities.size());
+    for (std::size_t i=0; i<intensities.size(); ++i) {
+      energy_[i]      = spectrum.Energy(i);
+      intensities[i]  = spectrum[i];
+    }
+    Build(intensities);
+  }
+
+
+
+  SpectrumSampler::SpectrumSampler(const std::vector<G4double>& energies,
+                                   const std::vector<G4double>& intensities):
+    energy_(energies)
+  {
+    if (energies.size() != intensities.size()) {
+      G4Exception("[SpectrumSampler]", "SpectrumSampler()",
+                  FatalErrorInArgument,
+                  "Different number of energies and intensities.");
+    }
+    Build(intensities);
+  }
+
+
+
+  void SpectrumSampler::Build(const std::vector<G4double>& intensities)
+  {
+    const std::size_t n = energy_.size();
+    if (n < 2) return;
+
+    // Cumulative distribution by the trapezoidal rule
+    G4double sum = 0.;
+    cdf_.assign(1, sum);
+    for (std::size_t i=1; i<n; ++i) {
+      sum += 0.5 * (energy_[i] - energy_[i-1]) * (intensities[i] + intensities[i-1]);
+      cdf_.push_back(sum);
+    }
+
+    if (sum <= 0.) {
+      cdf_.clear();
+      return;
+    }
+
+    for (auto& c: cdf_) c /= sum;
+
+    // Inverse on the probability grid, recording for each cell
+    // the spectrum node below it and whether it contains other nodes
+    const std::size_t ncells = std::max(kMinCells, 16 * n);
+    inverse_   .resize(ncells + 1);
+    first_node_.resize(ncells);
+    linear_    .resize(ncells);
+
+    std::size_t node = 0;
+    for (std::size_t cell=0; cell<=ncells; ++cell) {
+      const G4double u = G4double(cell) / ncells;
+      const std::size_t first = node;
+      while (node + 2 < n && cdf_[node+1] < u) ++node;
+      inverse_[cell] = Invert(u, node);
+
+      if (cell < ncells) first_node_[cell] = node;
+      if (cell > 0)      linear_[cell-1] = (node == first);
+    }
+  }
+
+
+
+  G4double SpectrumSampler::Invert(G4double u, std::size_t node) const
+  {
+    const std::size_t n = cdf_.size();
+    while (node + 2 < n && cdf_[node+1] < u) ++node;
+
+    const G4double dc = cdf_[node+1] - cdf_[node];
+    if (dc <= 0.) return energy_[node];
+
+    return energy_[node] +
+      (energy_[node+1] - energy_[node]) * (u - cdf_[node]) / dc;
+  }
+
+
+
+  G4double SpectrumSampler::Cumulative(G4double energy) const
+  {
+    if (cdf_.empty() || energy <= energy_.front()) return 0.;
+    if (energy >= energy_.back()) return 1.;
+
+    const std::size_t node =
+      std::upper_bound(energy_.begin(), energy_.end(), energy) - energy_.begin() - 1;
+    return cdf_[node] + (cdf_[node+1] - cdf_[node]) *
+      (energy - energy_[node]) / (energy_[node+1] - energy_[node]);
+  }
+
+
+
+  G4double SpectrumSampler::Shoot() const
+  {
+    return Sample(G4UniformRand());
+  }
+
+
+
+  void SpectrumSampler::Shoot(std::size_t n, G4double* energies) const
+  {
+    G4Random::getTheEngine()->flatArray(n, energies);
+    for (std::size_t i=0; i<n; ++i)
+      energies[i] = Sample(energies[i]);
+  }
+
+} // end namespace nexus
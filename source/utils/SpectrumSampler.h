@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.h
+//
+// Sampler of photon energies following an emission spectrum, given as
+// intensities at a set of energies (e.g., a material property vector).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SPECTRUM_SAMPLER_H
+#define SPECTRUM_SAMPLER_H
+
+#include <globals.hh>
+
+#include <algorithm>
+#include <vector>
+
+class G4PhysicsVector;
+
+
+namespace nexus {
+
+  /// The spectrum is taken as linear between the given energies and
+  /// its cumulative distribution is inverted once on a uniform grid of
+  /// probabilities. Sampling takes then a constant time: the grid cell
+  /// of the random number gives the energy by linear interpolation if
+  /// the inverse is linear over the cell (no spectrum node inside it),
+  /// and otherwise a short search from the first node of the cell.
+
+  class SpectrumSampler
+  {
+  public:
+    /// Default constructor (empty spectrum)
+    SpectrumSampler();
+
+    /// Constructor providing the spectrum as a property vector
+    SpectrumSampler(const G4PhysicsVector& spectrum);
+
+    /// Constructor providing the spectrum as intensities
+    /// at increasing energies
+    SpectrumSampler(const std::vector<G4double>& energies,
+                    const std::vector<G4double>& intensities);
+
+    /// Returns true if the spectrum has no intensity
+    G4bool IsEmpty() const;
+
+    /// Energy for which the cumulative distribution equals u
+    G4double Sample(G4double u) const;
+
+    /// Cumulative distribution at a given energy, that is, the
+    /// fraction of the spectrum below it
+    G4double Cumulative(G4double energy) const;
+
+    /// Energy sampled with the random engine
+    G4double Shoot() const;
+
+    /// Fills energies with n values sampled with the random engine
+    void Shoot(std::size_t n, G4double* energies) const;
+
+  private:
+    void Build(const std::vector<G4double>& intensities);
+
+    /// Energy for which the cumulative distribution equals u,
+    /// searching the spectrum upwards from a given node
+    G4double Invert(G4double u, std::size_t node) const;
+
+  private:
+    std::vector<G4double> energy_; ///< Energies of the spectrum nodes
+    std::vector<G4double> cdf_;    ///< Cumulative distribution at the nodes
+
+    std::vector<G4double> inverse_; ///< Energy at each probability of the grid
+    std::vector<unsigned int> first_node_; ///< Spectrum node below each grid cell
+    std::vector<char> linear_;     ///< Cells with no spectrum node inside
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline G4bool SpectrumSampler::IsEmpty() const
+  { return inverse_.empty(); }
+
+  inline G4double SpectrumSampler::Sample(G4double u) const
+  {
+    const std::size_t ncells = linear_.size();
+    G4double s = u * ncells;
+    std::size_t cell = std::min(std::size_t(s), ncells - 1);
+
+    if (linear_[cell]) {
+      s -= cell;
+      return inverse_[cell] + s * (inverse_[cell+1] - inverse_[cell]);
+    }
+    return Invert(u, first_node_[cell]);
+  }
+
+} // end namespace nexus
+
+#endif
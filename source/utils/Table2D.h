@@ -0,0 +1,97 @@
+// -----------------------------------------------------------------------------
+//  nexus | Table2D.h
+//
+//  Table of values of a function of two variables on a regular grid,
+//  with constant-time lookup and bilinear interpolation.
+//
+//  The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef TABLE_2D_H
+#define TABLE_2D_H
+
+#include "Interpolation.h"
+
+#include <vector>
+
+namespace nexus {
+
+  class Table2D
+  {
+  public:
+    /// Constructor providing the first and last node and the number of
+    /// nodes of each axis, and the values at the nodes, with y running
+    /// fastest: values[i*ny + j] = f(xmin + i*xstep, ymin + j*ystep),
+    /// where xstep = (xmax - xmin)/(nx - 1) and likewise for y
+    Table2D(G4double xmin, G4double xmax, G4int nx,
+            G4double ymin, G4double ymax, G4int ny,
+            const std::vector<G4double>& values);
+
+    // The last nodes are kept as given, rather than recomputed from
+    // the spacing, so that the range includes them exactly
+    G4double GetXMin() const { return x_.min; }
+    G4double GetXMax() const { return xmax_; }
+    G4double GetYMin() const { return y_.min; }
+    G4double GetYMax() const { return ymax_; }
+
+    G4bool InRangeX(G4double x) const { return x >= GetXMin() && x <= GetXMax(); }
+    G4bool InRangeY(G4double y) const { return y >= GetYMin() && y <= GetYMax(); }
+
+    /// Bilinear interpolation of the table. Points outside the
+    /// grid take the value at the closest point of its boundary,
+    /// and NaN coordinates give NaN.
+    G4double Interpolate(G4double x, G4double y) const;
+
+    /// Interpolation of the table at n points (x, y), stored in result
+    void Interpolate(std::size_t n, const G4double* x, const G4double* y,
+                     G4double* result) const;
+
+  private:
+    GridAxis x_, y_;
+    G4double xmax_, ymax_;
+    std::vector<G4double> values_;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline Table2D::Table2D(G4double xmin, G4double xmax, G4int nx,
+                          G4double ymin, G4double ymax, G4int ny,
+                          const std::vector<G4double>& values):
+    x_(GridAxis::Regular(xmin, (xmax - xmin) / (nx - 1), nx)),
+    y_(GridAxis::Regular(ymin, (ymax - ymin) / (ny - 1), ny)),
+    xmax_(xmax), ymax_(ymax), values_(values)
+  {
+    if (nx < 2 || ny < 2 || xmax <= xmin || ymax <= ymin ||
+        values_.size() != std::size_t(nx) * std::size_t(ny)) {
+      G4Exception("[Table2D]", "Table2D()", FatalErrorInArgument,
+                  "Invalid grid for a 2D table.");
+    }
+  }
+
+  inline G4double Table2D::Interpolate(G4double x, G4double y) const
+  {
+    // Single points skip the chunked loops of the batched version
+    G4int i, j;
+    G4double tx = x_.Locate(x, i);
+    G4double ty = y_.Locate(y, j);
+    if (std::isnan(tx) || std::isnan(ty))
+      return std::numeric_limits<G4double>::quiet_NaN();
+    tx = std::min(std::max(tx, 0.), 1.);
+    ty = std::min(std::max(ty, 0.), 1.);
+
+    const G4int c = i * y_.n + j;
+    const G4double* f = values_.data();
+    const G4double f0 = f[c]       + ty * (f[c+1]       - f[c]);
+    const G4double f1 = f[c+y_.n]  + ty * (f[c+y_.n+1]  - f[c+y_.n]);
+    return f0 + tx * (f1 - f0);
+  }
+
+  inline void Table2D::Interpolate(std::size_t n, const G4double* x,
+                                   const G4double* y, G4double* result) const
+  {
+    Interpolate2D(x_, y_, values_.data(), n, x, y, result);
+  }
+
+}  // end namespace nexus
+
+#endif